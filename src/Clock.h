@@ -31,10 +31,13 @@ protected:
 
 public:
     Clock(RTClock& rtcRef, LCDDisplay& lcdRef) : _rtc(rtcRef), _lcd(lcdRef) {}
+    virtual ~Clock() {}
 
     virtual void begin() = 0; // For any initial setup specific to the clock type
     virtual void updateCurrentTime() = 0; // Unified time update method (normal operation + sync events)
     virtual void handlePowerOff(); // Common power-off handling (ISR safe) - saves current time to EEPROM
+    virtual void setTimeZone(int timeZoneOffsetHours, bool useDST) { (void)timeZoneOffsetHours; (void)useDST; } // Local time for clock faces that show it
+    virtual bool isRtcTimeValid(); // RTC holds real time (kept running on its backup supply, or set by NTP)
     
     // Enhanced power recovery methods
     bool simulatePowerOff(uint8_t state = POWER_STATE_RUNNING); // Test method to simulate power-off
@@ -60,6 +63,14 @@ inline void Clock::handlePowerOff() {
     Serial.println("Power-off data saved to EEPROM");
 }
 
+// A reset RTC counts up from 2000 again; one that kept running reads a plausible time
+inline bool Clock::isRtcTimeValid() {
+    RTCTime currentRTCtime;
+    _rtc.getTime(currentRTCtime);
+    time_t now = currentRTCtime.getUnixTime();
+    return now >= (time_t)MIN_VALID_POWER_DOWN_TIME && now <= (time_t)MAX_VALID_POWER_DOWN_TIME;
+}
+
 // Test method to simulate power-off without actual power loss
 inline bool Clock::simulatePowerOff(uint8_t state) {
     Serial.println("=== SIMULATING POWER-OFF ===");
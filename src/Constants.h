@@ -14,6 +14,12 @@
 #define EEPROM_ADDRESS_RECOVERY_FLAG 16      // Recovery validation flag
 #define EEPROM_ADDRESS_TEST_MODE 24          // Test mode flag for simulation
 
+// Movement gear ratio (GearRatioRecord, 16 bytes at 240..255), read by MechanicalClock::begin()
+#define EEPROM_ADDRESS_GEAR_RATIO 240
+
+// Hand position journal ring (HAND_JOURNAL_SLOTS x 16 bytes, after the network settings at 100..204)
+#define EEPROM_ADDRESS_HAND_JOURNAL 256
+
 // ============================================================================
 // HARDWARE CONSTANTS
 // ============================================================================
@@ -29,6 +35,9 @@
 #define MS3_PIN 6
 #define LED_PIN 13
 
+// Optional homing sensor (hall or optical flag on the hour wheel, see HOME_SENSOR_FITTED)
+#define HOME_SENSOR_PIN 9
+
 // ============================================================================
 // TIMING CONSTANTS
 // ============================================================================
@@ -0,0 +1,78 @@
+#include "DriverPowerPolicy.h"
+#include <stdio.h>
+
+DriverPowerConfig DriverPowerPolicy::defaultConfig() {
+    DriverPowerConfig config;
+    config.preEnableMs = DRIVER_PRE_ENABLE_MS;
+    config.postDisableMs = DRIVER_POST_DISABLE_MS;
+    config.holdOffMs = DRIVER_HOLD_OFF_MS;
+    config.onPowerMw = STEPPER_DRIVE_POWER_MW;
+    config.offPowerMw = DRIVER_OFF_POWER_MW;
+    return config;
+}
+
+DriverPowerPolicy::DriverPowerPolicy(const DriverPowerConfig& config)
+    : _config(config), _lastActiveMs(0), _lastLookMs(0), _enabled(false), _sinceMs(0), _onMs(0), _totalMs(0), _enables(0) {
+}
+
+void DriverPowerPolicy::begin(unsigned long nowMs) {
+    _lastActiveMs = nowMs;
+    _lastLookMs = nowMs;
+    _enabled = false;
+    _sinceMs = nowMs;
+    _onMs = 0;
+    _totalMs = 0;
+    _enables = 0;
+}
+
+bool DriverPowerPolicy::wantEnabled(unsigned long nowMs, bool pulsing, long msToNextStep) {
+    unsigned long lookIntervalMs = nowMs - _lastLookMs;
+    _lastLookMs = nowMs;
+    if (pulsing) {
+        _lastActiveMs = nowMs;
+        return true;
+    }
+    unsigned long idleMs = nowMs - _lastActiveMs;
+    if (idleMs < _config.postDisableMs) return true; // Let the rotor settle
+    // Next step not known (no second reference yet, or a move just ended): it may well be a
+    // short gap away, so hold as long as for a known one
+    if (msToNextStep < 0) return idleMs < _config.holdOffMs;
+    // Wake up ahead of the next step (now, if the next look may come too late for that), or
+    // do not bother releasing for a short gap
+    if ((unsigned long)msToNextStep <= _config.preEnableMs + lookIntervalMs) return true;
+    return idleMs + (unsigned long)msToNextStep < _config.holdOffMs;
+}
+
+void DriverPowerPolicy::_account(unsigned long nowMs) {
+    unsigned long elapsed = nowMs - _sinceMs;
+    _totalMs += elapsed;
+    if (_enabled) _onMs += elapsed;
+    _sinceMs = nowMs;
+}
+
+void DriverPowerPolicy::noteEnabled(unsigned long nowMs, bool enabled) {
+    _account(nowMs);
+    if (enabled && !_enabled) _enables++;
+    _enabled = enabled;
+}
+
+DriverPowerStats DriverPowerPolicy::stats(unsigned long nowMs) const {
+    DriverPowerStats stats = {};
+    unsigned long elapsed = nowMs - _sinceMs;
+    stats.totalMs = _totalMs + elapsed;
+    stats.onMs = _onMs + (_enabled ? elapsed : 0);
+    stats.enables = _enables;
+    if (stats.totalMs == 0) return stats;
+
+    stats.dutyPermille = (uint16_t)(stats.onMs * 1000ULL / stats.totalMs);
+    // Average power (mW) x 24 h
+    uint64_t energyMwMs = stats.onMs * _config.onPowerMw + (stats.totalMs - stats.onMs) * _config.offPowerMw;
+    stats.energyMwhPerDay = (uint32_t)(energyMwMs * 24ULL / stats.totalMs);
+    return stats;
+}
+
+void DriverPowerPolicy::formatSummary(const DriverPowerStats& stats, char* buffer, size_t size) {
+    snprintf(buffer, size, "driver on %u.%u%% enables=%lu energy=%lu mWh/day",
+             (unsigned)(stats.dutyPermille / 10), (unsigned)(stats.dutyPermille % 10),
+             (unsigned long)stats.enables, (unsigned long)stats.energyMwhPerDay);
+}
@@ -0,0 +1,105 @@
+/*
+ * Mechanical Clock with Onboard RTC - Stepper Driver Power Policy
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DRIVER_POWER_POLICY_H
+#define DRIVER_POWER_POLICY_H
+
+#include <Arduino.h>
+
+// Default policy (see DriverPowerConfig). A released gap saves its length less the wake-up and
+// settling windows (130 ms), so gaps under the hold-off are not worth a release; time keeping
+// (a step every 1.125 s) releases between steps, while steps of a move or catch-up stay held.
+#define DRIVER_PRE_ENABLE_MS 30    // Coil current settles within a few ms; covers a late loop pass too
+#define DRIVER_POST_DISABLE_MS 100 // Rotor settles after the last pulse of a move
+#define DRIVER_HOLD_OFF_MS 250
+
+// Coil current rise after the driver is enabled: the first pulse of a move waits this long
+#define DRIVER_WAKE_US 2000
+
+// Electrical power drawn while the A4988 is enabled (12 V x 0.4 A phase current), for energy estimates
+#define STEPPER_DRIVE_POWER_MW 4800UL
+
+// Modeled supply power with the driver disabled (A4988 logic and regulator only)
+#define DRIVER_OFF_POWER_MW 40UL
+
+// When the A4988 is enabled. The clock asks wantEnabled() on every update; the driver is on
+// while pulses go out, from preEnableMs before a known next step, for postDisableMs after the
+// last pulse, and across a gap from the last pulse to the next step shorter than holdOffMs. With the next step
+// not known it stays on for holdOffMs after the last pulse.
+struct DriverPowerConfig {
+    uint32_t preEnableMs;
+    uint32_t postDisableMs;
+    uint32_t holdOffMs;
+    uint32_t onPowerMw;  // Modeled supply power while enabled
+    uint32_t offPowerMw; // ...and while disabled
+};
+
+// Driver-on accounting since begin()
+struct DriverPowerStats {
+    uint64_t onMs;
+    uint64_t totalMs;
+    uint32_t enables;          // Off-to-on transitions
+    uint16_t dutyPermille;     // onMs / totalMs
+    uint32_t energyMwhPerDay;  // Modeled supply energy, extrapolated from the duty cycle to 24 h
+};
+
+// Decides when the stepper driver needs its coils energised and keeps the books on how long
+// it was. Holds no pins itself: the clock drives the enable line and reports every change
+// through noteEnabled(), so the accounting is exact to the millisecond.
+class DriverPowerPolicy {
+private:
+    DriverPowerConfig _config;
+    unsigned long _lastActiveMs; // Last update that saw pulses going out
+    unsigned long _lastLookMs;   // Last wantEnabled() call
+    bool _enabled;
+    unsigned long _sinceMs;      // When _enabled last changed (or was last accounted)
+    uint64_t _onMs;
+    uint64_t _totalMs;
+    uint32_t _enables;
+
+    void _account(unsigned long nowMs);
+
+public:
+    static DriverPowerConfig defaultConfig();
+
+    explicit DriverPowerPolicy(const DriverPowerConfig& config = defaultConfig());
+
+    // Starts the books at `nowMs` with the driver disabled
+    void begin(unsigned long nowMs);
+
+    void setConfig(const DriverPowerConfig& config) { _config = config; }
+    const DriverPowerConfig& getConfig() const { return _config; }
+
+    // `pulsing`: the step engine is emitting a move now. `msToNextStep`: time until the next
+    // known step (one scheduled or due to be), or -1 if none is known. The wake-up allows for
+    // the next call coming as long after this one as this one came after the last.
+    bool wantEnabled(unsigned long nowMs, bool pulsing, long msToNextStep);
+
+    // The enable line changed (or was driven again) at `nowMs`
+    void noteEnabled(unsigned long nowMs, bool enabled);
+
+    bool isEnabled() const { return _enabled; }
+
+    // Books up to `nowMs`
+    DriverPowerStats stats(unsigned long nowMs) const;
+
+    // One-line summary of `stats` ("driver on ...") into `buffer`
+    static void formatSummary(const DriverPowerStats& stats, char* buffer, size_t size);
+};
+
+#endif // DRIVER_POWER_POLICY_H
@@ -0,0 +1,140 @@
+/*
+ * Mechanical Clock with Onboard RTC - Fast Output Pins
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+// Port and bit of UNO R4 WiFi digital pin `pin` (D0..D13), packed as port << 4 | bit.
+// 0xFF for pins not in the table: those fall back to digitalWrite().
+constexpr uint8_t fastPinPortBit(uint8_t pin) {
+    return (pin == 0)  ? 0x31 : (pin == 1)  ? 0x32 : (pin == 2)  ? 0x14 : (pin == 3)  ? 0x15 :
+           (pin == 4)  ? 0x16 : (pin == 5)  ? 0x17 : (pin == 6)  ? 0x1B : (pin == 7)  ? 0x1C :
+           (pin == 8)  ? 0x34 : (pin == 9)  ? 0x33 : (pin == 10) ? 0x13 : (pin == 11) ? 0x4B :
+           (pin == 12) ? 0x4A : (pin == 13) ? 0x12 : 0xFF;
+}
+
+// RA4M1 PCNTR3 of port n: writing a bit in the low half sets the output, in the high half
+// clears it. One store, no read-modify-write, so it is safe against the step timer ISR.
+#define FAST_PIN_PORT_BASE 0x40040000UL
+#define FAST_PIN_PORT_STRIDE 0x20UL
+#define FAST_PIN_PCNTR3_OFFSET 0x08UL
+
+// PCNTR3 of the port a fastPinPortBit() value is on, and the set mask of its bit
+inline volatile uint32_t* fastPinSetReset(uint8_t portBit) {
+    return (volatile uint32_t*)(FAST_PIN_PORT_BASE + (portBit >> 4) * FAST_PIN_PORT_STRIDE + FAST_PIN_PCNTR3_OFFSET);
+}
+inline uint32_t fastPinMask(uint8_t portBit) { return 1UL << (portBit & 0x0F); }
+
+// Output pin fixed at compile time. The level last written is cached, so writing the
+// level the pin already holds costs a compare and no GPIO access at all; on the UNO R4
+// WiFi a real change is a single store to the port's set/reset register instead of
+// digitalWrite()'s table lookup. The host build writes through digitalWrite(), where
+// hostPinWrites() counts every transaction that gets past the cache.
+template <uint8_t Pin>
+class FastPin {
+private:
+    static constexpr uint8_t PORT_BIT = fastPinPortBit(Pin);
+    static constexpr uint8_t UNKNOWN_LEVEL = 0xFF;
+
+    uint8_t _level; // Level last written, or UNKNOWN_LEVEL before begin()
+
+    static void _write(uint8_t level) {
+#if defined(ARDUINO_UNOR4_WIFI)
+        if (PORT_BIT != 0xFF) {
+            *fastPinSetReset(PORT_BIT) = level ? fastPinMask(PORT_BIT) : (fastPinMask(PORT_BIT) << 16);
+            return;
+        }
+#endif
+        digitalWrite(Pin, level);
+    }
+
+public:
+    static constexpr uint8_t PIN = Pin;
+
+    FastPin() : _level(UNKNOWN_LEVEL) {}
+
+    // Makes the pin an output and drives `level` unconditionally
+    void begin(uint8_t level) {
+        pinMode(Pin, OUTPUT);
+        _level = level ? HIGH : LOW;
+        _write(_level);
+    }
+
+    // Drives `level` unless the pin already holds it. Returns true if the pin was written.
+    bool write(uint8_t level) {
+        level = level ? HIGH : LOW;
+        if (level == _level) return false;
+        _level = level;
+        _write(level);
+        return true;
+    }
+
+    bool high() { return write(HIGH); }
+    bool low() { return write(LOW); }
+
+    uint8_t level() const { return _level; }
+};
+
+// Output pin chosen at run time (the STEP/DIR pins of a pulse engine), resolved to its port
+// register once in begin() so an ISR write is a single store. No level cache: the caller
+// only writes on a change. Host builds, and pins outside the table, use digitalWrite().
+class FastPinHandle {
+private:
+    uint8_t _pin;
+#if defined(ARDUINO_UNOR4_WIFI)
+    volatile uint32_t* _setReset; // nullptr: not a direct port pin
+    uint32_t _mask;
+#endif
+
+public:
+    explicit FastPinHandle(uint8_t pin) : _pin(pin) {
+#if defined(ARDUINO_UNOR4_WIFI)
+        _setReset = nullptr;
+        _mask = 0;
+#endif
+    }
+
+    // Makes the pin an output and drives `level`
+    void begin(uint8_t level) {
+        pinMode(_pin, OUTPUT);
+#if defined(ARDUINO_UNOR4_WIFI)
+        uint8_t portBit = fastPinPortBit(_pin);
+        if (portBit != 0xFF) {
+            _setReset = fastPinSetReset(portBit);
+            _mask = fastPinMask(portBit);
+        }
+#endif
+        write(level);
+    }
+
+    void write(uint8_t level) {
+#if defined(ARDUINO_UNOR4_WIFI)
+        if (_setReset) {
+            *_setReset = level ? _mask : (_mask << 16);
+            return;
+        }
+#endif
+        digitalWrite(_pin, level ? HIGH : LOW);
+    }
+
+    uint8_t pin() const { return _pin; }
+};
+
+#endif // FAST_PIN_H
@@ -0,0 +1,52 @@
+#include "GearRatio.h"
+#include <EEPROM.h> // Record storage
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+bool isValidGearRatio(const GearRatio& ratio) {
+    return ratio.motorRevs >= 1 && ratio.motorRevs <= GEAR_RATIO_MAX_TERM &&
+           ratio.dialRevs >= 1 && ratio.dialRevs <= GEAR_RATIO_MAX_TERM;
+}
+
+GearRatio reduceGearRatio(const GearRatio& ratio) {
+    GearRatio reduced = ratio;
+    uint32_t divisor = gcd(ratio.motorRevs, ratio.dialRevs);
+    if (divisor > 1) {
+        reduced.motorRevs /= divisor;
+        reduced.dialRevs /= divisor;
+    }
+    return reduced;
+}
+
+bool loadGearRatio(int address, GearRatio& ratio) {
+    GearRatioRecord record;
+    EEPROM.get(address, record);
+    if (record.magic != GEAR_RATIO_MAGIC || record.check != ~(record.magic ^ record.motorRevs ^ record.dialRevs)) {
+        return false;
+    }
+
+    GearRatio stored = {record.motorRevs, record.dialRevs};
+    if (!isValidGearRatio(stored)) return false;
+    ratio = reduceGearRatio(stored);
+    return true;
+}
+
+bool saveGearRatio(int address, const GearRatio& ratio) {
+    if (!isValidGearRatio(ratio)) return false;
+
+    GearRatio reduced = reduceGearRatio(ratio);
+    GearRatioRecord record;
+    record.magic = GEAR_RATIO_MAGIC;
+    record.motorRevs = reduced.motorRevs;
+    record.dialRevs = reduced.dialRevs;
+    record.check = ~(record.magic ^ record.motorRevs ^ record.dialRevs);
+    EEPROM.put(address, record);
+    return true;
+}
@@ -0,0 +1,59 @@
+/*
+ * Mechanical Clock with Onboard RTC - Movement Gear Ratio
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GEAR_RATIO_H
+#define GEAR_RATIO_H
+
+#include <Arduino.h>
+
+// Largest term of a gear ratio. Keeps steps per dial cycle x 1000 (ms conversions) in 32 bits
+// at 3200 microsteps per motor revolution.
+#define GEAR_RATIO_MAX_TERM 1000
+
+// Marks a gear ratio record in EEPROM ("GEAR")
+#define GEAR_RATIO_MAGIC 0x47454152UL
+
+// Gear train of the movement: motorRevs motor revolutions turn the 12-hour dial dialRevs times.
+// 12/1 is 18 s per full step at 200 steps per revolution; 7/3 makes 7 motor revolutions per
+// three dial revolutions, which no whole number of steps per 12 hours can express.
+struct GearRatio {
+    uint32_t motorRevs;
+    uint32_t dialRevs;
+};
+
+// EEPROM record (16 bytes)
+struct GearRatioRecord {
+    uint32_t magic;
+    uint32_t motorRevs;
+    uint32_t dialRevs;
+    uint32_t check; // ~(magic ^ motorRevs ^ dialRevs)
+};
+
+// Both terms in 1..GEAR_RATIO_MAX_TERM
+bool isValidGearRatio(const GearRatio& ratio);
+
+// The same ratio in lowest terms (24/2 becomes 12/1)
+GearRatio reduceGearRatio(const GearRatio& ratio);
+
+// Reads the ratio stored at `address`. Returns false if there is no valid record.
+bool loadGearRatio(int address, GearRatio& ratio);
+
+// Stores `ratio` (in lowest terms) at `address`. Returns false, writing nothing, if it is not valid.
+bool saveGearRatio(int address, const GearRatio& ratio);
+
+#endif // GEAR_RATIO_H
@@ -0,0 +1,78 @@
+#include "HandErrorMonitor.h"
+#include <stdio.h>
+
+const long HandErrorMonitor::_binEdgesMs[HAND_ERROR_BINS - 1] = {
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000
+};
+
+HandErrorMonitor::HandErrorMonitor(unsigned long windowMs)
+    : _windowMs(windowMs), _windowStartMs(0),
+      _samples(0), _minMs(0), _maxMs(0), _sumMs(0), _histogram(), _bursts(0), _reversals(0),
+      _lastDirection(0), _last() {
+}
+
+void HandErrorMonitor::begin(unsigned long nowMs) {
+    _windowStartMs = nowMs;
+    _samples = 0;
+    _sumMs = 0;
+    _bursts = 0;
+    _reversals = 0;
+    for (uint8_t bin = 0; bin < HAND_ERROR_BINS; bin++) _histogram[bin] = 0;
+}
+
+void HandErrorMonitor::addSample(long errorMs) {
+    if (_samples == 0 || errorMs < _minMs) _minMs = errorMs;
+    if (_samples == 0 || errorMs > _maxMs) _maxMs = errorMs;
+    _samples++;
+    _sumMs += errorMs;
+
+    long magnitude = (errorMs < 0) ? -errorMs : errorMs;
+    uint8_t bin = 0;
+    while (bin < HAND_ERROR_BINS - 1 && magnitude > _binEdgesMs[bin]) bin++;
+    _histogram[bin]++;
+}
+
+void HandErrorMonitor::noteMove(long steps) {
+    if (steps == 0) return;
+    int8_t direction = (steps > 0) ? 1 : -1;
+    if (steps > 1 || steps < -1) _bursts++;
+    if (_lastDirection != 0 && direction != _lastDirection) _reversals++;
+    _lastDirection = direction;
+}
+
+bool HandErrorMonitor::rotate(unsigned long nowMs) {
+    if (nowMs - _windowStartMs < _windowMs) return false;
+    _last = currentWindow();
+    begin(nowMs);
+    return true;
+}
+
+HandErrorStats HandErrorMonitor::currentWindow() const {
+    HandErrorStats stats = {};
+    stats.samples = _samples;
+    stats.bursts = _bursts;
+    stats.reversals = _reversals;
+    if (_samples == 0) return stats;
+
+    stats.minMs = _minMs;
+    stats.maxMs = _maxMs;
+    stats.meanMs = (long)(_sumMs / (int64_t)_samples);
+
+    // Smallest bin edge with at least 99% of the samples at or below it
+    uint32_t wanted = _samples - _samples / 100;
+    uint32_t seen = 0;
+    uint8_t bin = 0;
+    for (; bin < HAND_ERROR_BINS - 1; bin++) {
+        seen += _histogram[bin];
+        if (seen >= wanted) break;
+    }
+    long largest = (-_minMs > _maxMs) ? -_minMs : _maxMs;
+    stats.p99Ms = (bin < HAND_ERROR_BINS - 1 && _binEdgesMs[bin] < largest) ? _binEdgesMs[bin] : largest;
+    return stats;
+}
+
+void HandErrorMonitor::formatSummary(const HandErrorStats& stats, char* buffer, size_t size) {
+    snprintf(buffer, size, "hand error ms min/mean/max/p99 %ld/%ld/%ld/%ld n=%lu bursts=%u reversals=%u",
+             stats.minMs, stats.meanMs, stats.maxMs, stats.p99Ms, (unsigned long)stats.samples,
+             (unsigned)stats.bursts, (unsigned)stats.reversals);
+}
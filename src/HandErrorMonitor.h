@@ -0,0 +1,87 @@
+/*
+ * Mechanical Clock with Onboard RTC - Hand Error Monitor
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAND_ERROR_MONITOR_H
+#define HAND_ERROR_MONITOR_H
+
+#include <Arduino.h>
+
+// Length of one statistics window; a summary line is printed as each one closes
+#define HAND_ERROR_WINDOW_MS 3600000UL
+
+// |error| histogram for the p99: bin upper edges in ms on a 1-2-5 scale, plus one open-ended bin
+#define HAND_ERROR_BINS 16
+
+// Hand error over one window. Error = time the hands physically show minus RTC time
+// (positive = ahead). Between steps the hands stand still while time moves on, so a
+// healthy clock reads between minus one time-keeping step and zero.
+struct HandErrorStats {
+    uint32_t samples;
+    long minMs;
+    long maxMs;
+    long meanMs;
+    long p99Ms;         // 99% of samples had |error| at or below this (bin upper edge)
+    uint16_t bursts;    // Moves of more than one step at once (catch-ups, corrections)
+    uint16_t reversals; // Direction changes of the hands
+};
+
+// Continuous hand accuracy metric. The clock feeds it one error sample per update and
+// every step move it issues; it keeps running statistics for the current window and the
+// complete statistics of the previous one, in a few dozen bytes and without floats.
+class HandErrorMonitor {
+private:
+    const unsigned long _windowMs;
+    unsigned long _windowStartMs;
+
+    // Current window
+    uint32_t _samples;
+    long _minMs;
+    long _maxMs;
+    int64_t _sumMs;
+    uint32_t _histogram[HAND_ERROR_BINS];
+    uint16_t _bursts;
+    uint16_t _reversals;
+    int8_t _lastDirection; // Direction of the last move (0 = none yet), carried across windows
+
+    HandErrorStats _last; // Previous complete window
+
+    static const long _binEdgesMs[HAND_ERROR_BINS - 1];
+
+public:
+    explicit HandErrorMonitor(unsigned long windowMs = HAND_ERROR_WINDOW_MS);
+
+    // Starts the first window at `nowMs`
+    void begin(unsigned long nowMs);
+
+    void addSample(long errorMs);
+
+    // `steps` issued as one move (sign = direction)
+    void noteMove(long steps);
+
+    // Closes the current window once it has run its length. Returns true if it did;
+    // the closed window is then in lastWindow().
+    bool rotate(unsigned long nowMs);
+
+    HandErrorStats currentWindow() const;
+    const HandErrorStats& lastWindow() const { return _last; }
+
+    // One-line summary of `stats` ("hand error ms min/mean/max/p99 ...") into `buffer`
+    static void formatSummary(const HandErrorStats& stats, char* buffer, size_t size);
+};
+
+#endif // HAND_ERROR_MONITOR_H
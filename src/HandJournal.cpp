@@ -0,0 +1,114 @@
+#include "HandJournal.h"
+#include <EEPROM.h> // Ring storage
+#include <stddef.h> // For offsetof
+
+HandJournal::HandJournal(int baseAddress, uint32_t stepsPerCycle, unsigned long minIntervalMs)
+    : _baseAddress(baseAddress),
+      _config(_configKey(stepsPerCycle, HAND_JOURNAL_CYCLE_SECONDS)),
+      _minIntervalMs(minIntervalMs),
+      _nextSequence(1), _nextSlot(0), _hasRecord(false), _latest(),
+      _pending(false), _urgent(false), _wroteSinceBoot(false),
+      _lastWriteMs(0), _writeCount(0), _coalescedCount(0) {
+}
+
+void HandJournal::setCycle(uint32_t stepsPerCycle, uint32_t secondsPerCycle) {
+    _config = _configKey(stepsPerCycle, secondsPerCycle);
+}
+
+// Steps per cycle folded to 16 bits, and the cycle length where it is not 12 hours (so
+// records from builds before cycles other than 12 hours existed still match)
+uint16_t HandJournal::_configKey(uint32_t stepsPerCycle, uint32_t secondsPerCycle) {
+    uint32_t seconds = secondsPerCycle ^ HAND_JOURNAL_CYCLE_SECONDS;
+    return (uint16_t)(stepsPerCycle ^ (stepsPerCycle >> 16) ^ (seconds << 3) ^ (seconds >> 13));
+}
+
+// CRC-16/CCITT (poly 0x1021, init 0xFFFF), bitwise - 16 bytes per write does not need a table
+uint16_t HandJournal::_crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool HandJournal::_readSlot(uint8_t slot, HandJournalRecord& record) const {
+    EEPROM.get(_baseAddress + slot * (int)sizeof(HandJournalRecord), record);
+    if (record.sequence == 0xFFFFFFFFUL || record.config != _config) return false;
+    return record.crc == _crc16((const uint8_t*)&record, offsetof(HandJournalRecord, crc));
+}
+
+bool HandJournal::begin() {
+    _hasRecord = false;
+    _nextSequence = 1;
+    _nextSlot = 0;
+    _pending = false;
+    _urgent = false;
+    _wroteSinceBoot = false;
+
+    for (uint8_t slot = 0; slot < HAND_JOURNAL_SLOTS; slot++) {
+        HandJournalRecord record;
+        if (!_readSlot(slot, record)) continue;
+        if (!_hasRecord || record.sequence > _latest.sequence) {
+            _latest = record;
+            _hasRecord = true;
+            _nextSequence = record.sequence + 1;
+            _nextSlot = (uint8_t)((slot + 1) % HAND_JOURNAL_SLOTS);
+        }
+    }
+    return _hasRecord;
+}
+
+bool HandJournal::recover(uint32_t& cycleSteps, uint32_t& phase) const {
+    if (!_hasRecord) return false;
+    cycleSteps = _latest.cycleSteps;
+    phase = _latest.phase;
+    return true;
+}
+
+void HandJournal::markChanged(bool urgent) {
+    if (_pending) _coalescedCount++;
+    _pending = true;
+    if (urgent) _urgent = true;
+}
+
+bool HandJournal::writeDue() const {
+    if (!_pending) return false;
+    return _urgent || !_wroteSinceBoot || (millis() - _lastWriteMs >= _minIntervalMs);
+}
+
+bool HandJournal::write(uint32_t cycleSteps, uint32_t phase) {
+    _pending = false;
+    _urgent = false;
+    if (_hasRecord && _latest.cycleSteps == cycleSteps && _latest.phase == phase) {
+        return false; // Moved away and back again since the last record
+    }
+
+    HandJournalRecord record;
+    record.sequence = _nextSequence;
+    record.cycleSteps = cycleSteps;
+    record.phase = phase;
+    record.config = _config;
+    record.crc = _crc16((const uint8_t*)&record, offsetof(HandJournalRecord, crc));
+    EEPROM.put(_baseAddress + _nextSlot * (int)sizeof(HandJournalRecord), record);
+
+    _latest = record;
+    _hasRecord = true;
+    _nextSequence++;
+    _nextSlot = (uint8_t)((_nextSlot + 1) % HAND_JOURNAL_SLOTS);
+    _wroteSinceBoot = true;
+    _lastWriteMs = millis();
+    _writeCount++;
+    return true;
+}
+
+void HandJournal::clear() {
+    HandJournalRecord erased;
+    memset(&erased, 0xFF, sizeof(erased));
+    for (uint8_t slot = 0; slot < HAND_JOURNAL_SLOTS; slot++) {
+        EEPROM.put(_baseAddress + slot * (int)sizeof(HandJournalRecord), erased);
+    }
+    begin();
+}
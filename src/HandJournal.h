@@ -0,0 +1,106 @@
+/*
+ * Mechanical Clock with Onboard RTC - Hand Position Journal
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAND_JOURNAL_H
+#define HAND_JOURNAL_H
+
+#include <Arduino.h>
+
+// Number of records in the ring. Each write goes to the next slot, so every
+// slot (and every EEPROM cell in it) sees 1/HAND_JOURNAL_SLOTS of the writes.
+#define HAND_JOURNAL_SLOTS 64
+
+// Routine writes (hands ticking forward) are coalesced to at most one per interval.
+// 64 slots at one write a minute is 22.5 writes per cell per day: about 12 years
+// of the 100k-cycle endurance of the RA4M1 data flash.
+#define HAND_JOURNAL_MIN_INTERVAL_MS 60000UL
+
+// Dial cycle length the records are keyed with unless setCycle() says otherwise
+#define HAND_JOURNAL_CYCLE_SECONDS 43200UL
+
+// One journal record (16 bytes)
+struct HandJournalRecord {
+    uint32_t sequence;   // Write number, newest wins (0xFFFFFFFF = erased slot)
+    uint32_t cycleSteps; // Hand position: microsteps past 12:00 within the dial cycle
+    uint32_t phase;      // Fraction of a microstep beyond cycleSteps (units chosen by the clock)
+    uint16_t config;     // Dial cycle (steps and seconds) folded to 16 bits: a new gear/microstep build ignores old records
+    uint16_t crc;        // CRC-16/CCITT over the fields above
+};
+
+// Journals the absolute hand position into a wear-leveled ring of CRC-checked
+// EEPROM slots, so a cold boot knows where the hands are even if the power-off
+// interrupt never ran.
+//
+// A write that is interrupted by a power cut leaves at most its own slot with a
+// bad CRC; the previous record is in another slot and stays valid.
+class HandJournal {
+private:
+    const int _baseAddress;
+    uint16_t _config;
+    const unsigned long _minIntervalMs;
+
+    uint32_t _nextSequence;
+    uint8_t _nextSlot;
+
+    bool _hasRecord;           // A valid record was found or written
+    HandJournalRecord _latest; // Newest valid record
+
+    bool _pending;               // Position changed since the newest record
+    bool _urgent;                // ...by a correction rather than routine ticking
+    bool _wroteSinceBoot;        // The first write after boot is not rate limited
+    unsigned long _lastWriteMs;
+    unsigned long _writeCount;     // Records written since begin()
+    unsigned long _coalescedCount; // Changes folded into a later write
+
+    static uint16_t _crc16(const uint8_t* data, size_t length);
+    static uint16_t _configKey(uint32_t stepsPerCycle, uint32_t secondsPerCycle);
+    bool _readSlot(uint8_t slot, HandJournalRecord& record) const;
+
+public:
+    HandJournal(int baseAddress, uint32_t stepsPerCycle, unsigned long minIntervalMs = HAND_JOURNAL_MIN_INTERVAL_MS);
+
+    // Dial cycle the positions are in: `stepsPerCycle` microsteps every `secondsPerCycle`
+    // seconds. Records written for another cycle are ignored. Call before begin().
+    void setCycle(uint32_t stepsPerCycle, uint32_t secondsPerCycle);
+
+    // Scans the ring for the newest valid record. Returns true if one was found.
+    bool begin();
+
+    // Hand position in the newest record
+    bool recover(uint32_t& cycleSteps, uint32_t& phase) const;
+
+    // Notes that the hands moved. Urgent changes (catch-up moves, reversals, a new
+    // reference) are written at the next writeDue() check; routine ones wait out the interval.
+    void markChanged(bool urgent = false);
+
+    // True when a change is waiting and the rate limit allows writing it
+    bool writeDue() const;
+
+    // Appends a record for the position and clears the pending change.
+    // Returns false (nothing written) if it equals the newest record.
+    bool write(uint32_t cycleSteps, uint32_t phase);
+
+    // Erases the ring (all slots read back as empty)
+    void clear();
+
+    unsigned long getWriteCount() const { return _writeCount; }
+    unsigned long getCoalescedCount() const { return _coalescedCount; }
+    uint32_t getSequence() const { return _hasRecord ? _latest.sequence : 0; }
+};
+
+#endif // HAND_JOURNAL_H
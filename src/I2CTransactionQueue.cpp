@@ -0,0 +1,209 @@
+#include "I2CTransactionQueue.h"
+#include <Wire.h>
+#include <string.h> // For memcpy
+
+#if defined(ARDUINO_ARCH_RENESAS)
+#include <IRQManager.h>   // Interrupt vector allocation of the UNO R4 core
+#include "r_iic_master.h" // FSP IIC master driver
+#endif
+
+// Header address that sends the consumer back to the start of the ring (no 7-bit address)
+static const uint8_t I2C_QUEUE_WRAP = 0xFF;
+
+I2CTransactionQueue* I2CTransactionQueue::_activeQueue = nullptr;
+
+I2CTransactionQueue::I2CTransactionQueue()
+    : _head(0), _tail(0), _busy(false), _buildAddress(0), _buildLength(0),
+      _transactions(0), _nacks(0), _waits(0) {
+}
+
+bool I2CTransactionQueue::begin() {
+    _activeQueue = this;
+    if (!startBus(_transferDone)) {
+        _activeQueue = nullptr;
+        Serial.println("I2CTransactionQueue: could not open the I2C driver, staying on Wire.");
+        return false;
+    }
+    return true;
+}
+
+void I2CTransactionQueue::beginTransaction(uint8_t address) {
+    _buildAddress = address;
+    _buildLength = 0;
+}
+
+size_t I2CTransactionQueue::write(uint8_t value) {
+    if (_buildLength >= I2C_QUEUE_MAX_TRANSACTION) return 0;
+    _buildData[_buildLength++] = value;
+    return 1;
+}
+
+bool I2CTransactionQueue::endTransaction() {
+    uint16_t needed = bytesFor(_buildLength);
+    uint16_t head = _head;
+    uint16_t start = head;
+    uint16_t skipped = 0;
+    if (head + needed > I2C_QUEUE_SIZE) { // Kept contiguous for the driver: the ring end goes unused
+        skipped = (uint16_t)(I2C_QUEUE_SIZE - head);
+        start = 0;
+    }
+    if (freeBytes() < skipped + needed) return false;
+
+    if (skipped > 0) _ring[head] = I2C_QUEUE_WRAP;
+    _ring[start] = _buildAddress;
+    _ring[start + 1] = _buildLength;
+    memcpy(&_ring[start + 2], _buildData, _buildLength);
+
+    noInterrupts(); // Publish the transaction only after it is fully written
+    _head = (uint16_t)((start + needed) % I2C_QUEUE_SIZE);
+    if (!_busy) _startNext(); // The bus is idle: nothing will interrupt to start it
+    interrupts();
+    return true;
+}
+
+void I2CTransactionQueue::waitForRoom(uint16_t bytes) {
+    // A wrap can leave up to one transaction's worth of the ring end unused
+    uint32_t needed = (uint32_t)bytes + bytesFor(I2C_QUEUE_MAX_TRANSACTION) - 1;
+    if (freeBytes() >= needed || isIdle()) return;
+    _waits++;
+    while (freeBytes() < needed && !isIdle()) {
+        delayMicroseconds(I2C_QUEUE_POLL_US);
+    }
+}
+
+void I2CTransactionQueue::flush() {
+    while (!isIdle()) {
+        delayMicroseconds(I2C_QUEUE_POLL_US);
+    }
+}
+
+uint16_t I2CTransactionQueue::freeBytes() const {
+    uint16_t tail = _tail;
+    return (uint16_t)((tail + I2C_QUEUE_SIZE - _head - 1) % I2C_QUEUE_SIZE);
+}
+
+bool I2CTransactionQueue::isIdle() const {
+    return _tail == _head; // The transaction on the bus stays queued until it completes
+}
+
+// Starts the transaction at the tail, if any (ISR, or loop with interrupts off)
+void I2CTransactionQueue::_startNext() {
+    while (_tail != _head) {
+        uint16_t tail = _tail;
+        if (_ring[tail] == I2C_QUEUE_WRAP) {
+            _tail = 0;
+            continue;
+        }
+        uint8_t length = _ring[tail + 1];
+        _busy = true;
+        if (startTransfer(_ring[tail], &_ring[tail + 2], length)) return;
+
+        _nacks++; // Refused by the driver: dropped, like a NACK
+        _tail = (uint16_t)((tail + bytesFor(length)) % I2C_QUEUE_SIZE);
+    }
+    _busy = false;
+}
+
+void I2CTransactionQueue::_onTransferDone(bool acknowledged) {
+    uint16_t tail = _tail;
+    if (acknowledged) {
+        _transactions++;
+    } else {
+        _nacks++; // Not retried: the next frame rewrites whatever this one was
+    }
+    _tail = (uint16_t)((tail + bytesFor(_ring[tail + 1])) % I2C_QUEUE_SIZE);
+    _startNext();
+}
+
+void I2CTransactionQueue::_transferDone(bool acknowledged) {
+    if (_activeQueue) _activeQueue->_onTransferDone(acknowledged);
+}
+
+#if defined(ARDUINO_ARCH_RENESAS)
+
+// The IIC channel set up the way the core's Wire sets it up, but with our callback
+static iic_master_instance_ctrl_t queueI2cCtrl;
+static iic_master_extended_cfg_t queueI2cExtend;
+static i2c_master_cfg_t queueI2cCfg;
+static i2c_slave_cfg_t queueI2cSlaveCfg; // Required by IRQManager, unused
+static I2CTransactionQueue::TransferDone queueTransferDone = nullptr;
+static bool queueVectorsLinked = false; // queueI2cCfg holds the vectors IRQManager allocated
+static bool queueBusOpen = false;
+
+static void queueI2cCallback(i2c_master_callback_args_t* args) {
+    queueTransferDone(args->event == I2C_MASTER_EVENT_TX_COMPLETE);
+}
+
+// Interrupt vectors: IRQManager hands out the RA4M1's 32 ICU event links and never frees one,
+// and the core's Wire keeps its private configuration, so its four IIC vectors cannot be reused
+// here. Closing Wire's instance disables them (R_IIC_MASTER_Close) and this instance links four
+// more, once per boot: the fields stay valid after a failed open, and addPeripheral() only
+// allocates vectors still marked invalid. With the step timer, the RTC and the WiFi module's
+// UART that leaves well over half the links free.
+bool I2CTransactionQueue::startBus(TransferDone done) {
+    queueTransferDone = done;
+    if (queueBusOpen) return true; // Already ours from an earlier begin()
+
+    Wire.end(); // Frees the channel for the driver instance below
+    // The header pins on the IIC peripheral, as Wire.begin() sets them
+    R_IOPORT_PinCfg(&g_ioport_ctrl, g_pin_cfg[PIN_WIRE_SDA].pin,
+                    (uint32_t)(IOPORT_CFG_PERIPHERAL_PIN | IOPORT_PERIPHERAL_IIC | IOPORT_CFG_DRIVE_MID));
+    R_IOPORT_PinCfg(&g_ioport_ctrl, g_pin_cfg[PIN_WIRE_SCL].pin,
+                    (uint32_t)(IOPORT_CFG_PERIPHERAL_PIN | IOPORT_PERIPHERAL_IIC | IOPORT_CFG_DRIVE_MID));
+
+    queueI2cExtend.timeout_mode = IIC_MASTER_TIMEOUT_MODE_SHORT;
+    queueI2cExtend.timeout_scl_low = IIC_MASTER_TIMEOUT_SCL_LOW_ENABLED;
+    queueI2cExtend.clock_settings.brl_value = 27; // 100 kHz from PCLKB, as Wire sets it
+    queueI2cExtend.clock_settings.brh_value = 26;
+    queueI2cExtend.clock_settings.cks_value = 2;
+
+    queueI2cCfg.channel = I2C_QUEUE_CHANNEL;
+    queueI2cCfg.rate = I2C_MASTER_RATE_STANDARD;
+    queueI2cCfg.slave = 0x00;
+    queueI2cCfg.addr_mode = I2C_MASTER_ADDR_MODE_7BIT;
+    queueI2cCfg.p_transfer_tx = NULL;
+    queueI2cCfg.p_transfer_rx = NULL;
+    queueI2cCfg.p_callback = queueI2cCallback;
+    queueI2cCfg.p_context = &queueI2cCfg;
+    queueI2cCfg.p_extend = &queueI2cExtend;
+    if (!queueVectorsLinked) {
+        // IRQManager only allocates and links the vectors still marked invalid (and sets the priority)
+        queueI2cCfg.txi_irq = FSP_INVALID_VECTOR;
+        queueI2cCfg.rxi_irq = FSP_INVALID_VECTOR;
+        queueI2cCfg.tei_irq = FSP_INVALID_VECTOR;
+        queueI2cCfg.eri_irq = FSP_INVALID_VECTOR;
+
+        I2CIrqReq_t irqRequest;
+        irqRequest.mcfg = &queueI2cCfg;
+        irqRequest.scfg = &queueI2cSlaveCfg;
+        queueVectorsLinked = IRQManager::getInstance().addPeripheral(IRQ_I2C_MASTER, &irqRequest);
+    }
+    if (queueVectorsLinked && R_IIC_MASTER_Open(&queueI2cCtrl, &queueI2cCfg) == FSP_SUCCESS) {
+        queueBusOpen = true;
+        return true;
+    }
+    Wire.begin(); // Hand the channel back, so the blocking path still works
+    return false;
+}
+
+bool I2CTransactionQueue::startTransfer(uint8_t address, uint8_t* data, uint8_t length) {
+    if (R_IIC_MASTER_SlaveAddressSet(&queueI2cCtrl, address, I2C_MASTER_ADDR_MODE_7BIT) != FSP_SUCCESS) return false;
+    return R_IIC_MASTER_Write(&queueI2cCtrl, data, length, false) == FSP_SUCCESS;
+}
+
+#else
+
+// Host build: the desktop harness's Wire completes the write on (simulated) bus time
+static I2CTransactionQueue::TransferDone queueTransferDone = nullptr;
+
+bool I2CTransactionQueue::startBus(TransferDone done) {
+    queueTransferDone = done;
+    Wire.begin();
+    return Wire.hostInterruptDriven(); // Tests can make the driver fail to open
+}
+
+bool I2CTransactionQueue::startTransfer(uint8_t address, uint8_t* data, uint8_t length) {
+    return Wire.hostStartWrite(address, data, length, queueTransferDone);
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Mechanical Clock with Onboard RTC - Interrupt-Driven I2C Transaction Queue
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef I2C_TRANSACTION_QUEUE_H
+#define I2C_TRANSACTION_QUEUE_H
+
+#include <Arduino.h>
+
+// Ring buffer size in bytes. Each transaction takes a two-byte header (address, length) and
+// its data, stored contiguously.
+#define I2C_QUEUE_SIZE 256
+
+// Longest transaction (data bytes): a whole LCD line with its cursor move (LCD_MAX_PACKET)
+#define I2C_QUEUE_MAX_TRANSACTION 72
+
+// IIC channel of the SDA/SCL header pins (Wire) on the UNO R4
+#define I2C_QUEUE_CHANNEL 1
+
+// How often a producer waiting for room looks again
+#define I2C_QUEUE_POLL_US 100
+
+// Queues I2C write transactions and sends them from the I2C interrupt.
+//
+// loop() only copies each transaction into the ring; the transfer-complete interrupt of the
+// bus starts the next one, so a frame for the LCD costs loop() the copy rather than the
+// milliseconds it takes on the wire at 100 kHz. Once begin() succeeds the queue owns the bus:
+// nothing else may use Wire. On the UNO R4 the transfers go through the FSP IIC master driver
+// directly (Wire's driver is closed), whose callback runs in the interrupt. Host builds use the
+// interrupt-driven writes of the desktop harness's Wire, which can simulate bus time.
+class I2CTransactionQueue {
+public:
+    typedef void (*TransferDone)(bool acknowledged); // From the I2C interrupt
+
+private:
+    // Single-producer (loop) / single-consumer (ISR) ring of [address, length, data...]
+    uint8_t _ring[I2C_QUEUE_SIZE];
+    volatile uint16_t _head; // Next free byte (written by loop)
+    volatile uint16_t _tail; // Transaction on the bus, or the next one (written by ISR)
+    volatile bool _busy;     // A transfer is on the bus
+
+    // Transaction being built by loop()
+    uint8_t _buildAddress;
+    uint8_t _buildData[I2C_QUEUE_MAX_TRANSACTION];
+    uint8_t _buildLength;
+
+    volatile unsigned long _transactions; // Sent and acknowledged
+    volatile unsigned long _nacks;        // Not acknowledged, or refused by the driver
+    unsigned long _waits;                 // Calls to waitForRoom() that had to wait
+
+    static I2CTransactionQueue* _activeQueue; // Instance served by the I2C interrupt
+
+    void _startNext();
+    void _onTransferDone(bool acknowledged);
+    static void _transferDone(bool acknowledged);
+
+    // Bus driver: opens it with `done` as its completion callback; starts one write
+    static bool startBus(TransferDone done);
+    static bool startTransfer(uint8_t address, uint8_t* data, uint8_t length);
+
+public:
+    I2CTransactionQueue();
+
+    // Takes over the I2C bus. Returns false if the driver could not be opened; Wire is then
+    // still usable and nothing should be queued.
+    bool begin();
+
+    // Builds one write transaction: beginTransaction(), write() the data, endTransaction().
+    // endTransaction() returns false if the ring has no room; the transaction is dropped.
+    void beginTransaction(uint8_t address);
+    size_t write(uint8_t value); // 0 once the transaction is full
+    bool endTransaction();
+
+    // Ring bytes a transaction of `length` data bytes takes
+    static uint16_t bytesFor(uint8_t length) { return (uint16_t)(2 + length); }
+
+    // Waits until `bytes` (a sum of bytesFor()) can be queued, or the queue is empty
+    void waitForRoom(uint16_t bytes);
+
+    // Waits until every queued transaction is on the wire
+    void flush();
+
+    uint16_t freeBytes() const;
+    bool isIdle() const;
+    unsigned long transactions() const { return _transactions; }
+    unsigned long nacks() const { return _nacks; }
+    unsigned long waits() const { return _waits; }
+};
+
+#endif // I2C_TRANSACTION_QUEUE_H
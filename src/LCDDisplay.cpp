@@ -1,7 +1,6 @@
 #include "LCDDisplay.h"
 #include <Arduino.h> // For millis(), Serial.println()
-#include <stdio.h>   // For snprintf
-#include <string.h>  // For strncpy
+#include <string.h>  // For strlen
 #include "TimeUtils.h" // Include TimeUtils for utility functions and arrays
 
 // LCDDisplay class implementation
@@ -10,13 +9,15 @@
 
 // Constructor: Initializes the LiquidCrystal_I2C object with the given address
 LCDDisplay::LCDDisplay(uint8_t address)
-    : _lcd(address, 16, 2), _initialized(false), _address(address) {
+    : _lcd(address, 16, 2), _initialized(false), _address(address), _bufferInitialized(false),
+      _cursorLine(LCD_CURSOR_UNKNOWN), _cursorCol(LCD_CURSOR_UNKNOWN), _queued(false),
+      _backlightPin(LCD_PIN_BACKLIGHT), _packetLength(0), _rsPin(LCD_RS_UNKNOWN) {
     // Member initializers list is used for _lcd, _initialized, _address.
     // Other members (_lastDisplayedSecond, etc.) are initialized to -1 by default.
 }
 
 // begin(): Initializes the LCD hardware and checks for its presence
-bool LCDDisplay::begin() {
+bool LCDDisplay::begin(bool queued) {
     Serial.println("LCDDisplay::begin() called.");
     Wire.begin(); // Initialize I2C communication
 
@@ -47,6 +48,12 @@ bool LCDDisplay::begin() {
         // Create custom characters for WiFi and Sync symbols
         _lcd.createChar(0, _wifiSymbol);
         _lcd.createChar(1, _syncSymbol);
+        _cursorLine = LCD_CURSOR_UNKNOWN; // Left in character generator memory
+
+        // From here on the display is driven from the I2C interrupt
+        _queued = queued && _i2cQueue.begin();
+        _backlightPin = LCD_PIN_BACKLIGHT;
+        _rsPin = LCD_RS_UNKNOWN;
 
         // Initialize the smart buffer system
         initializeBuffer();
@@ -60,9 +67,26 @@ bool LCDDisplay::begin() {
     }
 }
 
+// DDRAM address of the first column of each line
+static const uint8_t LCD_ROW_OFFSETS[] = {0x00, 0x40, 0x14, 0x54};
+
+// "00" to "99", so two-digit fields need no formatting library (and no heap)
+static const char TWO_DIGITS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
 // updateTimeAndDate(): Updates both time and date portions of the display
 // Always updates both lines to ensure status messages get replaced
 // Respects real estate boundaries and doesn't overwrite status icons
+// Runs every second, so it renders straight into the buffer: no String, no snprintf.
 void LCDDisplay::updateTimeAndDate(const RTCTime& currentTime) {
     if (!_initialized) return; // Do nothing if LCD is not initialized
 
@@ -74,46 +98,30 @@ void LCDDisplay::updateTimeAndDate(const RTCTime& currentTime) {
     int currentMonth = Month2int(currentTime.getMonth()); // Convert Month enum to 1-12 int
     int currentYear = currentTime.getYear();
 
-    // Update date display using smart buffer
-    char dateStr[15]; // Buffer for date string: "DD/MMM/YY WWW" (14 chars max)
-    
     // Calculate day of week directly from UTC Unix timestamp to avoid conversion issues
     // We need to use UTC time for day calculation, not local time
     time_t utcUnixTime = getCurrentUTC(); // Get UTC time directly
     int dayOfWeekInt = ((utcUnixTime / 86400) + 4) % 7; // Unix epoch (1970-01-01) was a Thursday (4)
     
-    // snprintf for safe string formatting
-    snprintf(dateStr, sizeof(dateStr), "%02d/%s/%02d %s", 
-            currentDay,
-            MONTH_NAMES[currentMonth - 1], // MONTH_NAMES is 0-indexed (Jan=0)
-            currentYear % 100, // Get last two digits of the year
-            DOW_ABBREV[dayOfWeekInt]); // Get abbreviated day of week
-    
-    // Ensure we don't exceed DATE_END boundary
-    String dateDisplay = String(dateStr);
-    if (dateDisplay.length() > (DATE_END - DATE_START + 1)) {
-        dateDisplay = dateDisplay.substring(0, DATE_END - DATE_START + 1);
-    }
-    
-    // Pad date string to fill positions 0-14 on line 0
-    while (dateDisplay.length() < 15) {
-        dateDisplay += " "; // Pad with spaces
-    }
+    // Line 0: date "DD/MMM/YY WWW", padded to the status icon
+    uint8_t col = DATE_START;
+    col = putTwoDigits(0, col, (uint8_t)currentDay);
+    putChar(0, col++, '/');
+    col = putText(0, col, MONTH_NAMES[currentMonth - 1], 3); // MONTH_NAMES is 0-indexed (Jan=0)
+    putChar(0, col++, '/');
+    col = putTwoDigits(0, col, (uint8_t)(currentYear % 100)); // Last two digits of the year
+    putChar(0, col++, ' ');
+    col = putText(0, col, DOW_ABBREV[dayOfWeekInt], 3);
+    updateBufferArea(0, col, TEXT_AREA_END, "", 0);
     
-    // Create time content for line 1
-    char timeStr[9]; // Buffer for time string: "HH:MM:SS\0"
-    snprintf(timeStr, sizeof(timeStr), "%02d:%02d:%02d", 
-            currentHour, currentMinute, currentSecond);
-    
-    // Pad time string to fill positions 0-14 on line 1
-    String timeDisplay = String(timeStr);
-    while (timeDisplay.length() < 15) {
-        timeDisplay += " "; // Pad with spaces
-    }
-    
-    // Update each line separately (positions 0-14)
-    updateBufferArea(0, 0, 0, 14, dateDisplay);  // Line 0: Date
-    updateBufferArea(1, 1, 0, 14, timeDisplay);  // Line 1: Time
+    // Line 1: time "HH:MM:SS", padded the same way
+    col = TIME_START;
+    col = putTwoDigits(1, col, (uint8_t)currentHour);
+    putChar(1, col++, ':');
+    col = putTwoDigits(1, col, (uint8_t)currentMinute);
+    putChar(1, col++, ':');
+    col = putTwoDigits(1, col, (uint8_t)currentSecond);
+    updateBufferArea(1, col, TEXT_AREA_END, "", 0);
     
     // Update last displayed values
     _lastDisplayedDay = currentDay;
@@ -159,22 +167,21 @@ void LCDDisplay::updateNetworkStatus(int wifiStatus, unsigned long lastNtpSync,
 
 
 // printLine(): Prints a message to a specific line on the LCD, preserving status icons
-void LCDDisplay::printLine(uint8_t line, const String& msg) {
+void LCDDisplay::printLine(uint8_t line, const char* msg) {
     if (!_initialized) return;
     
-    // Pad message to fill positions 0-14 (preserving status icon at position 15)
-    String paddedMsg = msg.substring(0, LCD_WIDTH - 1);
-    while (paddedMsg.length() < 15) {
-        paddedMsg += " "; // Pad with spaces
-    }
-    
-    // Update constrained area (specific line, positions 0-14) - only writes to LCD if changed
-    updateBufferArea(line, line, 0, 14, paddedMsg);
+    // Message in positions 0-14, padded with spaces (preserving status icon at position 15)
+    size_t length = msg ? strlen(msg) : 0;
+    updateBufferArea(line, 0, TEXT_AREA_END, msg, (uint8_t)(length > LCD_WIDTH ? LCD_WIDTH : length));
     
     // Sync any changed regions to the LCD
     syncDirtyRegions();
 }
 
+void LCDDisplay::printLine(uint8_t line, const String& msg) {
+    printLine(line, msg.c_str());
+}
+
 // Smart Buffer Implementation Methods
 
 // initializeBuffer(): Initialize buffer with current LCD content
@@ -193,27 +200,42 @@ void LCDDisplay::initializeBuffer() {
     _bufferInitialized = true;
 }
 
-// updateBufferArea(): Update constrained area in buffer and mark as dirty
-void LCDDisplay::updateBufferArea(uint8_t startLine, uint8_t endLine, uint8_t startCol, uint8_t endCol, const String& content) {
-    if (!_bufferInitialized || startLine >= LCD_HEIGHT || endLine >= LCD_HEIGHT || 
-        startCol >= LCD_WIDTH || endCol >= LCD_WIDTH) return;
+// updateBufferArea(): Write `length` characters of `text` into columns startCol..endCol of a
+// line, padding the rest of the area with spaces. Changed characters are marked dirty.
+void LCDDisplay::updateBufferArea(uint8_t line, uint8_t startCol, uint8_t endCol, const char* text, uint8_t length) {
+    if (!_bufferInitialized || line >= LCD_HEIGHT || startCol >= LCD_WIDTH || endCol >= LCD_WIDTH) return;
     
-    uint8_t contentIndex = 0;
-    
-    // Update each line in the area
-    for (uint8_t line = startLine; line <= endLine && line < LCD_HEIGHT; line++) {
-        for (uint8_t col = startCol; col <= endCol && col < LCD_WIDTH; col++) {
-            char newChar = (contentIndex < content.length()) ? content[contentIndex++] : ' ';
-            
-            if (_buffer[line][col] != newChar) {
-                _buffer[line][col] = newChar;
-                _charDirty[line][col] = true;
-                _lineDirty[line] = true;
-            }
-        }
+    uint8_t index = 0;
+    for (uint8_t col = startCol; col <= endCol; col++) {
+        putChar(line, col, (index < length) ? text[index++] : ' ');
     }
 }
 
+// putChar(): Set one buffer character, marking it dirty if it changed
+void LCDDisplay::putChar(uint8_t line, uint8_t col, char c) {
+    if (line >= LCD_HEIGHT || col >= LCD_WIDTH || _buffer[line][col] == c) return;
+    _buffer[line][col] = c;
+    _charDirty[line][col] = true;
+    _lineDirty[line] = true;
+}
+
+// putText(): Copy up to `length` characters (fewer if the text ends first); returns the
+// column after the last one written
+uint8_t LCDDisplay::putText(uint8_t line, uint8_t col, const char* text, uint8_t length) {
+    for (uint8_t i = 0; i < length && text[i] != '\0'; i++) {
+        putChar(line, col++, text[i]);
+    }
+    return col;
+}
+
+// putTwoDigits(): Write 0-99 as two digits with a leading zero; returns the next column
+uint8_t LCDDisplay::putTwoDigits(uint8_t line, uint8_t col, uint8_t value) {
+    if (value > 99) value = 99;
+    putChar(line, col, TWO_DIGITS[value * 2]);
+    putChar(line, col + 1, TWO_DIGITS[value * 2 + 1]);
+    return col + 2;
+}
+
 // updateStatusArea(): Update status icons (position 15) on both lines
 void LCDDisplay::updateStatusArea(uint8_t line, char wifiChar, char syncChar) {
     if (!_bufferInitialized || line >= LCD_HEIGHT) return;
@@ -256,35 +278,108 @@ void LCDDisplay::clearBuffer() {
 }
 
 // syncDirtyRegions(): Sync only changed regions to LCD
+// Changed characters go out in runs: one cursor move, then the characters. Clean characters
+// between two changed ones are rewritten when that costs fewer I2C bytes than a second cursor
+// move (see LCD_MAX_BRIDGED_GAP), so the once-a-second update sends the seconds digit alone.
 void LCDDisplay::syncDirtyRegions() {
     if (!_initialized || !_bufferInitialized) return;
     
-    for (int line = 0; line < LCD_HEIGHT; line++) {
-        if (_lineDirty[line]) {
-            // Write only positions 0-14 to preserve status icons at position 15
-            _lcd.setCursor(0, line);
-            
-            // Create a temporary string with only positions 0-14
-            char tempLine[16];
-            strncpy(tempLine, _buffer[line], 15);
-            tempLine[15] = '\0'; // Ensure null termination
-            
-            _lcd.print(tempLine);
-            
-            // Handle status icons separately if they're dirty
-            if (_charDirty[line][15]) {
-                _lcd.setCursor(15, line);
-                _lcd.print(_buffer[line][15]);
-            }
-            
-            _lineDirty[line] = false;
-            
-            // Clear dirty flags for this line
-            for (int col = 0; col < LCD_WIDTH; col++) {
-                _charDirty[line][col] = false;
-            }
+    for (uint8_t line = 0; line < LCD_HEIGHT; line++) {
+        if (!_lineDirty[line]) continue;
+        
+        uint8_t startCol = 0;
+        uint8_t endCol = 0;
+        uint8_t fromCol = 0;
+        while (nextDirtyRun(line, fromCol, startCol, endCol)) {
+            writeRun(line, startCol, endCol);
+            fromCol = endCol + 1;
+        }
+        
+        _lineDirty[line] = false;
+        for (uint8_t col = 0; col < LCD_WIDTH; col++) {
+            _charDirty[line][col] = false;
+        }
+    }
+}
+
+// nextDirtyRun(): Finds the next run to write on a line, from column `fromCol` on.
+// The run starts and ends on a changed character; returns false if nothing changed.
+bool LCDDisplay::nextDirtyRun(uint8_t line, uint8_t fromCol, uint8_t& startCol, uint8_t& endCol) const {
+    uint8_t col = fromCol;
+    while (col < LCD_WIDTH && !_charDirty[line][col]) col++;
+    if (col >= LCD_WIDTH) return false;
+    
+    startCol = col;
+    endCol = col;
+    for (col = startCol + 1; col < LCD_WIDTH; col++) {
+        if (!_charDirty[line][col]) continue;
+        if (col - endCol - 1 > LCD_MAX_BRIDGED_GAP) break; // A cursor move is cheaper
+        endCol = col;
+    }
+    return true;
+}
+
+// writeRun(): Writes columns startCol..endCol of a line, moving the cursor only if the
+// previous run did not leave it there. The whole run is one transmission: queued, this returns
+// as soon as it is in the ring (waiting only if the ring is too full to take it).
+void LCDDisplay::writeRun(uint8_t line, uint8_t startCol, uint8_t endCol) {
+    _packetLength = 0;
+    if (_cursorLine != line || _cursorCol != startCol) {
+        packSend((uint8_t)(0x80 | (LCD_ROW_OFFSETS[line] + startCol)), 0); // Set DDRAM address
+    }
+    for (uint8_t col = startCol; col <= endCol; col++) {
+        packSend((uint8_t)_buffer[line][col], LCD_PIN_RS);
+    }
+    sendPacket();
+    _cursorLine = line;
+    _cursorCol = endCol + 1;
+}
+
+// packSend(): Adds a character (mode LCD_PIN_RS) or command (mode 0) to the packet.
+// The controller takes D4..D7 on the falling edge of EN, so a nibble needs only the write that
+// raises EN (the data may change with it) and the one that drops it. RS has to be steady before
+// EN rises, so a change of RS gets a write of its own first. LiquidCrystal_I2C instead sends
+// three writes per nibble, each its own transmission: 12 bytes on the bus per character to 4.
+// At 100 kHz, two writes apart (180 us) is well past the controller's 37 us per operation.
+void LCDDisplay::packSend(uint8_t value, uint8_t mode) {
+    if (_rsPin != mode) {
+        _packet[_packetLength++] = (uint8_t)(mode | _backlightPin);
+        _rsPin = mode;
+    }
+    uint8_t nibbles[2] = {(uint8_t)(value & 0xF0), (uint8_t)((value << 4) & 0xF0)};
+    for (uint8_t i = 0; i < 2; i++) {
+        uint8_t pins = (uint8_t)(nibbles[i] | mode | _backlightPin);
+        _packet[_packetLength++] = (uint8_t)(pins | LCD_PIN_EN);
+        _packet[_packetLength++] = pins;
+    }
+}
+
+// sendPacket(): Sends the packet as one queued transaction, or straight to Wire (in as few
+// transmissions as its buffer allows: the expander holds its outputs in between)
+void LCDDisplay::sendPacket() {
+    if (_packetLength == 0) return;
+    if (_queued) {
+        _i2cQueue.waitForRoom(I2CTransactionQueue::bytesFor(_packetLength));
+        _i2cQueue.beginTransaction(_address);
+        for (uint8_t i = 0; i < _packetLength; i++) {
+            _i2cQueue.write(_packet[i]);
+        }
+        _i2cQueue.endTransaction();
+    } else {
+        for (uint8_t start = 0; start < _packetLength; start += LCD_WIRE_CHUNK) {
+            uint8_t length = _packetLength - start;
+            if (length > LCD_WIRE_CHUNK) length = LCD_WIRE_CHUNK;
+            Wire.beginTransmission(_address);
+            Wire.write(&_packet[start], length);
+            Wire.endTransmission();
         }
     }
+    _packetLength = 0;
+}
+
+// flush(): Waits for the queued output to reach the display
+void LCDDisplay::flush() {
+    if (_queued) _i2cQueue.flush();
 }
 
 // debugPrintBuffer(): Debug helper to print buffer contents
@@ -299,19 +394,50 @@ void LCDDisplay::debugPrintBuffer() {
 }
 
 // clear(): Clears the entire LCD display
+// Queued, the characters shown are overwritten with spaces instead: the controller's clear
+// command runs for 1.5 ms, and nothing in the queue would wait for it.
 void LCDDisplay::clear() {
-    if (_initialized) {
-        _lcd.clear();
-        clearBuffer(); // Clear buffer to match LCD
+    if (!_initialized) return;
+    if (_queued) {
+        clearBuffer();
+        syncDirtyRegions();
+        return;
     }
+    _lcd.clear();
+    _cursorLine = 0; // Clearing homes the cursor
+    _cursorCol = 0;
+    _rsPin = LCD_RS_UNKNOWN;
+    clearBuffer(); // Clear buffer to match LCD
 }
 
 // backlight(): Turns on the LCD backlight
 void LCDDisplay::backlight() {
-    if (_initialized) _lcd.backlight();
+    if (!_initialized) return;
+    if (_queued) {
+        _backlightPin = LCD_PIN_BACKLIGHT;
+        _packet[0] = _backlightPin; // RS and EN low
+        _packetLength = 1;
+        _rsPin = 0;
+        sendPacket();
+    } else {
+        _lcd.backlight();
+        _backlightPin = LCD_PIN_BACKLIGHT;
+        _rsPin = LCD_RS_UNKNOWN;
+    }
 }
 
 // noBacklight(): Turns off the LCD backlight
 void LCDDisplay::noBacklight() {
-    if (_initialized) _lcd.noBacklight();
+    if (!_initialized) return;
+    if (_queued) {
+        _backlightPin = 0;
+        _packet[0] = _backlightPin; // RS and EN low
+        _packetLength = 1;
+        _rsPin = 0;
+        sendPacket();
+    } else {
+        _lcd.noBacklight();
+        _backlightPin = 0;
+        _rsPin = LCD_RS_UNKNOWN;
+    }
 } 
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <LiquidCrystal_I2C.h> // For LCD control
 #include <RTC.h> // For RTCTime object (passed for display)
 #include <WiFiS3.h> // For WL_CONNECTED status (used in updateNetworkStatus)
+#include "I2CTransactionQueue.h" // Frames go out from the I2C interrupt
 
 // Global utility functions that LCDDisplay might use for formatting
 // Month2int and DayOfWeek2int are provided by the RTC library
@@ -24,6 +25,7 @@ const uint8_t TIME_START = 0;      // Time starts at position 0
 const uint8_t TIME_END = 7;        // Time ends at position 7 (8 chars total)
 const uint8_t STATUS_START = 14;   // Status icons start at position 14
 const uint8_t STATUS_END = 15;     // Status icons end at position 15
+const uint8_t TEXT_AREA_END = 14;  // Date, time and messages may use positions 0-14
 
 // Status Icon Positions
 const uint8_t WIFI_ICON_POS = 15;  // WiFi icon at position 15, line 0
@@ -33,6 +35,32 @@ const uint8_t SYNC_ICON_POS = 15;  // Sync icon at position 15, line 1
 const uint8_t ERROR_LINE_START = 0;
 const uint8_t ERROR_LINE_END = 15;
 
+// I2C cost model for the flush planner, in bytes on the bus. Each run goes out as one
+// transmission (see writeRun()): a character is two nibbles, each written to the expander once
+// with EN high and once with EN low. A cursor move costs a command the same way, plus the
+// transmission's address byte and an RS change on either side of it.
+const uint8_t LCD_I2C_BYTES_PER_CHAR = 2 * 2;
+const uint8_t LCD_I2C_BYTES_PER_CURSOR_MOVE = 1 + 1 + 2 * 2 + 1;
+
+// A run of clean characters between two dirty ones is rewritten (rather than skipped with a
+// cursor move) when that costs no more
+const uint8_t LCD_MAX_BRIDGED_GAP = LCD_I2C_BYTES_PER_CURSOR_MOVE / LCD_I2C_BYTES_PER_CHAR;
+
+// Cursor position not known (after a custom character upload)
+const uint8_t LCD_CURSOR_UNKNOWN = 0xFF;
+
+// PCF8574 backpack wiring: P0 RS, P1 RW, P2 EN, P3 backlight, P4..P7 D4..D7 of the HD44780
+const uint8_t LCD_PIN_RS = 0x01;
+const uint8_t LCD_PIN_EN = 0x04;
+const uint8_t LCD_PIN_BACKLIGHT = 0x08;
+const uint8_t LCD_RS_UNKNOWN = 0xFF; // RS level not known (LiquidCrystal_I2C wrote last)
+
+// Longest run packet: RS low, cursor move, RS high, then a whole line of characters
+const uint8_t LCD_MAX_PACKET = 1 + 2 * 2 + 1 + LCD_WIDTH * 2 * 2;
+
+// Bytes per Wire transmission when not queued (the smallest Wire transmit buffer, AVR's)
+const uint8_t LCD_WIRE_CHUNK = 32;
+
 class LCDDisplay {
 private:
     LiquidCrystal_I2C _lcd;
@@ -44,6 +72,19 @@ private:
     bool _lineDirty[LCD_HEIGHT];             // Track which lines changed
     bool _charDirty[LCD_HEIGHT][LCD_WIDTH];  // Track which chars changed
     bool _bufferInitialized;
+    uint8_t _cursorLine;                     // Where the next character written lands
+    uint8_t _cursorCol;                      // (the display advances it after each one)
+
+    // Once begin() has set up the LCD, frames are queued and sent from the I2C interrupt
+    // (LiquidCrystal_I2C and Wire are not used again)
+    I2CTransactionQueue _i2cQueue;
+    bool _queued;
+    uint8_t _backlightPin;                   // Backlight bit of every expander write
+
+    // Run packet being encoded: expander writes, sent as one transmission
+    uint8_t _packet[LCD_MAX_PACKET];
+    uint8_t _packetLength;
+    uint8_t _rsPin;                          // RS level of the last expander write
 
     // Custom characters (as members to be created once)
     byte _wifiSymbol[8] = {
@@ -82,18 +123,31 @@ private:
 
     // Private helper methods for constrained area buffer management
     void initializeBuffer();
-    void updateBufferArea(uint8_t startLine, uint8_t endLine, uint8_t startCol, uint8_t endCol, const String& content);
+    void updateBufferArea(uint8_t line, uint8_t startCol, uint8_t endCol, const char* text, uint8_t length);
+    void putChar(uint8_t line, uint8_t col, char c);
+    uint8_t putText(uint8_t line, uint8_t col, const char* text, uint8_t length);
+    uint8_t putTwoDigits(uint8_t line, uint8_t col, uint8_t value);
     void updateStatusArea(uint8_t line, char wifiChar, char syncChar);
     void clearBufferLine(uint8_t line);
     void clearBuffer();
     void syncDirtyRegions(); // Sync only changed regions to LCD
+    bool nextDirtyRun(uint8_t line, uint8_t fromCol, uint8_t& startCol, uint8_t& endCol) const;
+    void writeRun(uint8_t line, uint8_t startCol, uint8_t endCol);
+    void packSend(uint8_t value, uint8_t mode); // Adds a character or command to the packet
+    void sendPacket();                          // Queues the packet, or writes it to Wire
     
 public:
     // Constructor: Takes the I2C address of the LCD
     LCDDisplay(uint8_t address = 0x27);
 
     // Initializes the LCD hardware. Returns true on success, false on failure.
-    bool begin(); 
+    // With `queued` (the default) later output goes through the I2C transaction queue;
+    // without it, or if the queue cannot take over the bus, every write blocks on Wire.
+    bool begin(bool queued = true);
+
+    // Waits until everything drawn so far is on the display
+    void flush();
+    bool isQueued() const { return _queued; }
     
     // Updates only the time and date portion of the display.
     // Respects real estate boundaries and doesn't overwrite status icons.
@@ -104,6 +158,7 @@ public:
     void updateNetworkStatus(int wifiStatus, unsigned long lastNtpSync, unsigned long ntpSyncInterval);
 
     // Prints a message to a specific line on the LCD, clearing the line first.
+    void printLine(uint8_t line, const char* msg);
     void printLine(uint8_t line, const String& msg);
 
     // Clears the entire LCD display.
@@ -2,31 +2,31 @@
 #define LED_H
 
 #include <Arduino.h>
+#include "FastPin.h"
 
 // ============================================================================
 // LED CONTROL CLASS
 // ============================================================================
+// The pin is a template parameter so writes go through FastPin: on() and off()
+// are free to call on every loop pass, only changes reach the GPIO.
+template <uint8_t Pin>
 class LED {
 private:
-    byte ledPin;
-    bool currentState;
+    FastPin<Pin> ledPin;
 
 public:
-    // Constructor
-    LED(byte pin);
-    
     // Initialization
-    void begin();
-    
+    void begin() { ledPin.begin(LOW); }
+
     // Control methods
-    void on();
-    void off();
-    void toggle();
-    void setState(bool state);
-    
+    void on() { ledPin.high(); }
+    void off() { ledPin.low(); }
+    void toggle() { ledPin.write(!isOn()); }
+    void setState(bool state) { ledPin.write(state ? HIGH : LOW); }
+
     // Status methods
-    bool isOn() const;
-    bool getState() const;
+    bool isOn() const { return ledPin.level() == HIGH; }
+    bool getState() const { return isOn(); }
 };
 
-#endif // LED_H 
\ No newline at end of file
+#endif // LED_H
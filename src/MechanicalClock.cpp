@@ -13,62 +13,133 @@ String formatTime(time_t unixTime) {
     return String(buffer);
 }
 
-MechanicalClock::MechanicalClock(int stepPin, int dirPin, int enablePin, int ms1Pin, int ms2Pin, int ms3Pin, int ledPin,
-                                 RTClock& rtcRef, LCDDisplay& lcdRef)
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+volatile uint32_t MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_rtcSecondTick = 0;
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+volatile uint32_t MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_rtcSecondCount = 0;
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::MechanicalClockT(int stepPin, int dirPin, RTClock& rtcRef, LCDDisplay& lcdRef)
     : Clock(rtcRef, lcdRef),
-      _myStepper(AccelStepper::DRIVER, stepPin, dirPin),
-      _activityLED(ledPin),
-      _enablePin(enablePin), _ms1Pin(ms1Pin), _ms2Pin(ms2Pin), _ms3Pin(ms3Pin),
-      _stepperIdleTimeout(5000),
-      _currentClockTime(0),
-      _lastStepperMoveTime(0)
+      _stepEngine(stepPin, dirPin),
+      _stepsPerDialCycle(STEPS_PER_DIAL_CYCLE), _secondsPerDialCycle(SECONDS_PER_DIAL_CYCLE),
+      _activeMode(MicrostepMode), _gridOffset(0),
+      _planner(CATCHUP_MAX_SPEED, CATCHUP_ACCELERATION),
+      _catchUpStartTime(0),
+      _catchUpTimeSavedMs(0),
+      _driverPower(),
+      _scheduledTick(0), _polledPosition(0),
+      _holdThresholdSeconds(HOLD_MAX_AHEAD_SECONDS),
+      _holdDeficitSteps(0),
+      _holdStepsSaved(0),
+      _holdReversalsSaved(0),
+      _journal(EEPROM_ADDRESS_HAND_JOURNAL, STEPS_PER_DIAL_CYCLE),
+    _handError(),
+      _timeZoneOffsetHours(0), _useDST(false), _offsetStale(true),
+      _utcOffsetSeconds(0), _offsetFromUTC(0), _offsetChangeUTC(0), _plannedOffsetSeconds(0), _plannedJumpSteps(0),
+      _dstJumpRemaining(0), _dstJumps(0),
+      _stepScheduling(true), _refSecondCount(0), _refUTC(0), _rtcSetAtCount(0),
+      _sweepMode(false), _sweepLocked(false), _sweepPosition(0), _sweepTick(0), _sweepSlewTicks(0),
+      _homeSensorFitted(HOME_SENSOR_FITTED != 0), _homeDialSeconds(HOME_DIAL_SECONDS), _homingPhase(HOMING_IDLE),
+      _homingDirection(1), _homingMark(0), _homingTravel(0), _homingStartMs(0), _lastHomingMs(0), _homingFailures(0),
+      _powerDownUTC(0)
 {
-    // Initialize with proper values immediately
-    _setMicrostepping(CURRENT_MICROSTEP);
+    GearRatio ratio = {GearNum, GearDen};
+    if (GearNum == 0) {
+        ratio.motorRevs = GEAR_RATIO_DEFAULT_NUM;
+        ratio.dialRevs = GEAR_RATIO_DEFAULT_DEN;
+    }
+    setGearRatio(ratio);
 }
 
-void MechanicalClock::_enableStepperDriver() {
-    digitalWrite(_enablePin, LOW); // LOW enables A4988 driver
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setGearRatio(const GearRatio& ratio) {
+    if (!isValidGearRatio(ratio)) return false;
+    
+    GearRatio reduced = reduceGearRatio(ratio);
+    uint32_t steps = (uint32_t)STEPS_PER_REVOLUTION * reduced.motorRevs;
+    uint32_t seconds = (uint32_t)SECONDS_IN_12_HOURS * reduced.dialRevs;
+    uint32_t divisor = stepRatioGcd(steps, seconds);
+    if (!_handPosition.setRatio(steps / divisor, seconds / divisor)) return false; // Not this build's ratio
+    
+    _gearRatio = reduced;
+    _stepsPerDialCycle = steps;
+    _secondsPerDialCycle = seconds;
+    _journal.setCycle(steps, seconds);
+    return true;
 }
 
-void MechanicalClock::_disableStepperDriver() {
-    digitalWrite(_enablePin, HIGH); // HIGH disables A4988 driver
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_enableStepperDriver() {
+    if (_enablePin.low()) { // LOW enables A4988 driver
+        _stepEngine.setOutputEnabled(true, DRIVER_WAKE_US / STEP_ENGINE_TICK_US);
+        _driverPower.noteEnabled(millis(), true);
+    }
 }
 
-void MechanicalClock::_setMicrostepping(uint8_t mode) {
-    digitalWrite(_ms1Pin, (mode & 0b100) ? HIGH : LOW);
-    digitalWrite(_ms2Pin, (mode & 0b010) ? HIGH : LOW);
-    digitalWrite(_ms3Pin, (mode & 0b001) ? HIGH : LOW);
-    
-    // Calculate steps per revolution based on microstepping
-    int microstepMultiplier = 1;
-    switch (mode) {
-        case MICROSTEP_FULL: microstepMultiplier = 1; break;
-        case MICROSTEP_HALF: microstepMultiplier = 2; break;
-        case MICROSTEP_QUARTER: microstepMultiplier = 4; break;
-        case MICROSTEP_EIGHTH: microstepMultiplier = 8; break;
-        case MICROSTEP_SIXTEENTH: microstepMultiplier = 16; break;
-        default: microstepMultiplier = 1; break;
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_disableStepperDriver() {
+    _stepEngine.setOutputEnabled(false); // No pulses into a disabled driver: they would be lost
+    if (_enablePin.high()) { // HIGH disables A4988 driver
+        _driverPower.noteEnabled(millis(), false);
     }
-    
-    _stepsPerRevolution = BASE_STEPS_PER_REV * microstepMultiplier;
-    _secondsPerStep = 18 / microstepMultiplier; // 18 seconds per step for full stepping
-    // TODO: Consider implementing fractional accumulator to handle non-integer division results
-    // For microstepping modes > 2, this integer division loses precision (e.g., 18/4=4 instead of 4.5)
-    // Solution: Accumulate fractional error and add catch-up steps when error >= 1.0
 }
 
-void MechanicalClock::begin() {
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_setMicrostepping(uint8_t mode) {
+    // Only called with the step queue empty: the driver latches MS1..MS3 on each STEP edge
+    _ms1Pin.write((mode & 0b100) ? HIGH : LOW);
+    _ms2Pin.write((mode & 0b010) ? HIGH : LOW);
+    _ms3Pin.write((mode & 0b001) ? HIGH : LOW);
+    _activeMode = mode;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::begin() {
     Serial.println("MechanicalClock::begin() called.");
     
     // Hardware initialization
     _activityLED.begin(); // Initialize LED pin
-    pinMode(_enablePin, OUTPUT);
-    _disableStepperDriver();
-    setMicrosteppingMode(CURRENT_MICROSTEP);
-    _myStepper.setMaxSpeed(50);
-    _myStepper.setAcceleration(2);
-    _myStepper.setSpeed(5);
+    _enablePin.begin(HIGH); // Driver disabled until there is something to move
+    _stepEngine.setOutputEnabled(false);
+    _ms1Pin.begin((MicrostepMode & 0b100) ? HIGH : LOW);
+    _ms2Pin.begin((MicrostepMode & 0b010) ? HIGH : LOW);
+    _ms3Pin.begin((MicrostepMode & 0b001) ? HIGH : LOW);
+    _activeMode = MicrostepMode;
+    _gridOffset = 0; // The A4988 translator powers up at its home position, which is on every step grid
+    _homingPhase = HOMING_IDLE;
+    if (_homeSensorFitted) {
+        pinMode(HOME_SENSOR_PIN, INPUT_PULLUP);
+    }
+    if (!_stepEngine.begin()) {
+        Serial.println("ERROR: Step pulse timer could not be started - hands will not move.");
+    }
+    
+    _handError.begin(millis());
+    _driverPower.begin(millis());
+    
+    // Second boundaries time the scheduled steps; without them steps go out as updates find them due
+    _rtcSecondCount = 0;
+    _refSecondCount = 0;
+    _rtcSetAtCount = 0;
+    if (!_rtc.setPeriodicCallback(_rtcSecondIsr, Period::ONCE_EVERY_1_SEC)) {
+        Serial.println("RTC periodic interrupt unavailable - steps timed by loop()");
+    }
+    
+    // The movement this clock drives, if it has been stored
+    GearRatio stored;
+    if (loadGearRatio(EEPROM_ADDRESS_GEAR_RATIO, stored) && !setGearRatio(stored)) {
+        Serial.print("Gear ratio in EEPROM ("); Serial.print(stored.motorRevs); Serial.print("/");
+        Serial.print(stored.dialRevs); Serial.println(") does not match this build - ignored");
+    }
+    Serial.print("Gear ratio: "); Serial.print(_gearRatio.motorRevs); Serial.print("/");
+    Serial.print(_gearRatio.dialRevs); Serial.print(" motor/dial revolutions, ");
+    Serial.print(_stepsPerDialCycle); Serial.print(" steps per "); Serial.print(_secondsPerDialCycle);
+    Serial.println(" s");
+    
+    // The journal knows where the hands physically stopped, whether or not the power-off ISR ran
+    bool journaled = _recoverFromJournal();
     
     // Enhanced power recovery logic
     Serial.println("=== POWER RECOVERY ANALYSIS ===");
@@ -84,32 +155,41 @@ void MechanicalClock::begin() {
         Serial.print("Test mode: "); Serial.println(testMode ? "YES" : "NO");
         
         if (powerDownTime != 0) {
-            Serial.println("✓ Valid power-down time found - will calculate stepper adjustment after NTP sync");
+            Serial.println("✓ Valid power-down time found - hands catch up from the RTC if it kept time, else after NTP sync");
+            _powerDownUTC = powerDownTime;
             
             // Clear the saved data immediately to avoid re-using it
             clearPowerRecoveryData();
             Serial.println("✓ Cleared saved power recovery data from EEPROM.");
             
-            // Store the power-down time for use after NTP sync
-            _currentClockTime = powerDownTime;
+            // Store the power-down time for the first update (the journal is more exact when present).
+            // The dial showed local time, with the offset in effect at that moment.
+            if (!journaled) {
+                _handPosition.anchor(powerDownTime + utcOffsetSeconds(powerDownTime, _timeZoneOffsetHours, _useDST));
+            }
             
             // If this was a test simulation, provide immediate feedback
             if (testMode) {
                 Serial.println("=== TEST MODE DETECTED ===");
                 Serial.println("Power recovery simulation successful!");
-                Serial.println("Clock will adjust position after NTP sync.");
+                Serial.println("Clock will adjust position once the RTC holds valid time.");
             }
         } else {
-            Serial.println("No power-down time found - will wait for NTP sync before calculating stepper position");
-            _currentClockTime = 0;
+            Serial.println("No power-down time found - hands start from the RTC once it holds valid time");
+            if (!journaled) _handPosition.anchor(0);
         }
     } else {
         Serial.println("No valid power recovery data found - starting fresh");
-        _currentClockTime = 0;
+        if (!journaled) _handPosition.anchor(0);
     }
     
     Serial.println("=== POWER RECOVERY ANALYSIS COMPLETE ===");
     
+    // With a sensor the hands are referenced to it; what was recovered above is the fallback
+    if (_homeSensorFitted) {
+        startHoming();
+    }
+    
     _activityLED.on();
     delay(200);
     _activityLED.off();
@@ -121,126 +201,774 @@ void MechanicalClock::begin() {
 
 
 
-void MechanicalClock::handlePowerOff() {
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::handlePowerOff() {
     // Call base class to save current time to EEPROM
     Clock::handlePowerOff();
     
     // Mechanical-specific power-off handling
+    long target = _stepEngine.targetPosition();
+    _stepEngine.clear(); // Stop issuing pulses
     _activityLED.on(); 
-    digitalWrite(_enablePin, HIGH); // Disable stepper driver
+    _disableStepperDriver();
+    
+    // Steps already committed to the hand position but never pulsed will not happen now
+    long unissued = target - _stepEngine.currentPosition() + _planner.stepsRemaining() * _planner.direction();
+    if (_activeMode != MicrostepMode) unissued *= CATCHUP_STEP_MICROSTEPS;
+    _planner.cancel();
+    if (_handPosition.seconds() != 0 && _homingPhase == HOMING_IDLE) { // Mid-homing the next boot homes again
+        _handPosition.commit(-unissued);
+        uint32_t cycleSteps, phase;
+        _dialPosition(_handPosition, cycleSteps, phase);
+        _journal.write(cycleSteps, phase); // Exact final position, bypassing the rate limit
+    }
 }
 
-void MechanicalClock::updateCurrentTime() {
+// An RTC that lost its backup supply restarts from its reset date. A time before the one it
+// gave at power-down shows that too: a running RTC cannot have gone back.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::isRtcTimeValid() {
+    if (!Clock::isRtcTimeValid()) return false;
+    return _powerDownUTC == 0 || getCurrentUTC() >= _powerDownUTC;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::updateCurrentTime() {
     // Unified time update method - handles both normal operation and sync events
-    _myStepper.run(); // Always run stepper to execute any pending movements
+    // (pulses for queued movements are generated by the step timer interrupt)
 
-    // Get current UTC time from RTC
-    time_t currentUTC = getCurrentUTC();
+    // Get current UTC time from RTC, with the step timer tick its second began on
+    time_t currentUTC;
+    uint32_t secondTick;
+    bool haveSecondTick = _readSecondReference(currentUTC, secondTick);
+    
+    // Local time for the dial. The offset only needs working out again at the planned
+    // DST change, after a time zone change or if the RTC is set back.
+    if (_offsetStale || (_offsetChangeUTC != 0 && currentUTC >= _offsetChangeUTC) || currentUTC < _offsetFromUTC) {
+        _updateUtcOffset(currentUTC);
+    }
+    time_t currentTime = currentUTC + _utcOffsetSeconds;
     
-    // If _currentClockTime is 0, this is the first sync after startup
+    // If the hands have no reference yet, this is the first sync after startup
     // Just set the current time without calculating movement
-    if (_currentClockTime == 0) {
+    if (_handPosition.seconds() == 0 && _homingPhase == HOMING_IDLE) {
         Serial.println("[DEBUG] First time sync - setting current position without movement");
-        _currentClockTime = currentUTC;
+        _handPosition.anchor(currentTime);
+        _journal.markChanged(true);
         return;
     }
     
-    long timeDiff = currentUTC - _currentClockTime;
-    
-    // If time difference is large (> 6 hours), use shortest path logic
-    if (abs(timeDiff) > SECONDS_IN_12_HOURS / 2) {
-        Serial.println("[DEBUG] Large time difference detected - using shortest path calculation");
-        
-        // Large movement - use shortest path calculation
-        long currentPosition = _currentClockTime % SECONDS_IN_12_HOURS;
-        long targetPosition = currentUTC % SECONDS_IN_12_HOURS;
-        long distance = targetPosition - currentPosition;
-        
-        Serial.print("[DEBUG] Current position in cycle: "); Serial.println(currentPosition);
-        Serial.print("[DEBUG] Target position in cycle: "); Serial.println(targetPosition);
-        Serial.print("[DEBUG] Raw distance: "); Serial.println(distance);
-        
-        // Handle 12-hour cycle wrap-around for shortest path
-        if (distance > SECONDS_IN_12_HOURS / 2) {
-            distance -= SECONDS_IN_12_HOURS;
-        } else if (distance <= -SECONDS_IN_12_HOURS / 2) {
-            distance += SECONDS_IN_12_HOURS;
+    if (_homingPhase != HOMING_IDLE) {
+        // Finding the home edge - time keeping resumes once the hands are referenced to it
+        _runHoming(currentTime);
+    } else if (_planner.isActive()) {
+        // Catch-up move in progress - keep the step queue topped up
+        _feedCatchUp();
+    } else if (_stepEngine.isWaiting()) {
+        // The next step is waiting for its deadline. Take it back if a DST move has to go
+        // first or the RTC has been set off the plan: back (the step would no longer be due
+        // within the lookahead) or forwards (more is due than the one waiting step).
+        if (_dstJumpRemaining != 0 || _handPosition.stepsDue(currentTime) > 0 ||
+            _handPosition.stepsDue(currentTime + STEP_LOOKAHEAD_SECONDS) < 0) {
+            _cancelScheduledSteps();
+        }
+    } else if (!_stepEngine.isRunning()) {
+        // Hands are at rest: back to fine steps if a catch-up move just finished
+        if (_activeMode != MicrostepMode) {
+            _setMicrostepping(MicrostepMode);
         }
         
-        Serial.print("[DEBUG] Shortest path distance: "); Serial.println(distance);
-        
-        long stepsNeeded = distance / _secondsPerStep;
-        Serial.print("[DEBUG] Steps needed (shortest path): "); Serial.println(stepsNeeded);
+        if (_dstJumpRemaining != 0) {
+            // DST change reached - the planned hour move runs before anything else
+            _runDstJump();
+        } else {
+            // Work out where the hands need to be
+            time_t currentClockTime = _handPosition.seconds();
+            long timeDiff = currentTime - currentClockTime;
         
-        if (stepsNeeded != 0) {
-            // DETAILED DEBUGGING FOR ANTICLOCKWISE MOVEMENTS
-            if (stepsNeeded < 0) {
-                Serial.println("*** ANTICLOCKWISE MOVEMENT DETECTED (Large Time Diff) ***");
-                Serial.print("Net Movement: "); Serial.print(stepsNeeded); Serial.println(" steps");
-                Serial.print("Distance in seconds: "); Serial.println(distance);
-                Serial.print("Current Clock Time: "); Serial.print(_currentClockTime);
-                Serial.print(" ("); Serial.print(formatTime(_currentClockTime)); Serial.println(")");
-                Serial.print("UTC Real Time: "); Serial.print(currentUTC);
-                Serial.print(" ("); Serial.print(formatTime(currentUTC)); Serial.println(")");
-                Serial.print("Time Difference: "); Serial.print(timeDiff); Serial.println(" seconds");
-                Serial.println("*** END ANTICLOCKWISE DEBUG ***");
-            }
+            // If time difference is large (> 6 hours), use shortest path logic
+            if (abs(timeDiff) > SECONDS_IN_12_HOURS / 2) {
+                Serial.println("[DEBUG] Large time difference detected - using shortest path calculation");
             
-            _myStepper.move(_myStepper.distanceToGo() + stepsNeeded);
-            _currentClockTime = currentUTC; // Set to exact target time
-        }
-    } else {
-        // Normal movement - use standard logic
-        if (abs(timeDiff) >= _secondsPerStep) {
-            long stepsNeeded = timeDiff / _secondsPerStep;
+                long currentPosition = currentClockTime % SECONDS_IN_12_HOURS;
+                long targetPosition = currentTime % SECONDS_IN_12_HOURS;
+                long distance = targetPosition - currentPosition;
             
-            // Limit to reasonable movement (sanity check)
-            if (abs(stepsNeeded) > 100) {
-                Serial.print("[WARNING] Excessive steps detected: "); Serial.print(stepsNeeded);
-                Serial.print(" (TimeDiff: "); Serial.print(timeDiff);
-                Serial.println(") - Limiting to reasonable value");
-                stepsNeeded = (stepsNeeded > 0) ? 100 : -100;
-            }
+                // Handle 12-hour cycle wrap-around for shortest path
+                if (distance > SECONDS_IN_12_HOURS / 2) {
+                    distance -= SECONDS_IN_12_HOURS;
+                } else if (distance <= -SECONDS_IN_12_HOURS / 2) {
+                    distance += SECONDS_IN_12_HOURS;
+                }
+            
+                Serial.print("[DEBUG] Shortest path distance: "); Serial.println(distance);
             
-            if (stepsNeeded != 0) {
-                // DETAILED DEBUGGING FOR ANTICLOCKWISE MOVEMENTS
+                // The dial looks identical one cycle later, so move the represented time by
+                // whole cycles until it is within `distance` of real time (hands don't move)
+                _handPosition.shiftSeconds(timeDiff - distance);
+                timeDiff = distance;
+            }
+        
+            long stepsNeeded = _handPosition.stepsDue(currentTime);
+        
+            if (_holdForRealTime(stepsNeeded, timeDiff)) {
+                // Slightly ahead - let real time catch up with the stationary hands
+            } else if (abs(stepsNeeded) >= CATCHUP_MIN_STEPS * CATCHUP_STEP_MICROSTEPS) {
+                // Too far for plain steps - plan a time-optimal move onto the moving target
+                if (_alignForCatchUp(stepsNeeded) != 0) {
+                    // Fine-stepping onto the catch-up grid first; the move starts once there
+                } else {
+                    if (stepsNeeded < 0) {
+                        Serial.print("[DEBUG] Anticlockwise catch-up - Clock: "); Serial.print(formatTime(currentClockTime));
+                        Serial.print(", Local: "); Serial.print(formatTime(currentTime));
+                        Serial.print(", TimeDiff: "); Serial.println(timeDiff);
+                    }
+                    _startCatchUp(currentTime, stepsNeeded);
+                }
+            } else if (stepsNeeded != 0 && !(stepsNeeded == 1 && _sweepTrainRunning())) {
                 if (stepsNeeded < 0) {
-                    Serial.println("*** ANTICLOCKWISE MOVEMENT DETECTED (Normal) ***");
-                    Serial.print("Net Movement: "); Serial.print(stepsNeeded); Serial.println(" steps");
-                    Serial.print("Time Difference: "); Serial.print(timeDiff); Serial.println(" seconds");
-                    Serial.print("Current Clock Time: "); Serial.print(_currentClockTime);
-                    Serial.print(" ("); Serial.print(formatTime(_currentClockTime)); Serial.println(")");
-                    Serial.print("UTC Real Time: "); Serial.print(currentUTC);
-                    Serial.print(" ("); Serial.print(formatTime(currentUTC)); Serial.println(")");
-                    Serial.println("*** END ANTICLOCKWISE DEBUG ***");
-                } else if (abs(stepsNeeded) > 1) { 
-                    Serial.print("[DEBUG] Normal movement - StepsNeeded: "); Serial.print(stepsNeeded);
+                    Serial.print("[DEBUG] Anticlockwise correction - StepsNeeded: "); Serial.print(stepsNeeded);
                     Serial.print(", TimeDiff: "); Serial.println(timeDiff);
                 }
-                
-                _myStepper.move(_myStepper.distanceToGo() + stepsNeeded); 
-                _currentClockTime += stepsNeeded * _secondsPerStep;
+                if (_queueSteps(stepsNeeded)) {
+                    _handPosition.commit(stepsNeeded);
+                    _journal.markChanged(stepsNeeded < 0); // Routine ticking is coalesced
+                }
+            } else if (_stepScheduling && (haveSecondTick || _sweepTrainRunning())) {
+                // On time (or a sweep less than a step behind) - hand the next step to the
+                // timer ahead of its deadline
+                _scheduleNextStep(currentTime, secondTick, haveSecondTick);
             }
         }
     }
 
-    // Handle stepper driver enable/disable and LED
-    if (_myStepper.distanceToGo() == 0) {
-        _activityLED.off();
-        if (millis() - _lastStepperMoveTime > _stepperIdleTimeout) {
-            _disableStepperDriver(); 
-        }
-    } else {
+    // Driver power by policy (see setDriverPowerConfig()) and the activity LED. For the driver a
+    // pulse that went out since the last update counts too: single steps are over between two updates.
+    bool moving = _stepEngine.isRunning() && !_stepEngine.isWaiting();
+    long enginePosition = _stepEngine.currentPosition();
+    bool pulsing = moving || enginePosition != _polledPosition;
+    _polledPosition = enginePosition;
+    long msToNextStep = pulsing ? 0 : _msToNextStep(currentTime, secondTick, haveSecondTick);
+    if (_driverPower.wantEnabled(millis(), pulsing, msToNextStep)) {
         _enableStepperDriver();
+    } else {
+        _disableStepperDriver();
+    }
+    if (moving) {
         _activityLED.on();
-        _lastStepperMoveTime = millis();
+    } else {
+        _activityLED.off();
     }
+    
+    _updateJournal();
+    
+    if (haveSecondTick && _homingPhase == HOMING_IDLE) _sampleHandError(currentTime, secondTick);
+    if (_handError.rotate(millis())) {
+        char summary[96];
+        HandErrorMonitor::formatSummary(_handError.lastWindow(), summary, sizeof(summary));
+        Serial.print("[STATS] "); Serial.println(summary);
+        DriverPowerPolicy::formatSummary(_driverPower.stats(millis()), summary, sizeof(summary));
+        Serial.print("[STATS] "); Serial.println(summary);
+    }
+}
+
+// Fine steps committed to the hand position that have not reached the motor yet:
+// queued or waiting in the step engine, or still to come from the catch-up planner
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_unissuedSteps() const {
+    long unissued = _stepEngine.distanceToGo() + _planner.stepsRemaining() * _planner.direction();
+    return (_activeMode != MicrostepMode) ? unissued * CATCHUP_STEP_MICROSTEPS : unissued;
 }
 
-void MechanicalClock::setMicrosteppingMode(uint8_t mode) {
-    _setMicrostepping(mode);
+// One hand error sample: where the hands physically are against the RTC, to the step timer
+// tick. Needs the second reference for the fraction of the current RTC second.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_sampleHandError(time_t currentTime,
+                                                                                                   uint32_t secondTick) {
+    if (_handPosition.seconds() == 0) return;
+    
+    HandPosition hands = _handPosition;
+    hands.commit(-_unissuedSteps());
+    long seconds = (long)(hands.seconds() - currentTime);
+    if (seconds > SECONDS_IN_12_HOURS) seconds = SECONDS_IN_12_HOURS; // Keeps the ms in range
+    if (seconds < -SECONDS_IN_12_HOURS) seconds = -SECONDS_IN_12_HOURS;
+    
+    uint32_t intoSecondMs = (_stepEngine.tickCount() - secondTick) / (STEP_ENGINE_TICKS_PER_SECOND / 1000);
+    long fractionMs = (long)hands.fractionIn(1000);
+    _handError.addSample(seconds * 1000L + fractionMs - (long)intoSecondMs);
 }
 
+// Hands the steps to the pulse engine. Returns false (nothing queued) if the queue is full;
+// the caller then keeps the steps due and retries on the next update.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_queueSteps(long steps) {
+    _enableStepperDriver(); // Driver must be enabled before the ISR emits the first pulse
+    if (!_stepEngine.queueSteps(steps, STEPPER_STEP_INTERVAL_US)) return false;
+    _advanceGridOffset(steps);
+    _handError.noteMove(steps);
+    return true;
+}
 
+// Tracks where fine steps leave the hands relative to the coarse catch-up grid
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_advanceGridOffset(long steps) {
+    long offset = ((long)_gridOffset + steps) % CATCHUP_STEP_MICROSTEPS;
+    _gridOffset = (uint8_t)((offset < 0) ? offset + CATCHUP_STEP_MICROSTEPS : offset);
+}
+
+// RTC 1 Hz interrupt: the step timer tick each RTC second begins on
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_rtcSecondIsr() {
+    _rtcSecondTick = StepPulseEngine::activeTickCount();
+    _rtcSecondCount = _rtcSecondCount + 1;
+}
+
+// Reads the RTC together with the tick its current second began on. Returns false if that
+// tick is not known: no boundary seen yet, one was missed, or the RTC was set since the last
+// boundary (setting it restarts the second, so the old boundary no longer lines up).
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_readSecondReference(time_t& currentUTC,
+                                                                                                       uint32_t& secondTick) {
+    uint32_t count;
+    do { // A boundary between the two reads would pair a tick with the wrong second
+        count = _rtcSecondCount;
+        secondTick = _rtcSecondTick;
+        currentUTC = getCurrentUTC();
+    } while (count != _rtcSecondCount);
+    
+    // Seconds counted and seconds the RTC moved on disagree when something set the RTC
+    if (currentUTC - _refUTC != (time_t)(count - _refSecondCount)) {
+        _rtcSetAtCount = count;
+    }
+    _refSecondCount = count;
+    _refUTC = currentUTC;
+    
+    return count != _rtcSetAtCount && _stepEngine.tickCount() - secondTick < STEP_ENGINE_TICKS_PER_SECOND;
+}
+
+// Queues the step after the current hand position for the tick it is due on, once that is
+// within STEP_LOOKAHEAD_SECONDS. The due instant is exact: whole seconds from the current
+// RTC second plus the fraction of a second in the hand position model.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_scheduleNextStep(time_t currentTime,
+                                                                                                    uint32_t secondTick,
+                                                                                                    bool haveSecondTick) {
+    if (_handPosition.stepsDue(currentTime + STEP_LOOKAHEAD_SECONDS) <= 0) return;
+    
+    uint32_t deadline = haveSecondTick ? (uint32_t)_nextStepTick(currentTime, secondTick) : 0;
+    if (_sweepMode) deadline = _sweepStepTick(deadline, haveSecondTick);
+    
+    // The driver power policy enables the driver ahead of the deadline; until it does, the
+    // step engine holds the pulse
+    if (!_stepEngine.queueStepsAt(1, deadline, STEPPER_STEP_INTERVAL_US)) return;
+    _scheduledTick = deadline;
+    if (_sweepMode) {
+        _sweepLocked = true;
+        _sweepTick = deadline;
+        _sweepPosition = _stepEngine.targetPosition();
+    }
+    _advanceGridOffset(1);
+    _handError.noteMove(1);
+    _handPosition.commit(1);
+    _journal.markChanged();
+}
+
+// Step timer tick the next time-keeping step is due on, from the tick the current RTC second
+// began on. Signed and 64-bit: it is in the past when the hands are behind, and far off while
+// they hold for real time. The offset from that tick is worked out in 32 bits (called on every
+// update); more than STEP_TICK_RANGE_SECONDS away, the step is that far away as far as anyone
+// waiting for it is concerned.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+int64_t MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_nextStepTick(time_t currentTime,
+                                                                                                  uint32_t secondTick) const {
+    HandPosition next = _handPosition;
+    next.commit(1);
+    long seconds = (long)(next.seconds() - currentTime);
+    if (seconds > STEP_TICK_RANGE_SECONDS) seconds = STEP_TICK_RANGE_SECONDS;
+    if (seconds < -STEP_TICK_RANGE_SECONDS) seconds = -STEP_TICK_RANGE_SECONDS;
+    int32_t ticks = (int32_t)seconds * (int32_t)STEP_ENGINE_TICKS_PER_SECOND +
+                    (int32_t)next.fractionIn(STEP_ENGINE_TICKS_PER_SECOND);
+    return (int64_t)secondTick + ticks;
+}
+
+// The previous step of the sweep train went out and nothing has moved the hands since
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_sweepTrainRunning() const {
+    return _sweepMode && _sweepLocked && _stepEngine.currentPosition() == _sweepPosition;
+}
+
+// Sweep mode deadline for the step due on `dueTick`: one nominal step interval after the
+// previous step of the train, changed by a share of the phase error (dueTick against that
+// nominal tick) - at least one tick, at most SWEEP_MAX_SLEW_PPM of the interval. Without a
+// due tick (the RTC second reference is missing for a moment after the RTC is set) the train
+// runs on at its last rate. It starts, or starts again, on the exact due tick when there is no
+// previous step to follow (another move came between) or the error is a whole step or more.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+uint32_t MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_sweepStepTick(uint32_t dueTick,
+                                                                                                     bool haveDueTick) {
+    uint64_t cycleTicks = (uint64_t)_handPosition.secondsPerCycle() * STEP_ENGINE_TICKS_PER_SECOND;
+    long interval = (long)((cycleTicks + _handPosition.stepsPerCycle() / 2) / _handPosition.stepsPerCycle());
+    
+    if (!_sweepTrainRunning()) {
+        _sweepSlewTicks = 0;
+        return dueTick;
+    }
+    uint32_t nominalTick = _sweepTick + (uint32_t)interval;
+    if (!haveDueTick) return nominalTick + (uint32_t)_sweepSlewTicks;
+    
+    long error = (long)(int32_t)(dueTick - nominalTick); // Positive: the train runs early
+    if (labs(error) >= interval) {
+        _sweepSlewTicks = 0;
+        return dueTick;
+    }
+    
+    long maxSlew = (long)((int64_t)interval * SWEEP_MAX_SLEW_PPM / 1000000L);
+    if (maxSlew < 1) maxSlew = 1;
+    _sweepSlewTicks = error / SWEEP_PHASE_STEPS;
+    if (_sweepSlewTicks == 0 && error != 0) _sweepSlewTicks = (error > 0) ? 1 : -1; // The last few ticks
+    if (_sweepSlewTicks > maxSlew) _sweepSlewTicks = maxSlew;
+    if (_sweepSlewTicks < -maxSlew) _sweepSlewTicks = -maxSlew;
+    return nominalTick + (uint32_t)_sweepSlewTicks;
+}
+
+// Time until the motor next has to step: the scheduled step's deadline if one is waiting, else
+// when the next time-keeping step falls due. -1 when not known (no second reference yet).
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_msToNextStep(time_t currentTime,
+                                                                                               uint32_t secondTick,
+                                                                                               bool haveSecondTick) const {
+    int64_t ticks;
+    if (_stepEngine.isWaiting()) {
+        ticks = (int32_t)(_scheduledTick - _stepEngine.tickCount());
+    } else if (haveSecondTick && _handPosition.seconds() != 0 && !_planner.isActive() && _dstJumpRemaining == 0 &&
+               _homingPhase == HOMING_IDLE) {
+        ticks = _nextStepTick(currentTime, secondTick) - (int64_t)_stepEngine.tickCount();
+    } else {
+        return -1;
+    }
+    if (ticks <= 0) return 0;
+    int64_t ms = ticks / (STEP_ENGINE_TICKS_PER_SECOND / 1000);
+    return (ms > 86400000LL) ? 86400000L : (long)ms;
+}
+
+// Takes back scheduled steps that have not fired yet
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_cancelScheduledSteps() {
+    long target = _stepEngine.targetPosition();
+    _stepEngine.clear();
+    long unissued = target - _stepEngine.currentPosition(); // Exact once the queue is stopped
+    _advanceGridOffset(-unissued);
+    _handPosition.commit(-unissued);
+    _sweepLocked = false;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setStepScheduling(bool enabled) {
+    _stepScheduling = enabled;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setSweepMode(bool enabled) {
+    _sweepMode = enabled;
+    _sweepLocked = false;
+    _sweepSlewTicks = 0;
+}
+
+// Coarse steps only land where they should from a position on the coarse step grid.
+// Queues the fine steps (towards the target) that reach the grid and returns them;
+// returns 0 if already on it. Called with the step queue empty.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_alignForCatchUp(long stepsNeeded) {
+    if (_gridOffset == 0) return 0;
+    
+    long align = (stepsNeeded > 0) ? (long)(CATCHUP_STEP_MICROSTEPS - _gridOffset) : -(long)_gridOffset;
+    if (!_queueSteps(align)) return 0;
+    _handPosition.commit(align);
+    _journal.markChanged(true);
+    return align;
+}
+
+// Plans the shortest move that meets real time, given that real time keeps advancing
+// while the hands travel. The move runs in coarse CatchUpMode steps; the hands are
+// committed to the meeting point up front and any fine remainder follows as plain steps.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_startCatchUp(time_t currentTime, long stepsBehind) {
+    float stepRate = (float)_handPosition.stepsPerCycle() / (float)_handPosition.secondsPerCycle() / CATCHUP_STEP_MICROSTEPS;
+    float interceptSeconds = _planner.interceptSeconds(stepsBehind / CATCHUP_STEP_MICROSTEPS, stepRate);
+    
+    // Meet real time at the next whole second after the earliest possible intercept
+    time_t meetingTime = currentTime + (time_t)ceilf(interceptSeconds);
+    _startCoarseMove(_handPosition.stepsDue(meetingTime) / CATCHUP_STEP_MICROSTEPS);
+}
+
+// Runs `steps` CatchUpMode steps (from a position on the coarse grid) and commits them to the hands
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_startCoarseMove(long steps) {
+    _setMicrostepping(CatchUpMode);
+    _planner.start(steps);
+    _handError.noteMove(steps * CATCHUP_STEP_MICROSTEPS);
+    _handPosition.commit(steps * CATCHUP_STEP_MICROSTEPS);
+    _journal.markChanged(true); // Journaled once the move has finished
+    _catchUpStartTime = millis();
+    
+    // The same pulse rate limits in fine steps would need CATCHUP_STEP_MICROSTEPS times the pulses
+    float fineMs = _planner.moveSeconds(steps * CATCHUP_STEP_MICROSTEPS) * 1000.0f;
+    if (fineMs > (float)_planner.durationMs()) {
+        _catchUpTimeSavedMs += (unsigned long)(fineMs + 0.5f) - _planner.durationMs();
+    }
+    
+    Serial.print("[DEBUG] Catch-up move: "); Serial.print(steps);
+    Serial.print(" steps, ETA "); Serial.print(_planner.durationMs());
+    Serial.println(" ms");
+    
+    _feedCatchUp();
+}
+
+// Moves the next runs of the active catch-up profile into free step queue slots
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_feedCatchUp() {
+    _enableStepperDriver();
+    
+    uint16_t count;
+    uint32_t gapUs;
+    while (_stepEngine.freeSlots() > 0 && _planner.nextSegment(count, gapUs)) {
+        _stepEngine.queueSteps((long)count * _planner.direction(), gapUs);
+    }
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setHomeSensor(bool fitted, long homeDialSeconds) {
+    _homeSensorFitted = fitted;
+    _homeDialSeconds = homeDialSeconds;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::startHoming() {
+    if (!_homeSensorFitted || _homingPhase != HOMING_IDLE) return;
+    
+    _homingPhase = HOMING_PENDING;
+    _homingTravel = 0;
+    _homingStartMs = millis();
+    Serial.println("Homing: looking for the home sensor edge");
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_homeSensorActive() {
+    return digitalRead(HOME_SENSOR_PIN) == HOME_SENSOR_ACTIVE_LEVEL;
+}
+
+// Homing state machine, one step per update. The sensor is active over the half of the dial
+// before home, so its level gives the short way to the edge: forwards while active, backwards
+// while not. Every phase ends with the hands at rest; the final creep always runs forwards,
+// so the edge is latched from the same side (and with the backlash taken up) every time.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_runHoming(time_t currentTime) {
+    switch (_homingPhase) {
+        case HOMING_PENDING: {
+            if (_planner.isActive()) { // A catch-up move finishes first
+                _feedCatchUp();
+                return;
+            }
+            if (_stepEngine.isWaiting()) _cancelScheduledSteps();
+            if (_stepEngine.isRunning()) return;
+            if (_activeMode != MicrostepMode) _setMicrostepping(MicrostepMode);
+            
+            // The seek runs in coarse steps, so onto their grid first (see _alignForCatchUp())
+            if (_gridOffset != 0) {
+                long align = (long)(CATCHUP_STEP_MICROSTEPS - _gridOffset);
+                if (_queueSteps(align)) _homingTravel += align;
+                return;
+            }
+            
+            uint32_t dialSteps = (uint32_t)((uint64_t)_stepsPerDialCycle * SECONDS_IN_12_HOURS / _secondsPerDialCycle) /
+                                 CATCHUP_STEP_MICROSTEPS;
+            _homingDirection = _homeSensorActive() ? 1 : -1;
+            _stepEngine.watchInput(_homeSensorActive, false);
+            _homingPhase = HOMING_SEEK;
+            _startHomingMove(_homingDirection * (long)((uint64_t)dialSteps * HOMING_SEEK_SPAN_PERCENT / 100));
+            return;
+        }
+        
+        case HOMING_SEEK: {
+            if (_stepEngine.isWatching() && _stepEngine.inputLatched()) {
+                // Past the edge: drop the queued pulses and ramp down from the speed reached
+                _stepEngine.stopWatching();
+                _stepEngine.clear();
+                _planner.stop(labs(_stepEngine.currentPosition() - _homingMark));
+            }
+            if (_planner.isActive()) {
+                _feedCatchUp();
+                return;
+            }
+            if (_stepEngine.isRunning()) return;
+            
+            _homingTravel += _homingPhaseTravel();
+            bool found = _stepEngine.pollInput();
+            _stepEngine.stopWatching();
+            if (!found) {
+                _failHoming("no sensor edge within the seek span");
+                return;
+            }
+            
+            // Back to HOMING_BACKOFF_STEPS short of the last coarse position with the sensor active
+            long lastActive = _stepEngine.latchedPosition() - ((_homingDirection > 0) ? 1 : 0);
+            _homingPhase = HOMING_APPROACH;
+            _startHomingMove(lastActive - HOMING_BACKOFF_STEPS - _stepEngine.currentPosition());
+            return;
+        }
+        
+        case HOMING_APPROACH: {
+            if (_planner.isActive()) {
+                _feedCatchUp();
+                return;
+            }
+            if (_stepEngine.isRunning()) return;
+            
+            _homingTravel += _homingPhaseTravel();
+            if (!_homeSensorActive()) {
+                _failHoming("sensor not active short of the edge");
+                return;
+            }
+            
+            // Creep forwards onto the edge; the step engine stops on the pulse that reaches it
+            _setMicrostepping(MicrostepMode);
+            _homingMark = _stepEngine.currentPosition();
+            _stepEngine.watchInput(_homeSensorActive, true);
+            _enableStepperDriver();
+            _stepEngine.queueSteps((long)(HOMING_BACKOFF_STEPS + 2) * CATCHUP_STEP_MICROSTEPS, HOMING_CREEP_INTERVAL_US);
+            _homingPhase = HOMING_CREEP;
+            return;
+        }
+        
+        case HOMING_CREEP: {
+            if (!_stepEngine.inputLatched() && _stepEngine.isRunning()) return;
+            
+            bool found = _stepEngine.pollInput();
+            _stepEngine.stopWatching();
+            _stepEngine.clear(); // Whatever the ISR dropped at the edge
+            long crept = _homingPhaseTravel();
+            _advanceGridOffset(crept);
+            _homingTravel += crept;
+            if (!found) {
+                _failHoming("edge lost while creeping");
+                return;
+            }
+            _finishHoming(currentTime);
+            return;
+        }
+        
+        default:
+            return;
+    }
+}
+
+// Starts a coarse homing move of `steps` (from the coarse grid). Unlike _startCoarseMove() the
+// hand position is left alone: homing replaces it.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_startHomingMove(long steps) {
+    _setMicrostepping(CatchUpMode);
+    _homingMark = _stepEngine.currentPosition();
+    _planner.start(steps);
+    _feedCatchUp();
+}
+
+// Fine steps moved since the current phase started
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_homingPhaseTravel() const {
+    long pulses = _stepEngine.currentPosition() - _homingMark;
+    return (_activeMode != MicrostepMode) ? pulses * CATCHUP_STEP_MICROSTEPS : pulses;
+}
+
+// The hands are on the home edge: they show the latest time at or before now with the home
+// dial position. The next update moves them on to real time.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_finishHoming(time_t currentTime) {
+    long sinceHome = (long)((currentTime - _homeDialSeconds) % SECONDS_IN_12_HOURS);
+    if (sinceHome < 0) sinceHome += SECONDS_IN_12_HOURS;
+    _handPosition.anchor(currentTime - sinceHome);
+    _holdDeficitSteps = 0;
+    _dstJumpRemaining = 0; // Included in the move to real time
+    _journal.markChanged(true);
+    
+    _lastHomingMs = millis() - _homingStartMs;
+    _homingPhase = HOMING_IDLE;
+    Serial.print("Homing: edge found in "); Serial.print(_lastHomingMs);
+    Serial.print(" ms, "); Serial.print(_homingTravel); Serial.println(" steps travelled");
+}
+
+// No usable edge: the hands carry on from where they were believed to be before homing, moved
+// by the steps homing made (or, with no belief at all, from the first-sync anchor)
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_failHoming(const char* reason) {
+    _stepEngine.stopWatching();
+    _planner.cancel();
+    if (_handPosition.seconds() != 0) {
+        _handPosition.commit(_homingTravel);
+        _journal.markChanged(true);
+    }
+    _homingFailures++;
+    _homingPhase = HOMING_IDLE;
+    Serial.print("Homing failed: "); Serial.println(reason);
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setTimeZone(int timeZoneOffsetHours, bool useDST) {
+    if (timeZoneOffsetHours == _timeZoneOffsetHours && useDST == _useDST) return;
+    
+    _timeZoneOffsetHours = timeZoneOffsetHours;
+    _useDST = useDST;
+    _offsetStale = true;   // The hands move to the new local time at the next update
+    _dstJumpRemaining = 0; // ...by a normal correction
+}
+
+// Works out the UTC offset in effect and plans the next DST change: its instant and the
+// hand move it needs. A change reached on schedule starts that move; any other offset
+// change (new time zone, RTC set across a change) is left to the normal correction.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_updateUtcOffset(time_t currentUTC) {
+    long offset = utcOffsetSeconds(currentUTC, _timeZoneOffsetHours, _useDST);
+    
+    bool onSchedule = !_offsetStale && _offsetChangeUTC != 0 && currentUTC >= _offsetChangeUTC &&
+                      currentUTC - _offsetChangeUTC <= DST_JUMP_MAX_LATE_SECONDS && offset == _plannedOffsetSeconds;
+    if (onSchedule && _handPosition.seconds() != 0) {
+        _dstJumpRemaining = _plannedJumpSteps;
+        _dstJumps++;
+        Serial.print("[DEBUG] DST change - planned move of "); Serial.print(_plannedJumpSteps);
+        Serial.println(" steps");
+    }
+    
+    _utcOffsetSeconds = offset;
+    _offsetFromUTC = currentUTC;
+    _offsetStale = false;
+    _offsetChangeUTC = nextUtcOffsetChange(currentUTC, _timeZoneOffsetHours, _useDST, _plannedOffsetSeconds);
+    _plannedJumpSteps = (long)((int64_t)(_plannedOffsetSeconds - offset) * (int64_t)_stepsPerDialCycle /
+                               (int64_t)_secondsPerDialCycle);
+}
+
+// Makes the planned DST move: onto the coarse grid in the direction of the jump, then the
+// whole coarse steps of what is left. The fine remainder (and the time the move took)
+// follows as plain steps, always forwards.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_runDstJump() {
+    long aligned = _alignForCatchUp(_dstJumpRemaining);
+    if (aligned != 0) {
+        _dstJumpRemaining -= aligned; // The coarse move starts once on the grid
+        return;
+    }
+    
+    long remaining = _dstJumpRemaining;
+    long steps = remaining / CATCHUP_STEP_MICROSTEPS;
+    if (remaining < 0 && remaining % CATCHUP_STEP_MICROSTEPS != 0) steps--; // Round down, so the rest is forwards
+    _dstJumpRemaining = 0;
+    if (steps != 0) {
+        _startCoarseMove(steps);
+    }
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setMotionLimits(float maxSpeed, float acceleration) {
+    _planner.setLimits(maxSpeed, acceleration);
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+unsigned long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::getCatchUpEtaMs() const {
+    if (_planner.totalSteps() == 0 || !_stepEngine.isRunning() || _homingPhase != HOMING_IDLE) return 0;
+    unsigned long elapsed = millis() - _catchUpStartTime;
+    return (elapsed < _planner.durationMs()) ? _planner.durationMs() - elapsed : 0;
+}
+
+// Returns true while the hands should stay put because they are ahead of real time by no more
+// than the hold threshold. Reversing would cost the steps back, the same steps forward again
+// later, backlash and driver-on time; waiting costs nothing.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_holdForRealTime(long stepsNeeded, long timeDiff) {
+    if (stepsNeeded >= 0 || _holdThresholdSeconds == 0 || -timeDiff > (long)_holdThresholdSeconds) {
+        _holdDeficitSteps = 0; // Not holding (caught up, or too far ahead to wait)
+        return false;
+    }
+    
+    long reverseSteps = -stepsNeeded;
+    if (_holdDeficitSteps == 0) {
+        _holdReversalsSaved++;
+        Serial.print("[DEBUG] Holding hands - "); Serial.print(-timeDiff);
+        Serial.println(" s ahead of real time");
+    }
+    if (reverseSteps > _holdDeficitSteps) {
+        // Each avoided reverse step is also a forward step that never has to be repeated
+        _holdStepsSaved += 2 * (unsigned long)(reverseSteps - _holdDeficitSteps);
+        _holdDeficitSteps = reverseSteps;
+    }
+    return true;
+}
+
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::setHoldThreshold(unsigned long seconds) {
+    _holdThresholdSeconds = seconds;
+}
+
+// Driver-on time avoided: the pulse train of the saved steps plus the settling time after each reversal
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+unsigned long MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::getHoldEnergySavedMj() const {
+    unsigned long onTimeMs = _holdStepsSaved * (STEPPER_STEP_INTERVAL_US / 1000UL) +
+                             _holdReversalsSaved * _driverPower.getConfig().postDisableMs;
+    return (unsigned long)((uint64_t)onTimeMs * STEPPER_DRIVE_POWER_MW / 1000ULL);
+}
+
+// Loads the newest journaled hand position. The represented time is anchored one dial cycle
+// after the epoch: any time with the same dial position will do, because the first update
+// moves the hands along the shortest path to real time.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+bool MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_recoverFromJournal() {
+    uint32_t cycleSteps, phase;
+    if (!_journal.begin() || !_journal.recover(cycleSteps, phase)) {
+        Serial.println("No hand position journal found");
+        return false;
+    }
+    if (cycleSteps >= _stepsPerDialCycle || phase >= _handPosition.secondsPerCycle()) {
+        Serial.println("Hand position journal out of range - ignored");
+        return false;
+    }
+    
+    uint64_t units = (uint64_t)cycleSteps * _handPosition.secondsPerCycle() + phase;
+    _handPosition.anchor((time_t)(_secondsPerDialCycle + units / _handPosition.stepsPerCycle()),
+                         (uint32_t)(units % _handPosition.stepsPerCycle()));
+    
+    Serial.print("✓ Hand position from journal: "); Serial.print(cycleSteps);
+    Serial.print(" steps past 12:00 (record "); Serial.print(_journal.getSequence());
+    Serial.println(")");
+    return true;
+}
+
+// Writes the hand position once the hands are at rest and the journal's rate limit allows.
+// A step waiting for its deadline has not moved the hands, so it is left out.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_updateJournal() {
+    bool atRest = !_stepEngine.isRunning() || _stepEngine.isWaiting();
+    if (!atRest || _planner.isActive() || _homingPhase != HOMING_IDLE || !_journal.writeDue()) return;
+    
+    HandPosition hands = _handPosition;
+    hands.commit(-_stepEngine.distanceToGo());
+    uint32_t cycleSteps, phase;
+    _dialPosition(hands, cycleSteps, phase);
+    _journal.write(cycleSteps, phase);
+}
+
+// Dial position of the hands: whole microsteps past 12:00 plus the fraction of a microstep
+// (in 1/stepsPerCycle()-second units of the reduced hand position model)
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+void MechanicalClockT<MicrostepMode, CatchUpMode, StepsPerRev, GearNum, GearDen>::_dialPosition(const HandPosition& hands,
+                                                                                                uint32_t& cycleSteps, uint32_t& phase) const {
+    long dialSeconds = (long)(hands.seconds() % (time_t)_secondsPerDialCycle);
+    if (dialSeconds < 0) dialSeconds += _secondsPerDialCycle;
+    
+    uint64_t units = (uint64_t)dialSeconds * hands.stepsPerCycle() + hands.remainder();
+    cycleSteps = (uint32_t)(units / hands.secondsPerCycle());
+    phase = (uint32_t)(units % hands.secondsPerCycle());
+}
 
- 
\ No newline at end of file
+// Instantiate the configured clock (see the MechanicalClock alias in MechanicalClock.h), and the
+// run-time ratio one too unless that is the configured one (unused code is dropped at link time)
+template class MechanicalClockT<CURRENT_MICROSTEP, CATCHUP_MICROSTEP, BASE_STEPS_PER_REV, GEAR_RATIO_NUM, GEAR_RATIO_DEN>;
+#if GEAR_RATIO_NUM != 0
+template class MechanicalClockT<CURRENT_MICROSTEP, CATCHUP_MICROSTEP, BASE_STEPS_PER_REV, 0, 0>;
+#endif
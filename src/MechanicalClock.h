@@ -20,10 +20,17 @@
 #define MECHANICAL_CLOCK_H
 
 #include "Clock.h"        // Base class
-#include <AccelStepper.h> // For stepper motor control
+#include "StepPulseEngine.h" // Timer-driven STEP/DIR pulse generation
 #include <EEPROM.h>       // For saving/loading initial time
 #include "LED.h"          // Include LED class
+#include "FastPin.h"      // Driver control pins
 #include "Constants.h"    // Centralized constants
+#include "StepAccumulator.h" // Exact fractional hand position model
+#include "MotionPlanner.h"   // Trapezoidal catch-up moves
+#include "HandJournal.h"     // Hand position kept across power cuts
+#include "HandErrorMonitor.h" // Running hand accuracy statistics
+#include "DriverPowerPolicy.h" // When the driver coils are energised
+#include "GearRatio.h"       // Movement gear train, stored in EEPROM
 
 // Microstepping constants
 #define MICROSTEP_FULL 0b000
@@ -32,50 +39,337 @@
 #define MICROSTEP_EIGHTH 0b110
 #define MICROSTEP_SIXTEENTH 0b111
 
-// Current microstepping mode
-#define CURRENT_MICROSTEP MICROSTEP_FULL
+// Microstepping mode for keeping time (fine steps are quiet)
+#define CURRENT_MICROSTEP MICROSTEP_SIXTEENTH
+
+// Microstepping mode for catch-up moves (coarse steps cover the distance sooner)
+#define CATCHUP_MICROSTEP MICROSTEP_FULL
 
 // Base steps per revolution (for full stepping)
 #define BASE_STEPS_PER_REV 200
 
+// Gear train: motor revolutions per 12-hour dial revolution (as a fraction)
+// 200 full steps x 12 revolutions = 2400 steps per dial cycle = 18 seconds per full step.
+// Build with e.g. -DGEAR_RATIO_NUM=7 -DGEAR_RATIO_DEN=3 for another movement, or with both 0
+// to take the ratio from EEPROM at begin() (see setGearRatio()).
+#ifndef GEAR_RATIO_NUM
+#define GEAR_RATIO_NUM 12
+#endif
+#ifndef GEAR_RATIO_DEN
+#define GEAR_RATIO_DEN 1
+#endif
+
+// Ratio a run-time configured clock uses until one is set or found in EEPROM
+#define GEAR_RATIO_DEFAULT_NUM 12
+#define GEAR_RATIO_DEFAULT_DEN 1
+
 // 12-hour cycle in seconds
 #define SECONDS_IN_12_HOURS 43200
 
-class MechanicalClock : public Clock {
-private:
-    AccelStepper _myStepper;
-    LED _activityLED; 
+// Pulse spacing for single time-keeping steps
+#define STEPPER_STEP_INTERVAL_US 20000UL
+
+// Time-keeping steps due within this many seconds are handed to the step engine ahead of
+// time, stamped with the timer tick they are due on (see setStepScheduling())
+#define STEP_LOOKAHEAD_SECONDS 2
+
+// Due ticks of time-keeping steps are worked out at most this far from now, so they stay
+// within 32 bits of timer ticks (a day is 1.7e9)
+#define STEP_TICK_RANGE_SECONDS 86400L
+
+// Sweep mode (see setSweepMode()): phase error against the RTC is worked off over about
+// SWEEP_PHASE_STEPS steps, never changing the step rate by more than SWEEP_MAX_SLEW_PPM
+#define SWEEP_PHASE_STEPS 32
+#define SWEEP_MAX_SLEW_PPM 5000L
+
+// Catch-up motion limits (steps of CATCHUP_MICROSTEP) - see setMotionLimits()
+#define CATCHUP_MAX_SPEED 200.0f      // steps/s
+#define CATCHUP_ACCELERATION 400.0f   // steps/s^2
+#define CATCHUP_MIN_STEPS 3           // Smaller corrections are queued as plain time-keeping steps
+
+// Hands ahead of real time by up to this much wait for it instead of reversing (0 = always reverse)
+#define HOLD_MAX_AHEAD_SECONDS 60
+
+// A DST change seen up to this late (e.g. the loop was blocked) still runs as the planned jump move
+#define DST_JUMP_MAX_LATE_SECONDS 60
+
+// Homing sensor on HOME_SENSOR_PIN: a flag on the hour wheel covering the half of the dial before
+// the home position, so the sensor reads active from 6 hours before home up to home. Whichever
+// half the hands are in, that tells the short way to the edge. Build with -DHOME_SENSOR_FITTED=1
+// (or see setHomeSensor()) to home the hands at every begin().
+#ifndef HOME_SENSOR_FITTED
+#define HOME_SENSOR_FITTED 0
+#endif
+#define HOME_SENSOR_ACTIVE_LEVEL LOW  // Open-collector hall switch, pulled up
+#define HOME_DIAL_SECONDS 0           // Time the hands show at the home edge (0 = 12:00)
+#define HOMING_SEEK_SPAN_PERCENT 60   // Fast seek gives up after this much of a dial revolution
+#define HOMING_BACKOFF_STEPS 2        // Catch-up steps short of the edge the creep starts from (takes up backlash)
+#define HOMING_CREEP_INTERVAL_US 4000UL // Fine step spacing onto the edge
 
-    const int _enablePin;
-    const int _ms1Pin;
-    const int _ms2Pin;
-    const int _ms3Pin;
+// Microstep multiplier for an A4988 MS1..MS3 pin pattern
+constexpr uint8_t microstepMultiplier(uint8_t mode) {
+    return (mode == MICROSTEP_HALF) ? 2 :
+           (mode == MICROSTEP_QUARTER) ? 4 :
+           (mode == MICROSTEP_EIGHTH) ? 8 :
+           (mode == MICROSTEP_SIXTEENTH) ? 16 : 1;
+}
 
-    int _stepsPerRevolution;
-    int _secondsPerStep; 
+// Mechanical clock specialised at compile time on its microstep modes and gear train.
+// The step rate (steps per 12-hour dial cycle) is a constant, so the hot path in
+// updateCurrentTime() folds to constant multiplies and shifts instead of runtime
+// divisions. Member functions are defined in MechanicalClock.cpp and instantiated
+// there for the configured clock below.
+//
+// Time keeping runs in MicrostepMode; catch-up moves switch the driver to the
+// coarser CatchUpMode. The hand position is always kept in MicrostepMode steps and
+// a catch-up step counts as CATCHUP_STEP_MICROSTEPS of them, so switching never
+// loses position. The A4988 only takes coarse steps cleanly from a position on the
+// coarse grid, so a catch-up first fine-steps onto that grid.
+//
+// The dial shows local time (see setTimeZone()). The next DST change is worked out
+// ahead of time, so the hot path only compares against its instant, and the hour
+// jump runs as one planned coarse move as soon as the change is reached.
+//
+// The gear train can be any ratio of whole numbers (GearNum/GearDen motor revolutions
+// per dial revolution); the hand position model steps at exactly that rate, so a ratio
+// that does not divide 43200 s into whole steps loses nothing over any running time.
+// MechanicalClockT<..., 0, 0> takes the ratio at run time instead (setGearRatio(), or
+// the one stored in EEPROM), at the cost of runtime divisions on the hot path.
+//
+// Time-keeping steps are scheduled rather than polled: the RTC's 1 Hz interrupt records
+// the step timer tick on which each RTC second began, and the next step is queued ahead
+// of time for the tick its exact (fractional-second) due instant falls on. The step timer
+// then fires it on time however late loop() gets round to calling updateCurrentTime().
+//
+// With a homing sensor the hands find their absolute position: a fast coarse seek towards
+// the home edge (the short way round), a controlled stop past it, a move back to just short
+// of it and a slow fine-step creep that latches the edge to the microstep. The hand position
+// is then anchored at the home time, so the next update starts the catch-up move to real time.
+template <uint8_t MicrostepMode, uint8_t CatchUpMode, uint16_t StepsPerRev, uint32_t GearNum, uint32_t GearDen>
+class MechanicalClockT : public Clock {
+public:
+    static constexpr uint16_t STEPS_PER_REVOLUTION = StepsPerRev * microstepMultiplier(MicrostepMode);
+    static constexpr uint32_t STEPS_PER_DIAL_CYCLE = (uint32_t)STEPS_PER_REVOLUTION * GearNum;
+    static constexpr uint32_t SECONDS_PER_DIAL_CYCLE = (uint32_t)SECONDS_IN_12_HOURS * GearDen;
+    static constexpr uint8_t CATCHUP_STEP_MICROSTEPS = microstepMultiplier(MicrostepMode) / microstepMultiplier(CatchUpMode);
+
+    typedef typename StepAccumulatorFor<STEPS_PER_DIAL_CYCLE, SECONDS_PER_DIAL_CYCLE>::Type HandPosition;
+
+    static_assert((GearNum == 0) == (GearDen == 0), "Gear ratio is fixed (both terms) or set at run time (both 0)");
+    static_assert(GearNum <= GEAR_RATIO_MAX_TERM && GearDen <= GEAR_RATIO_MAX_TERM, "Gear ratio terms too large");
+    static_assert(microstepMultiplier(CatchUpMode) <= microstepMultiplier(MicrostepMode),
+                  "Catch-up steps must be at least as coarse as time-keeping steps");
+
+private:
+    StepPulseEngine _stepEngine;
+    LED<LED_PIN> _activityLED;
+
+    // Driver control lines, fixed at compile time (Constants.h) and written only when they change
+    FastPin<ENABLE_PIN> _enablePin;
+    FastPin<MS1_PIN> _ms1Pin;
+    FastPin<MS2_PIN> _ms2Pin;
+    FastPin<MS3_PIN> _ms3Pin;
 
-    time_t _currentClockTime; // Unix timestamp the hands represent
+    HandPosition _handPosition; // Exact time the hands represent (seconds + fractional step)
+    GearRatio _gearRatio;         // Gear train in use, in lowest terms
+    uint32_t _stepsPerDialCycle;  // MicrostepMode steps over the dial cycle of the gear train...
+    uint32_t _secondsPerDialCycle; // ...and its length (GearDen 12-hour revolutions)
+    uint8_t _activeMode;        // Microstep pattern currently on MS1..MS3
+    uint8_t _gridOffset;        // Fine steps past the last catch-up grid position (driver translator phase)
     
-    unsigned long _lastStepperMoveTime;
-    const unsigned long _stepperIdleTimeout;
+    MotionPlanner _planner;          // Active catch-up move, fed to the step engine
+    unsigned long _catchUpStartTime; // millis() when the current catch-up move started
+    unsigned long _catchUpTimeSavedMs; // Catch-up time saved by coarse steps over fine ones
     
-
+    DriverPowerPolicy _driverPower; // When the driver is enabled, and for how long it has been
+    uint32_t _scheduledTick;        // Deadline of the waiting time-keeping step
+    long _polledPosition;           // Step engine position at the previous update
+    
+    // Hold-instead-of-reverse correction
+    unsigned long _holdThresholdSeconds;
+    long _holdDeficitSteps;           // Reverse steps avoided in the current hold (0 = not holding)
+    unsigned long _holdStepsSaved;    // Reverse + re-advance steps never issued
+    unsigned long _holdReversalsSaved; // Reverse moves never made
+    
+    HandJournal _journal; // Where the hands physically are, for the next cold boot
+    HandErrorMonitor _handError; // Physical hand position against RTC time, per window
+    
+    // Local time on the dial
+    int _timeZoneOffsetHours;
+    bool _useDST;
+    bool _offsetStale;          // Time zone changed: work the offset out again before using it
+    long _utcOffsetSeconds;     // Local time minus UTC in effect now
+    time_t _offsetFromUTC;      // UTC instant _utcOffsetSeconds was worked out at
+    time_t _offsetChangeUTC;    // Next DST change (0 = none)
+    long _plannedOffsetSeconds; // Offset from _offsetChangeUTC on
+    long _plannedJumpSteps;     // Hand move that the change needs
+    long _dstJumpRemaining;     // Steps of a DST jump still to start (0 = none in progress)
+    unsigned long _dstJumps;    // DST changes run as planned moves
+    
+    // Deadline-scheduled time keeping
+    bool _stepScheduling;       // false = steps go out when an update finds them due (reference mode)
+    uint32_t _refSecondCount;   // RTC second interrupts counted at the previous update...
+    time_t _refUTC;             // ...and the RTC time then, to notice the RTC being set
+    uint32_t _rtcSetAtCount;    // Boundaries up to this count are from before the RTC was last set
+    
+    // Sweep mode: a constant-rate pulse train, phase-locked to the RTC by small rate changes
+    bool _sweepMode;
+    bool _sweepLocked;          // _sweepTick is the deadline of the previous step of the train...
+    long _sweepPosition;        // ...which leaves the step engine here
+    uint32_t _sweepTick;
+    long _sweepSlewTicks;       // Interval change the last sweep step was given
+    
+    // Homing (see startHoming())
+    enum HomingPhase : uint8_t {
+        HOMING_IDLE,
+        HOMING_PENDING,  // Waiting for the hands to come to rest
+        HOMING_SEEK,     // Fast coarse move towards the edge, stopping once past it
+        HOMING_APPROACH, // Coarse move back to HOMING_BACKOFF_STEPS short of the edge
+        HOMING_CREEP     // Fine steps onto the edge
+    };
+    bool _homeSensorFitted;
+    long _homeDialSeconds;
+    HomingPhase _homingPhase;
+    int8_t _homingDirection;       // Seek direction
+    long _homingMark;              // Step engine position the current phase started from
+    long _homingTravel;            // Fine steps the hands have moved since homing started
+    unsigned long _homingStartMs;
+    unsigned long _lastHomingMs;   // Duration of the last successful homing
+    unsigned long _homingFailures;
+    
+    time_t _powerDownUTC; // RTC time saved by the last power-off interrupt (0 = none)
+    
+    static volatile uint32_t _rtcSecondTick;  // Step timer tick at the last RTC second boundary
+    static volatile uint32_t _rtcSecondCount; // RTC second interrupts since boot (0 = none yet)
+    static void _rtcSecondIsr();
 
     void _setMicrostepping(uint8_t mode);
+    bool _queueSteps(long steps);
+    void _advanceGridOffset(long steps);
+    bool _readSecondReference(time_t& currentUTC, uint32_t& secondTick);
+    void _scheduleNextStep(time_t currentTime, uint32_t secondTick, bool haveSecondTick);
+    int64_t _nextStepTick(time_t currentTime, uint32_t secondTick) const;
+    bool _sweepTrainRunning() const;
+    uint32_t _sweepStepTick(uint32_t dueTick, bool haveDueTick);
+    long _msToNextStep(time_t currentTime, uint32_t secondTick, bool haveSecondTick) const;
+    void _cancelScheduledSteps();
+    long _unissuedSteps() const;
+    void _sampleHandError(time_t currentTime, uint32_t secondTick);
+    long _alignForCatchUp(long stepsNeeded);
+    bool _holdForRealTime(long stepsNeeded, long timeDiff);
+    void _startCatchUp(time_t currentTime, long stepsBehind);
+    void _startCoarseMove(long steps);
+    void _updateUtcOffset(time_t currentUTC);
+    void _runDstJump();
+    void _feedCatchUp();
+    void _runHoming(time_t currentTime);
+    void _startHomingMove(long steps);
+    void _finishHoming(time_t currentTime);
+    void _failHoming(const char* reason);
+    long _homingPhaseTravel() const;
+    static bool _homeSensorActive();
     void _enableStepperDriver();
     void _disableStepperDriver();
+    bool _recoverFromJournal();
+    void _updateJournal();
+    void _dialPosition(const HandPosition& hands, uint32_t& cycleSteps, uint32_t& phase) const;
 
 public:
-    MechanicalClock(int stepPin, int dirPin, int enablePin, int ms1Pin, int ms2Pin, int ms3Pin, int ledPin,
-                    RTClock& rtcRef, LCDDisplay& lcdRef);
+    // Enable, MS1..MS3 and LED pins are the ones in Constants.h; STEP and DIR belong to the step engine
+    MechanicalClockT(int stepPin, int dirPin, RTClock& rtcRef, LCDDisplay& lcdRef);
 
     void begin() override;
     void updateCurrentTime() override; // Unified time update method (normal operation + sync events)
     void handlePowerOff() override; // Mechanical-specific power-off handling (stepper driver, LED)
+    
+    // The RTC holds real time: a plausible date, and not before the power-down time begin() found.
+    // The hands can catch up from it at power-up without waiting for NTP.
+    bool isRtcTimeValid() override;
+
+    // Time zone the dial shows: standard offset from UTC in hours, and whether US DST applies.
+    // Call before begin() so power recovery knows what the dial showed; a later change moves the hands.
+    void setTimeZone(int timeZoneOffsetHours, bool useDST) override;
+    long getUtcOffsetSeconds() const { return _utcOffsetSeconds; }
+    time_t getNextDstChangeUTC() const { return _offsetChangeUTC; }
+    unsigned long getDstJumps() const { return _dstJumps; }
 
-    void setMicrosteppingMode(uint8_t mode);
+    // Gear train of the movement (motor revolutions per dial revolution). Call before begin();
+    // begin() replaces it with a valid ratio stored at EEPROM_ADDRESS_GEAR_RATIO. A build with a
+    // fixed ratio accepts only that ratio. Returns false (ratio unchanged) otherwise.
+    bool setGearRatio(const GearRatio& ratio);
+    GearRatio getGearRatio() const { return _gearRatio; }
+    uint32_t getStepsPerDialCycle() const { return _stepsPerDialCycle; }
+    uint32_t getSecondsPerDialCycle() const { return _secondsPerDialCycle; }
 
+    // Speed (steps/s) and acceleration (steps/s^2) limits for catch-up moves
+    void setMotionLimits(float maxSpeed, float acceleration);
+
+    // Time left until the current catch-up move puts the hands on real time (0 when idle)
+    unsigned long getCatchUpEtaMs() const;
+
+    // Total time catch-up moves saved by running in CatchUpMode rather than MicrostepMode
+    unsigned long getCatchUpTimeSavedMs() const { return _catchUpTimeSavedMs; }
+    uint8_t getActiveMicrostepMode() const { return _activeMode; }
+
+    // Largest lead (s) over real time that is absorbed by pausing the hands rather than reversing
+    void setHoldThreshold(unsigned long seconds);
+    unsigned long getHoldThreshold() const { return _holdThresholdSeconds; }
+
+    // What holding has saved so far: motor steps not issued and estimated driver energy (mJ)
+    unsigned long getHoldStepsSaved() const { return _holdStepsSaved; }
+    unsigned long getHoldEnergySavedMj() const;
+
+    // true (default): time-keeping steps fire on their exact due instant, timed from the RTC's
+    // second boundaries. false: each step goes out when an update finds it due.
+    void setStepScheduling(bool enabled);
+    bool getStepScheduling() const { return _stepScheduling; }
+    
+    // Sweep mode (with step scheduling): time-keeping steps go out as one evenly spaced pulse
+    // train, each a nominal step interval after the one before. Phase error against the RTC is
+    // corrected by lengthening or shortening the interval by at most SWEEP_MAX_SLEW_PPM rather
+    // than by moving a step to its exact due tick, so an RTC correction never shows as a jerk
+    // of the hand. Errors of a whole step or more are still corrected the usual way.
+    void setSweepMode(bool enabled);
+    bool getSweepMode() const { return _sweepMode; }
+    long getSweepSlewTicks() const { return _sweepSlewTicks; } // Last interval change (ticks)
+    
+    // Step timer tick and direction of every pulse the motor gets (measurement hook, runs in the ISR)
+    void setPulseObserver(StepPulseEngine::PulseObserver observer) { _stepEngine.setPulseObserver(observer); }
+    
+    // Hand error statistics (ms, physical hands minus RTC time) of the last complete window,
+    // or of the window in progress. A summary line is printed on Serial as each window closes.
+    HandErrorStats getHandErrorStats(bool currentWindow = false) const {
+        return currentWindow ? _handError.currentWindow() : _handError.lastWindow();
+    }
+    
+    // Stepper driver enable policy (pre-enable, post-disable and hold-off timing, power model)
+    void setDriverPowerConfig(const DriverPowerConfig& config) { _driverPower.setConfig(config); }
+    const DriverPowerConfig& getDriverPowerConfig() const { return _driverPower.getConfig(); }
+
+    // Driver-on duty cycle and modeled energy since begin(); also printed with the hourly [STATS]
+    DriverPowerStats getDriverPowerStats() const { return _driverPower.stats(millis()); }
+    
+    // Homing sensor fitted, and the time the hands show at its edge (seconds past 12:00).
+    // Call before begin(): with a sensor begin() homes the hands before they keep time.
+    void setHomeSensor(bool fitted, long homeDialSeconds = HOME_DIAL_SECONDS);
+    bool hasHomeSensor() const { return _homeSensorFitted; }
+
+    // Finds the home edge and re-references the hands to it, then catches up with real time.
+    // If the edge is not found the hands go on from where they were believed to be.
+    void startHoming();
+    bool isHoming() const { return _homingPhase != HOMING_IDLE; }
+    unsigned long getLastHomingMs() const { return _lastHomingMs; }   // Start to edge latched
+    unsigned long getHomingFailures() const { return _homingFailures; }
+    
+    // Hand position records written to the EEPROM journal since begin()
+    unsigned long getJournalWrites() const { return _journal.getWriteCount(); }
 
 };
 
+// The clock this firmware drives
+typedef MechanicalClockT<CURRENT_MICROSTEP, CATCHUP_MICROSTEP, BASE_STEPS_PER_REV, GEAR_RATIO_NUM, GEAR_RATIO_DEN> MechanicalClock;
+
+// The same clock with its gear ratio set at run time
+typedef MechanicalClockT<CURRENT_MICROSTEP, CATCHUP_MICROSTEP, BASE_STEPS_PER_REV, 0, 0> RuntimeRatioMechanicalClock;
+
 #endif // MECHANICAL_CLOCK_H 
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "MotionGroup.h"
+#include "StepAccumulator.h" // stepRatioGcd()
+
+MotionGroup* MotionGroup::_activeGroup = nullptr;
+
+MotionGroup::MotionGroup(uint8_t pulsesPerTick)
+    : _axisCount(0), _pulsesPerTick(pulsesPerTick > 0 ? pulsesPerTick : 1), _nextAxis(0),
+      _ticks(0), _startTick(0), _running(false) {
+}
+
+int8_t MotionGroup::addAxis(StepPulseEngine& engine, uint32_t stepsPerRev, const GearRatio& ratio,
+                            uint32_t handCycleSeconds) {
+    if (_axisCount >= MOTION_GROUP_MAX_AXES || !isValidGearRatio(ratio) || stepsPerRev == 0 || handCycleSeconds == 0) {
+        return -1;
+    }
+
+    GearRatio reduced = reduceGearRatio(ratio);
+    uint32_t steps = stepsPerRev * reduced.motorRevs;
+    uint32_t seconds = handCycleSeconds * reduced.dialRevs;
+    uint32_t divisor = stepRatioGcd(steps, seconds);
+
+    Axis& axis = _axes[_axisCount];
+    axis.engine = &engine;
+    axis.stepsPerCycle = steps / divisor;
+    axis.secondsPerCycle = seconds / divisor;
+    axis.committed = 0;
+    axis.heldTicks = 0;
+    axis.stats = MotionAxisStats{0, 0, 0};
+    return (int8_t)_axisCount++;
+}
+
+bool MotionGroup::begin() {
+    for (uint8_t i = 0; i < _axisCount; i++) {
+        _axes[i].engine->begin(false); // The group ticks them
+    }
+    _activeGroup = this;
+    if (!StepPulseEngine::startStepTimer(_timerInterrupt, _hostTimerCallback)) {
+        Serial.println("MotionGroup: no hardware timer available!");
+        return false;
+    }
+    return true;
+}
+
+void MotionGroup::start(uint32_t delayMs) {
+    stop();
+    _startTick = tickCount() + (uint64_t)delayMs * (STEP_ENGINE_TICKS_PER_SECOND / 1000);
+    for (uint8_t i = 0; i < _axisCount; i++) {
+        _axes[i].committed = 0;
+    }
+    _running = true;
+    update();
+}
+
+void MotionGroup::stop() {
+    _running = false;
+    for (uint8_t i = 0; i < _axisCount; i++) {
+        _axes[i].engine->clear();
+    }
+}
+
+// Whole hand cycles plus the ceiling of the part cycle, so the product stays within 64 bits
+// for any step count (stepsPerCycle x secondsPerCycle x ticks per second is below 2^64)
+uint64_t MotionGroup::dueTick(uint8_t axis, uint64_t step) const {
+    const Axis& a = _axes[axis];
+    uint64_t cycles = step / a.stepsPerCycle;
+    uint64_t part = step % a.stepsPerCycle;
+    uint64_t ticksPerCycle = (uint64_t)a.secondsPerCycle * STEP_ENGINE_TICKS_PER_SECOND;
+    return _startTick + cycles * ticksPerCycle + (part * ticksPerCycle + a.stepsPerCycle - 1) / a.stepsPerCycle;
+}
+
+void MotionGroup::update() {
+    if (!_running) return;
+
+    uint64_t horizon = tickCount() + MOTION_GROUP_LOOKAHEAD_MS * (STEP_ENGINE_TICKS_PER_SECOND / 1000);
+    for (uint8_t i = 0; i < _axisCount; i++) {
+        Axis& axis = _axes[i];
+        while (axis.engine->freeSlots() > 0) {
+            uint64_t due = dueTick(i, axis.committed + 1);
+            if (due > horizon) break;
+            // A late step (due tick already past) goes out as soon as the engine gets to it
+            if (!axis.engine->queueStepsAt(1, (uint32_t)due, MOTION_GROUP_CATCHUP_INTERVAL_US)) break;
+            axis.committed++;
+        }
+    }
+}
+
+void MotionGroup::onTimerTick() {
+    _ticks = _ticks + 1;
+
+    uint8_t budget = _pulsesPerTick;
+    uint8_t index = _nextAxis;
+    for (uint8_t n = 0; n < _axisCount; n++) {
+        Axis& axis = _axes[index];
+        if (axis.engine->onTimerTick(budget > 0)) {
+            if (budget > 0) {
+                budget--;
+                axis.stats.pulses++;
+                if (axis.heldTicks > axis.stats.maxHeldTicks) axis.stats.maxHeldTicks = axis.heldTicks;
+                axis.heldTicks = 0;
+                _nextAxis = (uint8_t)(index + 1 < _axisCount ? index + 1 : 0); // Round robin from here
+            } else {
+                if (axis.heldTicks == 0) axis.stats.heldPulses++;
+                axis.heldTicks++;
+            }
+        }
+        index = (uint8_t)(index + 1 < _axisCount ? index + 1 : 0);
+    }
+}
+
+void MotionGroup::advanceTicks(uint32_t ticks) {
+    while (ticks > 0) {
+        uint32_t quiet = ticks;
+        for (uint8_t i = 0; i < _axisCount; i++) {
+            uint32_t axisQuiet = _axes[i].engine->quietTicks();
+            if (axisQuiet < quiet) quiet = axisQuiet;
+        }
+        if (quiet > 0) {
+            for (uint8_t i = 0; i < _axisCount; i++) {
+                _axes[i].engine->advanceTicks(quiet);
+            }
+            _ticks = _ticks + quiet;
+            ticks -= quiet;
+            continue;
+        }
+        onTimerTick();
+        ticks--;
+    }
+}
+
+uint64_t MotionGroup::tickCount() const {
+    noInterrupts(); // 64 bits take two reads on the UNO R4
+    uint64_t ticks = _ticks;
+    interrupts();
+    return ticks;
+}
+
+MotionAxisStats MotionGroup::axisStats(uint8_t axis) const {
+    noInterrupts();
+    MotionAxisStats stats = _axes[axis].stats;
+    interrupts();
+    return stats;
+}
+
+void MotionGroup::_timerInterrupt() {
+    if (_activeGroup) {
+        _activeGroup->onTimerTick();
+    }
+}
+
+void MotionGroup::_hostTimerCallback(uint32_t ticks) {
+    if (_activeGroup) {
+        _activeGroup->advanceTicks(ticks);
+    }
+}
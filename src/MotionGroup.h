@@ -0,0 +1,118 @@
+/*
+ * Mechanical Clock with Onboard RTC - Multi-Motor Motion Group
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOTION_GROUP_H
+#define MOTION_GROUP_H
+
+#include <Arduino.h>
+#include "StepPulseEngine.h" // One pulse engine per motor, ticked by the group
+#include "GearRatio.h"       // Gear train of each hand
+
+// Motors one group drives
+#define MOTION_GROUP_MAX_AXES 4
+
+// Pulses the timer ISR starts on one tick, across all motors. Bounds the ISR's time per tick;
+// a pulse over the budget is held to the next tick (STEP_ENGINE_TICK_US late).
+#define MOTION_GROUP_PULSES_PER_TICK 1
+
+// Steps are handed to the motors' step engines this far ahead of their due tick
+#define MOTION_GROUP_LOOKAHEAD_MS 1000UL
+
+// Spacing of steps that are already late (loop() was held up past the lookahead)
+#define MOTION_GROUP_CATCHUP_INTERVAL_US 1000UL
+
+// Pulse accounting of one motor
+struct MotionAxisStats {
+    unsigned long pulses;
+    unsigned long heldPulses; // Pulses the per-tick budget held to a later tick
+    uint32_t maxHeldTicks;    // Longest any pulse was held
+};
+
+// Drives several hand motors (hour, minute, seconds...) from one step timer.
+//
+// Each motor has its own step engine, steps per revolution and gear train. All of them keep
+// time from the same start tick: step k of a motor is due on the first tick at or after
+// k x (seconds per hand cycle) / (steps per hand cycle), worked out exactly in integers, so the
+// hands stay in phase with each other however long the group runs. loop() only hands steps
+// to the engines ahead of time (update()); the timer ISR emits them on their due tick.
+//
+// The ISR gives every motor a tick in turn, but starts at most pulsesPerTick pulses per tick.
+// Pulses due together beyond that are held to the following ticks, and the motor after the
+// last one served goes first on the next tick, so none of them waits more than
+// (motors - 1) / pulsesPerTick ticks.
+class MotionGroup {
+private:
+    struct Axis {
+        StepPulseEngine* engine;
+        uint32_t stepsPerCycle;   // Motor steps per hand cycle (reduced with secondsPerCycle)
+        uint32_t secondsPerCycle; // Hand cycle length (hand period x dial revolutions of the ratio)
+        uint64_t committed;       // Steps handed to the engine since start()
+        uint32_t heldTicks;       // Ticks the pulse now due has been held
+        MotionAxisStats stats;
+    };
+
+    Axis _axes[MOTION_GROUP_MAX_AXES];
+    uint8_t _axisCount;
+    uint8_t _pulsesPerTick;
+    uint8_t _nextAxis;          // First in line for the next tick's budget
+    volatile uint64_t _ticks;   // Timer ticks since begin()
+    uint64_t _startTick;        // Tick the hands showed their start time on
+    bool _running;
+
+    static MotionGroup* _activeGroup; // Group served by the timer ISR
+
+    static void _timerInterrupt();
+    static void _hostTimerCallback(uint32_t ticks);
+
+public:
+    explicit MotionGroup(uint8_t pulsesPerTick = MOTION_GROUP_PULSES_PER_TICK);
+
+    // Adds a motor turning its hand once every `handCycleSeconds` (43200 hour hand, 3600 minute
+    // hand, 60 seconds hand) through `ratio` (motor revolutions per hand revolution). Call before
+    // begin(). Returns the motor's index, or -1 if the group is full or the ratio is not valid.
+    int8_t addAxis(StepPulseEngine& engine, uint32_t stepsPerRev, const GearRatio& ratio, uint32_t handCycleSeconds);
+
+    // Sets up every motor's pins and starts the step timer (instead of the engines' own)
+    bool begin();
+
+    // Starts all hands together `delayMs` from now: that tick is where each shows the start time
+    void start(uint32_t delayMs = 0);
+
+    // Drops every queued step; the hands stay where the last pulses left them
+    void stop();
+
+    // Hands each motor the steps due within MOTION_GROUP_LOOKAHEAD_MS. Call from loop().
+    void update();
+
+    // Tick step `step` (counted from 1) of motor `axis` is due on
+    uint64_t dueTick(uint8_t axis, uint64_t step) const;
+
+    // Scheduler ISR body - one call per tick
+    void onTimerTick();
+
+    // Equivalent to `ticks` calls of onTimerTick(), skipping ticks on which no motor does anything
+    void advanceTicks(uint32_t ticks);
+
+    uint8_t axisCount() const { return _axisCount; }
+    uint64_t tickCount() const;
+    uint64_t startTick() const { return _startTick; }
+    long position(uint8_t axis) const { return _axes[axis].engine->currentPosition(); }
+    MotionAxisStats axisStats(uint8_t axis) const;
+};
+
+#endif // MOTION_GROUP_H
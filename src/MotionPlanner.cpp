@@ -0,0 +1,161 @@
+#include "MotionPlanner.h"
+#include <math.h> // For sqrtf (planning only, not per pulse)
+
+MotionPlanner::MotionPlanner(float maxSpeed, float acceleration)
+    : _maxSpeed(maxSpeed), _acceleration(acceleration),
+      _totalSteps(0), _direction(1), _accelGaps(0), _decelGaps(0), _nextPulse(0), _durationMs(0),
+      _rampTableUs(), _cruiseGapUs(0), _rampIndex(0), _rampGapFixed(0) {
+    setLimits(maxSpeed, acceleration);
+}
+
+// Ramp gaps use t(n) = sqrt(2n/a), written as sqrt(2/a) / (sqrt(n) + sqrt(n-1)) to avoid
+// cancellation. This is the only place they are computed in floating point.
+void MotionPlanner::setLimits(float maxSpeed, float acceleration) {
+    if (maxSpeed > 0.0f) _maxSpeed = maxSpeed;
+    if (acceleration > 0.0f) _acceleration = acceleration;
+
+    float firstGapUs = sqrtf(2.0f / _acceleration) * 1000000.0f;
+    for (long n = 1; n <= MOTION_RAMP_TABLE_SIZE; n++) {
+        _rampTableUs[n - 1] = (uint32_t)(firstGapUs / (sqrtf((float)n) + sqrtf((float)(n - 1))) + 0.5f);
+    }
+    _cruiseGapUs = (uint32_t)(1000000.0f / _maxSpeed + 0.5f);
+}
+
+// Time to cover `gaps` pulse gaps from rest at full acceleration (n = a t^2 / 2)
+float MotionPlanner::_rampTime(long gaps) const {
+    return sqrtf(2.0f * (float)gaps / _acceleration);
+}
+
+float MotionPlanner::interceptSeconds(long distanceSteps, float targetRate) const {
+    if (distanceSteps == 0) return 0.0f;
+
+    // Moving forward the target runs away from us; moving backward it comes towards us
+    float distance = (float)((distanceSteps > 0) ? distanceSteps : -distanceSteps);
+    float rate = (distanceSteps > 0) ? targetRate : -targetRate;
+
+    // Triangular profile: a T^2 / 4 = distance + rate T
+    float triangle = (rate + sqrtf(rate * rate + _acceleration * distance)) * 2.0f / _acceleration;
+    if (_acceleration * triangle / 2.0f <= _maxSpeed) {
+        return triangle;
+    }
+
+    // Trapezoidal profile: T = (distance + rate T) / vmax + vmax / a
+    return (distance / _maxSpeed + _maxSpeed / _acceleration) / (1.0f - rate / _maxSpeed);
+}
+
+float MotionPlanner::moveSeconds(long steps) const {
+    long pulses = (steps > 0) ? steps : -steps;
+    if (pulses <= 1) return 0.0f;
+
+    long gaps = pulses - 1;
+    long rampGaps = (long)(_maxSpeed * _maxSpeed / (2.0f * _acceleration));
+    long accel = (rampGaps < gaps / 2) ? rampGaps : gaps / 2;
+    long decel = (rampGaps < gaps - accel) ? rampGaps : gaps - accel;
+    return _rampTime(accel) + _rampTime(decel) + (float)(gaps - accel - decel) / _maxSpeed;
+}
+
+void MotionPlanner::start(long steps) {
+    _direction = (steps >= 0) ? 1 : -1;
+    _totalSteps = (steps > 0) ? steps : -steps;
+    _nextPulse = 0;
+    _rampIndex = 0;
+
+    long gaps = (_totalSteps > 0) ? _totalSteps - 1 : 0;
+    long rampGaps = (long)(_maxSpeed * _maxSpeed / (2.0f * _acceleration));
+    _accelGaps = (rampGaps < gaps / 2) ? rampGaps : gaps / 2;
+    _decelGaps = (rampGaps < gaps - _accelGaps) ? rampGaps : gaps - _accelGaps;
+    _durationMs = (uint32_t)(moveSeconds(_totalSteps) * 1000.0f + 0.5f);
+}
+
+void MotionPlanner::cancel() {
+    _totalSteps = 0;
+    _nextPulse = 0;
+    _durationMs = 0;
+}
+
+void MotionPlanner::stop(long pulsesDone) {
+    if (pulsesDone >= _totalSteps) {
+        _nextPulse = _totalSteps;
+        return;
+    }
+    if (pulsesDone <= 0) {
+        cancel(); // Still at rest
+        return;
+    }
+
+    long gaps = _totalSteps - 1;
+    long last = pulsesDone - 1; // Last pulse out; the gap after it is ramp gap `speed`
+    long speed;
+    if (last < _accelGaps) {
+        speed = last + 1;
+    } else if (last < gaps - _decelGaps) {
+        speed = _accelGaps; // Cruising
+    } else {
+        speed = gaps - last; // Already slowing down
+    }
+
+    // Ramp back down from that gap: the profile ends `speed` pulses later
+    _totalSteps = pulsesDone + speed;
+    if (_accelGaps > last) _accelGaps = last;
+    _decelGaps = speed;
+    _nextPulse = pulsesDone;
+}
+
+// Spacing after pulse `pulseIndex`
+uint32_t MotionPlanner::_gapUs(long pulseIndex) {
+    long gaps = _totalSteps - 1;
+    long n = 0;
+    if (pulseIndex < _accelGaps) {
+        n = pulseIndex + 1;
+    } else if (pulseIndex >= gaps - _decelGaps) {
+        n = gaps - pulseIndex;
+    }
+    if (n <= 0) {
+        return _cruiseGapUs; // Cruise (or a lone pulse)
+    }
+    return _rampGapUs(n);
+}
+
+// Gap n of a ramp from rest. Pulses are handed out in order, so beyond the table n only
+// ever moves one gap from where the recurrence is: up through the acceleration ramp,
+// then down through the deceleration ramp (which starts at the same or the next gap).
+uint32_t MotionPlanner::_rampGapUs(long n) {
+    if (n <= MOTION_RAMP_TABLE_SIZE) {
+        return _rampTableUs[n - 1];
+    }
+    if (_rampIndex < MOTION_RAMP_TABLE_SIZE) {
+        _rampIndex = MOTION_RAMP_TABLE_SIZE;
+        _rampGapFixed = _rampTableUs[MOTION_RAMP_TABLE_SIZE - 1] << MOTION_RAMP_FRACTION_BITS;
+    }
+    while (_rampIndex < n) {
+        _rampIndex++;
+        uint32_t divisor = (uint32_t)(4 * _rampIndex - 3);
+        _rampGapFixed -= (2 * _rampGapFixed + divisor / 2) / divisor; // Rounded, so errors do not pile up
+    }
+    while (_rampIndex > n) {
+        uint32_t divisor = (uint32_t)(4 * _rampIndex - 5); // Inverse of the step up
+        _rampGapFixed += (2 * _rampGapFixed + divisor / 2) / divisor;
+        _rampIndex--;
+    }
+    return (_rampGapFixed + (1UL << (MOTION_RAMP_FRACTION_BITS - 1))) >> MOTION_RAMP_FRACTION_BITS;
+}
+
+bool MotionPlanner::nextSegment(uint16_t& count, uint32_t& gapUs) {
+    if (!isActive()) return false;
+
+    long gaps = _totalSteps - 1;
+    long cruiseEnd = gaps - _decelGaps;
+
+    if (_nextPulse >= _accelGaps && _nextPulse < cruiseEnd) {
+        // Whole cruise phase (or up to a full command) in one run
+        long run = cruiseEnd - _nextPulse;
+        count = (run > 0xFFFF) ? 0xFFFF : (uint16_t)run;
+        gapUs = _gapUs(_nextPulse);
+    } else {
+        count = 1;
+        // The last pulse keeps the final ramp spacing before any following command
+        gapUs = _gapUs((_nextPulse < gaps || gaps == 0) ? _nextPulse : gaps - 1);
+    }
+    _nextPulse += count;
+    return true;
+}
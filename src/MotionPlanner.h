@@ -0,0 +1,100 @@
+/*
+ * Mechanical Clock with Onboard RTC - Catch-Up Motion Planner
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOTION_PLANNER_H
+#define MOTION_PLANNER_H
+
+#include <stdint.h> // For fixed-width integer types
+
+// Ramp gaps worked out exactly when the limits are set (the steep start of the ramp,
+// where the recurrence below is least accurate). Longer ramps continue by recurrence.
+#define MOTION_RAMP_TABLE_SIZE 64
+
+// Fractional bits of the ramp recurrence's fixed-point gap. Gaps past the table are at most
+// 1/16 of the first one, so this holds first gaps up to 8 s (acceleration down to 0.03 steps/s^2).
+#define MOTION_RAMP_FRACTION_BITS 12
+
+// Plans rest-to-rest trapezoidal moves that catch up with the clock hands'
+// moving target (real time keeps advancing while the hands travel) in the
+// shortest time the speed and acceleration limits allow.
+//
+// Usage: interceptSeconds() estimates when the hands can meet real time,
+// the caller converts that instant into a whole step count, start() builds
+// the exact profile for those steps, and nextSegment() hands the pulse
+// spacing to the step engine a run at a time.
+//
+// Handing out a pulse is integer-only: ramp gap n comes from a table for the first
+// MOTION_RAMP_TABLE_SIZE gaps and, beyond it, from the recurrence
+// c(n) = c(n-1) - 2 c(n-1) / (4n - 3) (D. Austin, "Generate stepper-motor speed
+// profiles in real time", with gaps counted from 1), run backwards for the deceleration ramp.
+class MotionPlanner {
+private:
+    float _maxSpeed;     // steps/s
+    float _acceleration; // steps/s^2
+
+    // Active profile
+    long _totalSteps;      // Pulses in the move (unsigned count)
+    int8_t _direction;     // +1 clockwise, -1 anticlockwise
+    long _accelGaps;       // Gaps in the acceleration ramp
+    long _decelGaps;       // Gaps in the deceleration ramp
+    long _nextPulse;       // Index of the next pulse to hand out
+    uint32_t _durationMs;  // First to last pulse
+
+    uint32_t _rampTableUs[MOTION_RAMP_TABLE_SIZE]; // Gap n + 1 of a ramp from rest (us)
+    uint32_t _cruiseGapUs;
+    long _rampIndex;       // Ramp gap the recurrence is at (0 = not started)
+    uint32_t _rampGapFixed; // ...and its length in us, MOTION_RAMP_FRACTION_BITS fixed point
+
+    uint32_t _gapUs(long pulseIndex);
+    uint32_t _rampGapUs(long n);
+    float _rampTime(long gaps) const;
+
+public:
+    MotionPlanner(float maxSpeed, float acceleration);
+
+    void setLimits(float maxSpeed, float acceleration);
+    float getMaxSpeed() const { return _maxSpeed; }
+    float getAcceleration() const { return _acceleration; }
+
+    // Minimum time (s) for a rest-to-rest move to meet a target that starts
+    // `distanceSteps` away (sign = direction) and moves forward at `targetRate` steps/s
+    float interceptSeconds(long distanceSteps, float targetRate) const;
+
+    // Minimum duration (s) of a rest-to-rest move of `steps` pulses
+    float moveSeconds(long steps) const;
+
+    // Builds the profile for a move of `steps` pulses (sign = direction)
+    void start(long steps);
+    void cancel();
+
+    // Brings the move to rest as soon as the acceleration limit allows, after pulse
+    // `pulsesDone` (pulses the step engine has emitted). The caller drops the queued pulses
+    // past that one first; nextSegment() then hands out the deceleration from there.
+    void stop(long pulsesDone);
+
+    // Next run of equally spaced pulses. Returns false when the move has been handed out.
+    bool nextSegment(uint16_t& count, uint32_t& gapUs);
+
+    bool isActive() const { return _nextPulse < _totalSteps; }
+    int8_t direction() const { return _direction; }
+    long totalSteps() const { return _totalSteps; }
+    long stepsRemaining() const { return _totalSteps - _nextPulse; }
+    uint32_t durationMs() const { return _durationMs; } // ETA from the first pulse
+};
+
+#endif // MOTION_PLANNER_H
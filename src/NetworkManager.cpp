@@ -15,7 +15,8 @@ NetworkManager::NetworkManager(const char* apSsid, IPAddress ntpServerIP, unsign
                                unsigned long ntpRetryDelay, int wifiReconnectRetries,
                                unsigned long wifiReconnectDelay, unsigned long ntpSyncInterval,
                                int timeZoneOffsetHours, bool useDST)
-    : _server(80), // Initialize WiFiServer on port 80
+    : _configModeRequired(false), // Default to false, determined in begin()
+      _server(80), // Initialize WiFiServer on port 80
       _apSsid(apSsid), // Store AP SSID
       _ntpServerIP(ntpServerIP),
       _localPort(localPort),
@@ -28,7 +29,8 @@ NetworkManager::NetworkManager(const char* apSsid, IPAddress ntpServerIP, unsign
       _wifiReconnectDelay(wifiReconnectDelay),
       _ntpSyncInterval(ntpSyncInterval),
       _lastNTPSyncTime(0),
-      _configModeRequired(false) // Default to false, determined in begin()
+      _idleCallback(nullptr),
+      _idleContext(nullptr)
 {
     // Initialize credentials buffer to nulls
     memset(_credentials.ssid, 0, sizeof(_credentials.ssid));
@@ -97,7 +99,7 @@ void NetworkManager::setupAccessPoint() {
     
     // Stop any existing connections and WiFi
     WiFi.end(); // Disconnects from any STA and stops SoftAP
-    delay(500);
+    _idleDelay(500);
     
     // Check WiFi module
     if (WiFi.status() == WL_NO_MODULE) {
@@ -132,7 +134,7 @@ void NetworkManager::setupAccessPoint() {
     // Wait for AP to start listening
     unsigned long apStartTime = millis();
     while (WiFi.status() != WL_AP_LISTENING && (millis() - apStartTime < 10000)) { // 10 second timeout
-        delay(500);
+        _idleDelay(500);
         Serial.print(".");
     }
     
@@ -170,12 +172,12 @@ void NetworkManager::stopAccessPoint() {
     if (WiFi.status() == WL_AP_LISTENING) { // Check if AP is active
         Serial.println("Stopping AP.");
         WiFi.end(); // Stops both STA and AP modes
-        delay(500);
+        _idleDelay(500);
         
         // Reset WiFi configuration to allow DHCP in client mode
         // For Arduino R4 WiFi, we need to completely reset the WiFi module
         WiFi.disconnect();
-        delay(1000); // Give more time for complete reset
+        _idleDelay(1000); // Give more time for complete reset
     }
 }
 
@@ -191,7 +193,7 @@ bool NetworkManager::ensureConnection() {
     // Stop any existing connections and WiFi (like the working version)
     Serial.println("Stopping any existing WiFi connections...");
     WiFi.end();
-    delay(1000);
+    _idleDelay(1000);
     
     // Try to connect (like the working version)
     Serial.println("Attempting to connect...");
@@ -199,7 +201,7 @@ bool NetworkManager::ensureConnection() {
     
     unsigned long startTime = millis();
     while (WiFi.status() != WL_CONNECTED && millis() - startTime < _wifiConnectTimeout) {
-        delay(500);
+        _idleDelay(500);
         Serial.print(".");
     }
     
@@ -212,7 +214,7 @@ bool NetworkManager::ensureConnection() {
         IPAddress currentIP = WiFi.localIP();
         
         while (currentIP[0] == 0 && (millis() - dhcpStartTime < 15000)) { // Wait up to 15 seconds for DHCP
-            delay(1000);
+            _idleDelay(1000);
             currentIP = WiFi.localIP();
             Serial.print("Waiting for DHCP... Current IP: ");
             Serial.println(currentIP);
@@ -300,10 +302,10 @@ bool NetworkManager::syncTimeWithRTC(RTClock& rtcInstance) {
                 Serial.print("Set RTC to (UTC): "); Serial.println(timeToSet.toString());
                 return true;
             }
-            delay(10);
+            _idleDelay(10);
         }
         Serial.println("✗ NTP attempt failed, retrying...");
-        delay(_ntpRetryDelay);
+        _idleDelay(_ntpRetryDelay);
     }
     
     Serial.println("✗ All NTP attempts failed!");
@@ -505,14 +507,14 @@ bool NetworkManager::_testWiFiConnection(const char* testSsid, const char* testP
     // Stop AP mode and try to connect (like the working version)
     Serial.println("Stopping AP mode...");
     WiFi.end();
-    delay(1000);
+    _idleDelay(1000);
     
     Serial.println("Attempting to connect...");
     WiFi.begin(testSsid, testPass);
     
     unsigned long startTime = millis();
     while (WiFi.status() != WL_CONNECTED && millis() - startTime < _wifiConnectTimeout) {
-        delay(500);
+        _idleDelay(500);
         Serial.print(".");
     }
     
@@ -665,6 +667,25 @@ bool NetworkManager::isNTPSyncNeeded() const {
     return (millis() - _lastNTPSyncTime >= _ntpSyncInterval);
 }
 
+// --- Idle work during blocking waits ---
+void NetworkManager::setIdleCallback(IdleCallback callback, void* context) {
+    _idleCallback = callback;
+    _idleContext = context;
+}
+
+void NetworkManager::_idleDelay(unsigned long ms) {
+    unsigned long start = millis();
+    while (true) {
+        if (_idleCallback) {
+            _idleCallback(_idleContext);
+        }
+        unsigned long elapsed = millis() - start;
+        if (elapsed >= ms) break;
+        unsigned long remaining = ms - elapsed;
+        delay(remaining < NETWORK_IDLE_POLL_MS ? remaining : NETWORK_IDLE_POLL_MS);
+    }
+}
+
 // --- Reset NTP Sync Counter ---
 void NetworkManager::resetNtpSyncCounter() {
     _lastNTPSyncTime = millis(); // Reset to current time, deferring sync for another interval
@@ -20,6 +20,12 @@ struct WiFiCredentials {
     bool isValid; // Flag to indicate if the stored credentials are valid
 };
 
+// Called repeatedly from NetworkManager's blocking waits (WiFi join, DHCP, NTP)
+typedef void (*IdleCallback)(void* context);
+
+// Longest stretch between idle callbacks inside a blocking wait
+const unsigned long NETWORK_IDLE_POLL_MS = 10;
+
 class NetworkManager {
 private:
     WiFiCredentials _credentials; // Stores current WiFi credentials (from EEPROM or AP)
@@ -49,6 +55,11 @@ private:
 
     unsigned long _lastNTPSyncTime; // millis() timestamp of last successful NTP sync
 
+    // Work that must keep running while we wait on the WiFi module or NTP server
+    IdleCallback _idleCallback;
+    void* _idleContext;
+    void _idleDelay(unsigned long ms); // delay() that keeps calling the idle callback
+
     // Private helper methods for captive portal (manual HTTP handling)
     void _handleRootRequest(WiFiClient client);
     void _handleSaveRequest(WiFiClient client, String requestLine);
@@ -118,6 +129,9 @@ public:
     void resetNtpSyncCounter(); // Reset NTP sync counter to defer sync for another interval
     void saveCredentials(const char* newSsid, const char* newPassword);
     
+    // Registers work to run during blocking network waits (e.g. keeping the clock hands moving)
+    void setIdleCallback(IdleCallback callback, void* context);
+    
     // Getters for timezone settings
     int getTimeZoneOffset() const { return _timeZoneOffsetHours; }
     bool getUseDST() const { return _useDST; }
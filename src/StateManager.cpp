@@ -4,8 +4,10 @@
 StateManager::StateManager(NetworkManager& networkManager, LCDDisplay& lcdDisplay, 
                            Clock& clock, RTClock& rtc)
     : _networkManager(networkManager), _lcdDisplay(lcdDisplay), _clock(clock), _rtc(rtc),
-      _currentState(STATE_INIT), _lastStateChange(0), _lastDebugPrint(0),
+      _currentState(STATE_INIT), _handsRunning(false), _lastStateChange(0), _lastDebugPrint(0),
       _configStartTime(0), _wifiConnectStartTime(0), _ntpSyncStartTime(0) {
+    // WiFi joins and NTP waits block for seconds - keep the hands moving meanwhile
+    _networkManager.setIdleCallback(_networkIdle, this);
 }
 
 void StateManager::update() {
@@ -18,12 +20,27 @@ void StateManager::update() {
     // Run the current state's logic
     _runCurrentStateLogic();
     
-    // Update the clock in appropriate states (not during config, connecting, etc.)
-    if (_currentState == STATE_RUNNING) {
+    // Hand motion is independent of the connectivity state
+    _updateHands();
+}
+
+void StateManager::_updateHands() {
+    // The hands start as soon as the RTC holds valid time: straight after power-up if it kept
+    // running on its backup supply (NTP then only trims its drift), else once NTP has set it
+    if (!_handsRunning && _clock.isRtcTimeValid()) {
+        Serial.println("RTC time valid - hands running");
+        _handsRunning = true;
+    }
+    if (_handsRunning) {
+        _clock.setTimeZone(_networkManager.getTimeZoneOffset(), _networkManager.getUseDST()); // Follows the config portal
         _clock.updateCurrentTime();
     }
 }
 
+void StateManager::_networkIdle(void* context) {
+    static_cast<StateManager*>(context)->_updateHands();
+}
+
 void StateManager::transitionTo(ClockState newState) {
     if (_currentState == newState) {
         return; // No state change needed
@@ -108,6 +125,7 @@ void StateManager::_handleStateEntry(ClockState newState) {
             
         case STATE_RUNNING:
             Serial.println("Entering normal operation...");
+            _handsRunning = true;
             _lcdDisplay.printLine(0, "Clock Running");
             _lcdDisplay.printLine(1, "Normal Mode");
             break;
@@ -207,6 +225,7 @@ void StateManager::_runSyncingTimeState() {
     // Attempt NTP sync using the RTC reference
     if (_networkManager.syncTimeWithRTC(_rtc)) {
         // After successful NTP sync, update clock to current time
+        _clock.setTimeZone(_networkManager.getTimeZoneOffset(), _networkManager.getUseDST());
         _clock.updateCurrentTime();
         transitionTo(STATE_RUNNING);
     }
@@ -34,6 +34,7 @@ private:
     
     ClockState _currentState;
     String _lastError;
+    bool _handsRunning; // Hands follow the RTC in every state once it holds valid time
     unsigned long _lastStateChange;
     unsigned long _lastDebugPrint;
     
@@ -55,6 +56,10 @@ private:
     void _runRunningState();
     void _runErrorState();
     
+    // Hand motion (runs alongside the connectivity states)
+    void _updateHands();
+    static void _networkIdle(void* context);
+    
     // State validation
     bool _isValidTransition(ClockState fromState, ClockState toState) const;
 
@@ -70,6 +75,7 @@ public:
     ClockState getCurrentState() const;
     void setLastError(const String& error);
     String getLastError() const;
+    bool areHandsRunning() const { return _handsRunning; }
     
     // Debug and status
     void printStateInfo();
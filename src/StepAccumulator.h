@@ -0,0 +1,292 @@
+/*
+ * Mechanical Clock with Onboard RTC - Fractional Step Accumulator
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEP_ACCUMULATOR_H
+#define STEP_ACCUMULATOR_H
+
+#include <stdint.h> // For fixed-width integer types
+#include <time.h>   // For time_t
+
+// Exact position model for the clock hands.
+//
+// The movement advances `stepsPerCycle` (micro)steps every `secondsPerCycle`
+// seconds. One step is therefore worth secondsPerCycle / stepsPerCycle seconds,
+// which is not a whole number in most microstep modes (18/16 = 1.125 s).
+// The time the hands represent is kept as whole seconds plus a remainder in
+// 1/stepsPerCycle-second units, so each step adds its exact duration and no
+// rounding error accumulates, no matter how long the clock runs.
+//
+// loop() asks for the steps due many times a second, always for a time close
+// to the one the hands show (they are anchored to real time at every sync and
+// follow it step by step). Within the narrow window around the hand position
+// the arithmetic is 32-bit, relative to it; only times and moves further away
+// (the first sync, an RTC reset) take 64 bits, which the Cortex-M4 can only
+// divide in software.
+class StepAccumulator {
+private:
+    uint32_t _stepsPerCycle;      // Steps per dial cycle (numerator of the step rate)
+    uint32_t _secondsPerCycle;    // Seconds per dial cycle (denominator of the step rate)
+    uint32_t _wholeSecondsPerStep; // secondsPerCycle / stepsPerCycle
+    uint32_t _remainderPerStep;    // secondsPerCycle % stepsPerCycle, in 1/stepsPerCycle s
+    int32_t _narrowSeconds;        // stepsDue() is 32-bit for times closer than this to the hands
+    int32_t _narrowSteps;          // commit() is 32-bit for moves shorter than this
+
+    time_t _seconds;     // Whole seconds the hands represent
+    uint32_t _remainder; // Fractional second carried between calls (0 <= _remainder < stepsPerCycle)
+
+    static int64_t _floorDiv(int64_t value, int64_t divisor);
+
+public:
+    StepAccumulator(uint32_t stepsPerCycle = 1, uint32_t secondsPerCycle = 1);
+
+    // Changes the step rate while keeping the represented time (remainder is rescaled).
+    // Returns false (ratio unchanged) if either term is zero.
+    bool setRatio(uint32_t stepsPerCycle, uint32_t secondsPerCycle);
+
+    // Declares that the hands show exactly `time` plus `remainder` 1/stepsPerCycle-second units
+    void anchor(time_t time, uint32_t remainder = 0);
+
+    // Shifts the represented time without moving the hands (whole dial cycles only)
+    void shiftSeconds(long seconds);
+
+    // Whole steps needed to bring the hands to `now`. Positive values move the
+    // hands forward to the last step boundary at or before `now`; negative values
+    // move them back only while they are at least one full step ahead.
+    long stepsDue(time_t now) const;
+
+    // Records that `steps` steps were issued to the motor
+    void commit(long steps);
+
+    // The fractional second in 1/unitsPerSecond units, rounded down (ms, timer ticks)
+    uint32_t fractionIn(uint32_t unitsPerSecond) const;
+
+    time_t seconds() const { return _seconds; }
+    uint32_t remainder() const { return _remainder; }
+    uint32_t stepsPerCycle() const { return _stepsPerCycle; }
+    uint32_t secondsPerCycle() const { return _secondsPerCycle; }
+};
+
+inline int64_t StepAccumulator::_floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    if ((value % divisor != 0) && (value < 0)) {
+        quotient--;
+    }
+    return quotient;
+}
+
+inline StepAccumulator::StepAccumulator(uint32_t stepsPerCycle, uint32_t secondsPerCycle)
+    : _stepsPerCycle(1), _secondsPerCycle(1), _wholeSecondsPerStep(1), _remainderPerStep(0),
+      _narrowSeconds(0), _narrowSteps(0), _seconds(0), _remainder(0) {
+    setRatio(stepsPerCycle, secondsPerCycle);
+}
+
+inline bool StepAccumulator::setRatio(uint32_t stepsPerCycle, uint32_t secondsPerCycle) {
+    if (stepsPerCycle == 0 || secondsPerCycle == 0) return false; // Keep previous (valid) ratio
+
+    // Rescale the carried fraction to the new remainder units
+    _remainder = (uint32_t)(((uint64_t)_remainder * stepsPerCycle) / _stepsPerCycle);
+
+    _stepsPerCycle = stepsPerCycle;
+    _secondsPerCycle = secondsPerCycle;
+    _wholeSecondsPerStep = secondsPerCycle / stepsPerCycle;
+    _remainderPerStep = secondsPerCycle % stepsPerCycle;
+    _narrowSeconds = (int32_t)((0x7FFFFFFFUL - stepsPerCycle) / stepsPerCycle);
+    _narrowSteps = (int32_t)((0x7FFFFFFFUL - stepsPerCycle) / ((uint64_t)stepsPerCycle + secondsPerCycle));
+    return true;
+}
+
+inline void StepAccumulator::anchor(time_t time, uint32_t remainder) {
+    _seconds = time;
+    _remainder = remainder % _stepsPerCycle;
+}
+
+inline void StepAccumulator::shiftSeconds(long seconds) {
+    _seconds += seconds;
+}
+
+inline long StepAccumulator::stepsDue(time_t now) const {
+    int64_t elapsed = (int64_t)now - (int64_t)_seconds; // Range-checked before narrowing
+    if (elapsed > -_narrowSeconds && elapsed < _narrowSeconds) {
+        // Normal running: a 32-bit multiply and, only when a step is due, a 32-bit divide
+        int32_t scaled = (int32_t)elapsed * (int32_t)_stepsPerCycle - (int32_t)_remainder;
+        if (scaled >= 0 && (uint32_t)scaled < _secondsPerCycle) return 0;
+        if (scaled >= 0) return (long)((uint32_t)scaled / _secondsPerCycle);
+        return -(long)((uint32_t)(-scaled) / _secondsPerCycle);
+    }
+
+    // Distance to `now` in 1/stepsPerCycle-second units
+    int64_t scaled = elapsed * _stepsPerCycle - _remainder;
+
+    // Fast path: less than one step due (a multiply and a compare)
+    if (scaled >= 0 && scaled < (int64_t)_secondsPerCycle) {
+        return 0;
+    }
+
+    if (scaled >= 0) {
+        return (long)(scaled / _secondsPerCycle);
+    }
+    return -(long)((-scaled) / _secondsPerCycle);
+}
+
+inline void StepAccumulator::commit(long steps) {
+    if (steps > -_narrowSteps && steps < _narrowSteps) {
+        // Time-keeping steps and catch-up moves: 32 bits, floor division for negative moves
+        int32_t fraction = (int32_t)_remainder + (int32_t)steps * (int32_t)_remainderPerStep;
+        int32_t carry = fraction / (int32_t)_stepsPerCycle;
+        if (fraction % (int32_t)_stepsPerCycle < 0) carry--;
+
+        _seconds += (long)(steps * (long)_wholeSecondsPerStep + carry);
+        _remainder = (uint32_t)(fraction - carry * (int32_t)_stepsPerCycle);
+        return;
+    }
+
+    int64_t fraction = (int64_t)_remainder + (int64_t)steps * _remainderPerStep;
+    int64_t carry = _floorDiv(fraction, _stepsPerCycle);
+
+    _seconds += (time_t)((int64_t)steps * _wholeSecondsPerStep + carry);
+    _remainder = (uint32_t)(fraction - carry * _stepsPerCycle);
+}
+
+inline uint32_t StepAccumulator::fractionIn(uint32_t unitsPerSecond) const {
+    if (_remainder <= 0xFFFFFFFFUL / unitsPerSecond) { // Folds away for constant units
+        return _remainder * unitsPerSecond / _stepsPerCycle;
+    }
+    return (uint32_t)((uint64_t)_remainder * unitsPerSecond / _stepsPerCycle);
+}
+
+// Greatest common divisor, evaluated by the compiler for the fixed ratio below
+constexpr uint32_t stepRatioGcd(uint32_t a, uint32_t b) {
+    return (b == 0) ? a : stepRatioGcd(b, a % b);
+}
+
+// StepAccumulator with the step rate fixed at compile time.
+//
+// Same model and interface as StepAccumulator (minus setRatio()), but the ratio
+// is reduced to lowest terms by the compiler (2400/43200 becomes 1/18), so the
+// per-update stepsDue() is a multiply by a small constant and a division by a
+// constant that the compiler turns into a multiply and shift. At full stepping
+// the remainder is always zero and the fractional bookkeeping folds away.
+template <uint32_t StepsPerCycle, uint32_t SecondsPerCycle>
+class FixedStepAccumulator {
+public:
+    static constexpr uint32_t STEPS_PER_CYCLE = StepsPerCycle / stepRatioGcd(StepsPerCycle, SecondsPerCycle);
+    static constexpr uint32_t SECONDS_PER_CYCLE = SecondsPerCycle / stepRatioGcd(StepsPerCycle, SecondsPerCycle);
+
+private:
+    static_assert(StepsPerCycle > 0 && SecondsPerCycle > 0, "Step rate must be non-zero");
+
+    static constexpr uint32_t WHOLE_SECONDS_PER_STEP = SECONDS_PER_CYCLE / STEPS_PER_CYCLE;
+    static constexpr uint32_t REMAINDER_PER_STEP = SECONDS_PER_CYCLE % STEPS_PER_CYCLE;
+
+    // Largest |now - seconds| whose scaled distance still fits in 32 bits
+    static constexpr int32_t NARROW_LIMIT = (int32_t)((0x7FFFFFFFUL - SECONDS_PER_CYCLE) / STEPS_PER_CYCLE);
+    // Largest move commit() works out in 32 bits
+    static constexpr int32_t NARROW_STEPS =
+        (int32_t)((0x7FFFFFFFUL - STEPS_PER_CYCLE) / ((uint64_t)STEPS_PER_CYCLE + SECONDS_PER_CYCLE));
+
+    time_t _seconds;     // Whole seconds the hands represent
+    uint32_t _remainder; // Fractional second in 1/STEPS_PER_CYCLE units (always 0 when that is 1)
+
+public:
+    FixedStepAccumulator() : _seconds(0), _remainder(0) {}
+
+    void anchor(time_t time, uint32_t remainder = 0) {
+        _seconds = time;
+        _remainder = remainder % STEPS_PER_CYCLE;
+    }
+
+    void shiftSeconds(long seconds) { _seconds += seconds; }
+
+    // The rate is built in: accepts (returns true for) that same rate only, in any terms
+    bool setRatio(uint32_t stepsPerCycle, uint32_t secondsPerCycle) const {
+        return stepsPerCycle != 0 &&
+               (uint64_t)stepsPerCycle * SECONDS_PER_CYCLE == (uint64_t)secondsPerCycle * STEPS_PER_CYCLE;
+    }
+
+    // Same rounding as StepAccumulator::stepsDue()
+    long stepsDue(time_t now) const {
+        int64_t elapsed = (int64_t)now - (int64_t)_seconds; // Range-checked before narrowing
+        if (elapsed > -NARROW_LIMIT && elapsed < NARROW_LIMIT) {
+            // Normal running: 32-bit arithmetic with constant operands
+            int32_t scaled = (int32_t)elapsed * (int32_t)STEPS_PER_CYCLE - (int32_t)_remainder;
+            if (scaled >= 0) return (long)((uint32_t)scaled / SECONDS_PER_CYCLE);
+            return -(long)((uint32_t)(-scaled) / SECONDS_PER_CYCLE);
+        }
+
+        // Years away (first sync, RTC reset): fall back to 64 bits
+        int64_t scaled = elapsed * STEPS_PER_CYCLE - _remainder;
+        if (scaled >= 0) return (long)(scaled / SECONDS_PER_CYCLE);
+        return -(long)((-scaled) / SECONDS_PER_CYCLE);
+    }
+
+    void commit(long steps) {
+        if (steps > -NARROW_STEPS && steps < NARROW_STEPS) {
+            // Time-keeping steps and catch-up moves: 32 bits, divisions by constants
+            if (REMAINDER_PER_STEP == 0) {
+                _seconds += (long)(steps * (long)WHOLE_SECONDS_PER_STEP);
+                return;
+            }
+            int32_t fraction = (int32_t)_remainder + (int32_t)steps * (int32_t)REMAINDER_PER_STEP;
+            int32_t carry = fraction / (int32_t)STEPS_PER_CYCLE;
+            if (fraction % (int32_t)STEPS_PER_CYCLE < 0) carry--;
+
+            _seconds += (long)(steps * (long)WHOLE_SECONDS_PER_STEP + carry);
+            _remainder = (uint32_t)(fraction - carry * (int32_t)STEPS_PER_CYCLE);
+            return;
+        }
+
+        if (REMAINDER_PER_STEP == 0) {
+            _seconds += (time_t)((int64_t)steps * WHOLE_SECONDS_PER_STEP);
+            return;
+        }
+        int64_t fraction = (int64_t)_remainder + (int64_t)steps * REMAINDER_PER_STEP;
+        int64_t carry = fraction / (int64_t)STEPS_PER_CYCLE;
+        if (fraction % (int64_t)STEPS_PER_CYCLE < 0) carry--; // Floor for negative moves
+
+        _seconds += (time_t)((int64_t)steps * WHOLE_SECONDS_PER_STEP + carry);
+        _remainder = (uint32_t)(fraction - carry * (int64_t)STEPS_PER_CYCLE);
+    }
+
+    // The fractional second in 1/unitsPerSecond units, rounded down (ms, timer ticks)
+    uint32_t fractionIn(uint32_t unitsPerSecond) const {
+        if (STEPS_PER_CYCLE == 1) return 0;
+        if (STEPS_PER_CYCLE <= 0xFFFFFFFFUL / unitsPerSecond) { // Folds away for constant units
+            return _remainder * unitsPerSecond / STEPS_PER_CYCLE;
+        }
+        return (uint32_t)((uint64_t)_remainder * unitsPerSecond / STEPS_PER_CYCLE);
+    }
+
+    time_t seconds() const { return _seconds; }
+    uint32_t remainder() const { return _remainder; }
+    uint32_t stepsPerCycle() const { return STEPS_PER_CYCLE; }
+    uint32_t secondsPerCycle() const { return SECONDS_PER_CYCLE; }
+};
+
+// Hand position model for a step rate: FixedStepAccumulator for one fixed at compile time,
+// StepAccumulator for (0, 0), a rate only known at run time (set with setRatio())
+template <uint32_t StepsPerCycle, uint32_t SecondsPerCycle>
+struct StepAccumulatorFor {
+    typedef FixedStepAccumulator<StepsPerCycle, SecondsPerCycle> Type;
+};
+
+template <>
+struct StepAccumulatorFor<0, 0> {
+    typedef StepAccumulator Type;
+};
+
+#endif // STEP_ACCUMULATOR_H
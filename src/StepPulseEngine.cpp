@@ -0,0 +1,321 @@
+#include "StepPulseEngine.h"
+
+#if defined(ARDUINO_ARCH_RENESAS)
+#include <FspTimer.h> // GPT/AGT timer access on the UNO R4
+#endif
+
+StepPulseEngine* StepPulseEngine::_activeEngine = nullptr;
+
+StepPulseEngine::StepPulseEngine(uint8_t stepPin, uint8_t dirPin)
+    : _stepPin(stepPin), _dirPin(dirPin),
+      _head(0), _tail(0),
+      _intervalTicks(STEP_ENGINE_MIN_INTERVAL_TICKS), _remaining(0), _countdown(0),
+      _direction(1), _awaitingStart(false), _stepHigh(false), _position(0), _tickCount(0),
+      _targetPosition(0), _timedPending(0), _outputEnabled(true), _outputEnabledTick(0), _warmUpTicks(0), _pulseObserver(nullptr),
+      _inputReader(nullptr), _inputLevel(false), _stopOnInput(false), _inputLatched(false), _latchedPosition(0) {
+}
+
+bool StepPulseEngine::begin(bool startTimer) {
+    _stepPin.begin(LOW);
+    _dirPin.begin(HIGH); // HIGH = clockwise
+    _direction = 1;
+    if (!startTimer) return true;
+
+    _activeEngine = this;
+    if (!startStepTimer(timerInterrupt, _hostTimerCallback)) {
+        Serial.println("StepPulseEngine: no hardware timer available!");
+        return false;
+    }
+    return true;
+}
+
+bool StepPulseEngine::queueSteps(long steps, uint32_t intervalUs) {
+    return _push(steps, intervalUs, false, 0);
+}
+
+bool StepPulseEngine::queueStepsAt(long steps, uint32_t startTick, uint32_t intervalUs) {
+    return _push(steps, intervalUs, true, startTick);
+}
+
+bool StepPulseEngine::_push(long steps, uint32_t intervalUs, bool timed, uint32_t startTick) {
+    if (steps == 0) return true;
+
+    int8_t direction = (steps > 0) ? 1 : -1;
+    unsigned long remaining = (steps > 0) ? steps : -steps;
+    uint32_t intervalTicks = intervalUs / STEP_ENGINE_TICK_US;
+    if (intervalTicks < STEP_ENGINE_MIN_INTERVAL_TICKS) {
+        intervalTicks = STEP_ENGINE_MIN_INTERVAL_TICKS;
+    }
+
+    // All-or-nothing: make sure every chunk fits before queuing any
+    uint8_t needed = (uint8_t)((remaining + 0xFFFE) / 0xFFFF);
+    if (needed > freeSlots()) return false;
+
+    _targetPosition += steps; // Before publishing, so distanceToGo() never goes negative
+    if (timed) {
+        noInterrupts();
+        _timedPending++;
+        interrupts();
+    }
+    while (remaining > 0) {
+        uint16_t chunk = (remaining > 0xFFFF) ? 0xFFFF : (uint16_t)remaining;
+        uint8_t head = _head;
+        _queue[head].intervalTicks = intervalTicks;
+        _queue[head].count = chunk;
+        _queue[head].direction = direction;
+        _queue[head].timed = timed;
+        _queue[head].startTick = startTick;
+        timed = false; // Later chunks carry straight on
+
+        noInterrupts(); // Publish the command only after it is fully written
+        _head = (uint8_t)((head + 1) & (STEP_ENGINE_QUEUE_SIZE - 1));
+        interrupts();
+
+        remaining -= chunk;
+    }
+    return true;
+}
+
+void StepPulseEngine::clear() {
+    noInterrupts();
+    _tail = _head;
+    _remaining = 0;
+    if (_awaitingStart) _countdown = 0; // Nothing left to wait for
+    _awaitingStart = false;
+    _timedPending = 0;
+    _targetPosition = _position;
+    interrupts();
+}
+
+void StepPulseEngine::setOutputEnabled(bool enabled, uint32_t warmUpTicks) {
+    noInterrupts();
+    _outputEnabledTick = _tickCount;
+    _warmUpTicks = warmUpTicks;
+    _outputEnabled = enabled;
+    interrupts();
+}
+
+long StepPulseEngine::distanceToGo() const {
+    return _targetPosition - _position;
+}
+
+long StepPulseEngine::currentPosition() const {
+    return _position;
+}
+
+long StepPulseEngine::targetPosition() const {
+    return _targetPosition;
+}
+
+bool StepPulseEngine::isRunning() const {
+    return _targetPosition != _position;
+}
+
+bool StepPulseEngine::isWaiting() const {
+    return _timedPending != 0;
+}
+
+uint8_t StepPulseEngine::freeSlots() const {
+    uint8_t used = (uint8_t)((_head - _tail) & (STEP_ENGINE_QUEUE_SIZE - 1));
+    return (uint8_t)(STEP_ENGINE_QUEUE_SIZE - 1 - used);
+}
+
+uint32_t StepPulseEngine::tickCount() const {
+    return _tickCount;
+}
+
+void StepPulseEngine::setPulseObserver(PulseObserver observer) {
+    _pulseObserver = observer;
+}
+
+void StepPulseEngine::watchInput(InputReader reader, bool stopOnChange) {
+    noInterrupts();
+    _inputReader = reader;
+    _inputLevel = reader();
+    _stopOnInput = stopOnChange;
+    _inputLatched = false;
+    _latchedPosition = _position;
+    interrupts();
+}
+
+void StepPulseEngine::stopWatching() {
+    noInterrupts();
+    _inputReader = nullptr;
+    interrupts();
+}
+
+bool StepPulseEngine::pollInput() {
+    noInterrupts();
+    _checkInput();
+    interrupts();
+    return _inputLatched;
+}
+
+// Latches the position if the watched input has changed. Returns true on the change.
+bool StepPulseEngine::_checkInput() {
+    if (!_inputReader || _inputLatched || _inputReader() == _inputLevel) return false;
+    _inputLatched = true;
+    _latchedPosition = _position;
+    return true;
+}
+
+bool StepPulseEngine::onTimerTick(bool mayPulse) {
+    _tickCount++;
+
+    // End the pulse started on the previous tick
+    if (_stepHigh) {
+        _stepPin.write(LOW);
+        _stepHigh = false;
+    }
+
+    // Still waiting for the next pulse slot
+    if (_countdown > 1) {
+        _countdown--;
+        return false;
+    }
+    _countdown = 0;
+
+    if (_remaining == 0) {
+        if (_tail == _head) return false; // Idle
+
+        const StepCommand& command = _queue[_tail];
+        _intervalTicks = command.intervalTicks;
+        _remaining = command.count;
+        int8_t direction = command.direction;
+        int32_t wait = command.timed ? (int32_t)(command.startTick - _tickCount) : 0;
+        _awaitingStart = command.timed;
+        _tail = (uint8_t)((_tail + 1) & (STEP_ENGINE_QUEUE_SIZE - 1));
+
+        if (direction != _direction) {
+            // Change DIR now and pulse on the next tick at the earliest (A4988 DIR setup time)
+            _direction = direction;
+            _dirPin.write((direction > 0) ? HIGH : LOW);
+            if (wait < 1) wait = 1;
+        }
+        if (wait > 0) {
+            _countdown = (uint32_t)wait; // The pulse fires on tick startTick
+            return false;
+        }
+    }
+
+    // Hold the pulse while the driver is off or still waking up
+    if (!_outputEnabled) return false;
+    uint32_t sinceEnabled = _tickCount - _outputEnabledTick; // Wraps harmlessly: at worst one extra warm-up
+    if (sinceEnabled < _warmUpTicks) {
+        _countdown = _warmUpTicks - sinceEnabled;
+        return false;
+    }
+
+    // The input changed with the previous pulse: stop here if asked to
+    if (_checkInput() && _stopOnInput) {
+        _tail = _head;
+        _remaining = 0;
+        if (_awaitingStart) {
+            _awaitingStart = false;
+            _timedPending--;
+        }
+        return false;
+    }
+
+    // Pulse due. Held to the next tick if the timer's owner has used this tick's budget
+    // (see MotionGroup); _countdown stays 0, so it fires then.
+    if (!mayPulse) return true;
+
+    _stepPin.write(HIGH);
+    _stepHigh = true;
+    _position += _direction;
+    _remaining--;
+    _countdown = _intervalTicks;
+    if (_awaitingStart) {
+        _awaitingStart = false;
+        _timedPending--;
+    }
+
+    if (_pulseObserver) {
+        _pulseObserver(_tickCount, _direction);
+    }
+    return true;
+}
+
+uint32_t StepPulseEngine::quietTicks() const {
+    if (_stepHigh) return 0;
+    if (_countdown > 1) return _countdown - 1;
+    if (_remaining == 0 && _tail == _head) return 0xFFFFFFFFUL; // Idle until something is queued
+    return 0;
+}
+
+void StepPulseEngine::advanceTicks(uint32_t ticks) {
+    while (ticks > 0) {
+        if (!_stepHigh && _countdown > 1) {
+            // Skip straight to the tick before the next pulse slot
+            uint32_t skip = _countdown - 1;
+            if (skip > ticks) skip = ticks;
+            _countdown -= skip;
+            _tickCount += skip;
+            ticks -= skip;
+            continue;
+        }
+        if (!_stepHigh && _remaining == 0 && _tail == _head) {
+            // Nothing queued - the rest of the window is idle
+            _countdown = 0;
+            _tickCount += ticks;
+            return;
+        }
+        onTimerTick();
+        ticks--;
+    }
+}
+
+void StepPulseEngine::timerInterrupt() {
+    if (_activeEngine) {
+        _activeEngine->onTimerTick();
+    }
+}
+
+uint32_t StepPulseEngine::activeTickCount() {
+    return _activeEngine ? _activeEngine->_tickCount : 0;
+}
+
+// Host timer callback: elapsed ticks in bulk (the desktop harness simulates the timer)
+void StepPulseEngine::_hostTimerCallback(uint32_t ticks) {
+    if (_activeEngine) {
+        _activeEngine->advanceTicks(ticks);
+    }
+}
+
+#if defined(ARDUINO_ARCH_RENESAS)
+
+static FspTimer stepTimer;
+static StepPulseEngine::TimerTick stepTimerTick = nullptr;
+
+static void stepTimerIsr(timer_callback_args_t* args) {
+    (void)args;
+    stepTimerTick();
+}
+
+bool StepPulseEngine::startStepTimer(TimerTick tick, TimerAdvance advance) {
+    (void)advance;
+    uint8_t timerType = GPT_TIMER;
+    int8_t channel = FspTimer::get_available_timer(timerType);
+    if (channel < 0) {
+        channel = FspTimer::get_available_timer(timerType, true); // Borrow a PWM-reserved channel
+    }
+    if (channel < 0) return false;
+
+    stepTimerTick = tick;
+    const float frequencyHz = 1000000.0f / STEP_ENGINE_TICK_US;
+    if (!stepTimer.begin(TIMER_MODE_PERIODIC, timerType, channel, frequencyHz, 0.0f, stepTimerIsr)) return false;
+    if (!stepTimer.setup_overflow_irq()) return false;
+    if (!stepTimer.open()) return false;
+    return stepTimer.start();
+}
+
+#else
+
+// Host build: the desktop harness owns the simulated timer and delivers elapsed ticks in bulk
+bool StepPulseEngine::startStepTimer(TimerTick tick, TimerAdvance advance) {
+    (void)tick;
+    return hostAttachTimer(STEP_ENGINE_TICK_US, advance);
+}
+
+#endif
\ No newline at end of file
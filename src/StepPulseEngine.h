@@ -0,0 +1,171 @@
+/*
+ * Mechanical Clock with Onboard RTC - Timer-Driven Step Pulse Engine
+ * Copyright (C) 2024 iball
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEP_PULSE_ENGINE_H
+#define STEP_PULSE_ENGINE_H
+
+#include <Arduino.h>
+#include "FastPin.h" // STEP/DIR written from the ISR as single port stores
+
+// Timer tick period. Every pulse edge lands on a tick, so this is the pulse timing resolution.
+#define STEP_ENGINE_TICK_US 50
+#define STEP_ENGINE_TICKS_PER_SECOND (1000000UL / STEP_ENGINE_TICK_US)
+
+// Step command queue depth (must be a power of two, at most 128).
+// Deep enough to hold a whole catch-up acceleration ramp one pulse per entry.
+#define STEP_ENGINE_QUEUE_SIZE 64
+
+// Shortest pulse spacing: one tick STEP high, one tick STEP low
+#define STEP_ENGINE_MIN_INTERVAL_TICKS 2
+
+// A run of equally spaced pulses in one direction
+struct StepCommand {
+    uint32_t intervalTicks; // Timer ticks between consecutive pulses
+    uint16_t count;         // Number of pulses
+    int8_t direction;       // +1 = clockwise, -1 = anticlockwise
+    bool timed;             // First pulse waits for startTick
+    uint32_t startTick;     // Tick (see tickCount()) of the first pulse of a timed command
+};
+
+// Generates STEP/DIR pulses from a hardware timer interrupt.
+//
+// The main loop only queues step commands; the timer ISR pops them and
+// toggles the pins, so pulse timing does not depend on how long loop()
+// spends in the LCD, the state machine or blocking network calls.
+// On the UNO R4 the tick comes from a GPT timer (FspTimer). Host builds
+// use the simulated timer of the desktop harness, which delivers ticks in
+// bulk so long simulations stay fast.
+class StepPulseEngine {
+public:
+    typedef void (*PulseObserver)(uint32_t tick, int8_t direction);
+    typedef bool (*InputReader)(); // Level of a watched input (see watchInput())
+    typedef void (*TimerTick)();                  // One timer tick, from the ISR
+    typedef void (*TimerAdvance)(uint32_t ticks); // Elapsed ticks in bulk (host timer)
+
+private:
+    FastPinHandle _stepPin;
+    FastPinHandle _dirPin;
+
+    // Single-producer (loop) / single-consumer (ISR) ring buffer
+    StepCommand _queue[STEP_ENGINE_QUEUE_SIZE];
+    volatile uint8_t _head; // Next free slot (written by loop)
+    volatile uint8_t _tail; // Next command to run (written by ISR)
+
+    // ISR-owned pulse state
+    uint32_t _intervalTicks;     // Spacing of the active command
+    uint16_t _remaining;         // Pulses left in the active command
+    uint32_t _countdown;         // Ticks until the next pulse may fire
+    int8_t _direction;           // Level currently on the DIR pin
+    bool _awaitingStart;         // Active command is timed and its first pulse has not fired
+    bool _stepHigh;              // STEP pin is high (falls on the next tick)
+    volatile long _position;     // Pulses emitted (signed)
+    volatile uint32_t _tickCount; // Ticks since begin()
+
+    long _targetPosition;        // Position once the queue drains (written by loop)
+    volatile uint8_t _timedPending; // Timed commands queued or waiting whose first pulse has not fired
+
+    volatile bool _outputEnabled;        // Driver enabled: pulses may go out...
+    volatile uint32_t _outputEnabledTick; // ...once _warmUpTicks have passed since this tick
+    volatile uint32_t _warmUpTicks;
+
+    PulseObserver _pulseObserver;
+
+    // Watched input (homing sensor): the position it changed at, to the pulse
+    InputReader _inputReader;            // nullptr = not watching
+    bool _inputLevel;                    // Level when the watch started
+    bool _stopOnInput;                   // Drop the queue when it changes
+    volatile bool _inputLatched;
+    volatile long _latchedPosition;
+
+    static StepPulseEngine* _activeEngine; // Instance served by the timer ISR
+
+    bool _push(long steps, uint32_t intervalUs, bool timed, uint32_t startTick);
+    bool _checkInput();
+    static void _hostTimerCallback(uint32_t ticks);
+
+public:
+    StepPulseEngine(uint8_t stepPin, uint8_t dirPin);
+
+    // Configures the pins and starts the periodic timer. Returns false if no timer is free.
+    // With `startTimer` false only the pins are set up: whoever owns the timer calls
+    // onTimerTick() (see MotionGroup).
+    bool begin(bool startTimer = true);
+
+    // Starts the periodic step timer: `tick` runs on every tick on hardware; host builds call
+    // `advance` with the elapsed ticks instead. One step timer per firmware.
+    static bool startStepTimer(TimerTick tick, TimerAdvance advance);
+
+    // Queues `steps` pulses (sign gives direction) spaced `intervalUs` apart.
+    // Returns false if the queue has no room; nothing is queued in that case.
+    bool queueSteps(long steps, uint32_t intervalUs);
+
+    // As queueSteps(), but the first pulse fires on tick `startTick` of tickCount() (or on the
+    // tick the command is reached, if that is later). Later pulses follow `intervalUs` apart.
+    bool queueStepsAt(long steps, uint32_t startTick, uint32_t intervalUs);
+
+    // Drops every queued command; a pulse in progress completes
+    void clear();
+
+    // Whether the driver is enabled (default true). A pulse due while it is not waits until it
+    // is, plus `warmUpTicks`, so a late enable makes steps late rather than lost.
+    void setOutputEnabled(bool enabled, uint32_t warmUpTicks = 0);
+
+    long distanceToGo() const;
+    long currentPosition() const;
+    long targetPosition() const;
+    bool isRunning() const;
+    bool isWaiting() const; // A timed command has not reached its first pulse yet
+    uint8_t freeSlots() const;
+    uint32_t tickCount() const;
+
+    // Timer ISR body - one call per tick. Returns true if a pulse was due on this tick: emitted,
+    // or with `mayPulse` false held over to the next tick.
+    bool onTimerTick(bool mayPulse = true);
+
+    // Timer interrupt entry point (forwards to the engine that called begin())
+    static void timerInterrupt();
+
+    // tickCount() of the engine that called begin() (0 before that); safe from other ISRs
+    static uint32_t activeTickCount();
+
+    // Equivalent to `ticks` calls of onTimerTick(), but only does work around pulse edges
+    void advanceTicks(uint32_t ticks);
+
+    // Ticks from now on which onTimerTick() would do nothing but count (0xFFFFFFFF when idle)
+    uint32_t quietTicks() const;
+
+    // Called from the ISR on every pulse (simulation/measurement hook, keep it short)
+    void setPulseObserver(PulseObserver observer);
+
+    // Samples `reader` ahead of every pulse and latches the position the first time its level
+    // differs from the one it has now. With `stopOnChange` the ISR also drops every queued
+    // pulse at that moment, so a slow move stops on the change; call clear() afterwards.
+    // `reader` runs in the ISR: a digitalRead() and nothing more.
+    void watchInput(InputReader reader, bool stopOnChange);
+    void stopWatching();
+    bool isWatching() const { return _inputReader != nullptr; }
+
+    // Samples the watched input from loop(): the ISR only sees it ahead of a pulse, so a change
+    // made by the last pulse of a move is caught here. Returns inputLatched().
+    bool pollInput();
+
+    bool inputLatched() const { return _inputLatched; }
+    long latchedPosition() const { return _latchedPosition; } // First position with the new level
+};
+
+#endif // STEP_PULSE_ENGINE_H
@@ -85,7 +85,7 @@ bool calculateDST(RTCTime& utcTime, int timeZoneOffsetHours) {
         }
         // If current day is the first Sunday
         if (day == firstSundayDate) {
-            return hour < 2; // DST ends at 2 AM
+            return hour < 1; // DST ends at 2 AM daylight time, which is 1 AM standard time
         }
         return false; // After the first Sunday in November
     }
@@ -93,42 +93,75 @@ bool calculateDST(RTCTime& utcTime, int timeZoneOffsetHours) {
     return false; // Should not be reached
 }
 
-// Convert UTC time to local time
-RTCTime convertUTCToLocal(time_t utcTime, int timeZoneOffsetHours, bool useDST) {
-    time_t localTime = utcTime;
-    
-    // Apply timezone offset
-    localTime += (long)timeZoneOffsetHours * 3600L;
-    
-    // Apply DST if enabled
+// Offset of local time from UTC at a UTC instant
+long utcOffsetSeconds(time_t utcTime, int timeZoneOffsetHours, bool useDST) {
+    long offset = (long)timeZoneOffsetHours * 3600L;
     if (useDST) {
-        RTCTime tempTime(localTime);
+        RTCTime tempTime(utcTime); // calculateDST() expects UTC and applies the standard offset itself
         if (calculateDST(tempTime, timeZoneOffsetHours)) {
-            localTime += 3600L; // Add 1 hour for DST
+            offset += 3600L; // Add 1 hour for DST
         }
     }
+    return offset;
+}
+
+// UTC instant of a US DST change: the nth Sunday of the month at the given local standard hour
+static time_t usDstChangeUTC(int year, Month month, int sunday, int standardHour, int timeZoneOffsetHours) {
+    RTCTime firstOfMonth(1, month, year, standardHour, 0, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_INACTIVE);
+    time_t firstEpoch = firstOfMonth.getUnixTime();
+    RTCTime firstDay(firstEpoch); // Weekday worked out from the date
+    int firstSundayDate = 1 + (7 - DayOfWeek2int(firstDay.getDayOfWeek(), true)) % 7;
     
-    return RTCTime(localTime);
+    time_t localStandard = firstEpoch + (long)(firstSundayDate - 1 + 7 * (sunday - 1)) * 86400L;
+    return localStandard - (long)timeZoneOffsetHours * 3600L;
 }
 
-// Convert local time to UTC time
+// Next DST start (second Sunday in March, 2 AM standard) or end (first Sunday in
+// November, 2 AM daylight = 1 AM standard), matching calculateDST()
+time_t nextUtcOffsetChange(time_t utcTime, int timeZoneOffsetHours, bool useDST, long& newOffsetSeconds) {
+    newOffsetSeconds = utcOffsetSeconds(utcTime, timeZoneOffsetHours, useDST);
+    if (!useDST) {
+        return 0;
+    }
+    
+    RTCTime localStandard(utcTime + (long)timeZoneOffsetHours * 3600L);
+    for (int year = localStandard.getYear(); year <= localStandard.getYear() + 1; year++) {
+        time_t start = usDstChangeUTC(year, Month::MARCH, 2, 2, timeZoneOffsetHours);
+        if (start > utcTime) {
+            newOffsetSeconds = (long)timeZoneOffsetHours * 3600L + 3600L;
+            return start;
+        }
+        time_t end = usDstChangeUTC(year, Month::NOVEMBER, 1, 1, timeZoneOffsetHours);
+        if (end > utcTime) {
+            newOffsetSeconds = (long)timeZoneOffsetHours * 3600L;
+            return end;
+        }
+    }
+    return 0; // Not reached
+}
+
+// Convert UTC time to local time
+RTCTime convertUTCToLocal(time_t utcTime, int timeZoneOffsetHours, bool useDST) {
+    return RTCTime(utcTime + utcOffsetSeconds(utcTime, timeZoneOffsetHours, useDST));
+}
+
+// Convert local time to UTC time. calculateDST() works from UTC, so the DST check is made on
+// the UTC instants the local time could stand for, as in convertUTCToLocal(). Local times
+// that happen twice (the hour repeated when DST ends) give the first, daylight one; times
+// skipped when DST starts are read as standard time.
 time_t convertLocalToUTC(const RTCTime& localTime, int timeZoneOffsetHours, bool useDST) {
     // Create a non-const copy to call getUnixTime()
     RTCTime tempLocalTime = localTime;
-    time_t utcTime = tempLocalTime.getUnixTime();
-    
-    // Remove DST if it was applied
+    time_t standardUtc = tempLocalTime.getUnixTime() - (long)timeZoneOffsetHours * 3600L;
+
     if (useDST) {
-        RTCTime tempTime(utcTime);
+        time_t daylightUtc = standardUtc - 3600L;
+        RTCTime tempTime(daylightUtc);
         if (calculateDST(tempTime, timeZoneOffsetHours)) {
-            utcTime -= 3600L; // Remove 1 hour for DST
+            return daylightUtc;
         }
     }
-    
-    // Remove timezone offset
-    utcTime -= (long)timeZoneOffsetHours * 3600L;
-    
-    return utcTime;
+    return standardUtc;
 }
 
 // Get current UTC time from RTC (assuming RTC stores UTC)
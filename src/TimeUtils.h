@@ -19,6 +19,13 @@ extern const char* const DOW_ABBREV[];
 // For a fully robust solution, this might need more sophisticated timezone data.
 bool calculateDST(RTCTime& time, int timeZoneOffsetHours); 
 
+// Offset of local time from UTC in seconds at a UTC instant (standard offset, plus an hour while DST is active)
+long utcOffsetSeconds(time_t utcTime, int timeZoneOffsetHours, bool useDST);
+
+// UTC instant of the next DST start or end after utcTime, or 0 if the offset never changes.
+// newOffsetSeconds receives the utcOffsetSeconds() that applies from that instant.
+time_t nextUtcOffsetChange(time_t utcTime, int timeZoneOffsetHours, bool useDST, long& newOffsetSeconds);
+
 // UTC/Local time conversion functions
 RTCTime convertUTCToLocal(time_t utcTime, int timeZoneOffsetHours, bool useDST);
 time_t convertLocalToUTC(const RTCTime& localTime, int timeZoneOffsetHours, bool useDST);
@@ -94,7 +94,7 @@ NetworkManager networkManager(AP_SSID, IPAddress(129, 6, 15, 28), 2390, WIFI_CON
 
 // Mechanical Clock (drives the stepper motor and manages hand positions)
 MechanicalClock mechanicalClock(
-    STEP_PIN, DIR_PIN, ENABLE_PIN, MS1_PIN, MS2_PIN, MS3_PIN, LED_PIN,
+    STEP_PIN, DIR_PIN,
     RTC, lcdDisplay // Pass references to the global RTC and our LCDDisplay object
 );
 
@@ -149,17 +149,17 @@ void setup() {
     attachInterrupt(digitalPinToInterrupt(POWER_PIN), PowerOffISR, FALLING); // Trigger on falling edge
     Serial.println("Power-off interrupt configured.");
 
-    // --- MechanicalClock Initialization ---
-    mechanicalClock.begin(); // Initializes stepper pins, microstepping, etc.
-    Serial.println("MechanicalClock initialized.");
-
-
-
     // --- NetworkManager Initialization ---
     // NetworkManager's begin() will load credentials and timezone from EEPROM
     networkManager.begin(); 
     Serial.println("NetworkManager initialized.");
 
+    // --- MechanicalClock Initialization ---
+    // The dial shows local time; power recovery needs the time zone to know what it showed
+    mechanicalClock.setTimeZone(networkManager.getTimeZoneOffset(), networkManager.getUseDST());
+    mechanicalClock.begin(); // Initializes stepper pins, microstepping, etc.
+    Serial.println("MechanicalClock initialized.");
+
     // --- Initial State Transition ---
     // If we are already in an error state from initial hardware checks, stick with it.
     if (stateManager.getCurrentState() == STATE_INIT) { // Only transition from INIT if not already ERROR
@@ -0,0 +1,118 @@
+// Command-line front end for the MechanicalClock time-warp simulator (sim/ClockSimulator.h).
+//
+//   clock_simulator [--days N] [--drift PPM] [--ntp-hours H] [--loop-ms MS]
+//                   [--sample S] [--outage HOURS:MINUTES[:isr]]... [--csv FILE]
+//                   [--start UNIX_UTC] [--tz HOURS[:dst]] [--schedule on|off]
+//                   [--driver-hold-off MS] [--sweep on|off] [--boot-sync S]
+//                   [--rtc-backup on|off]
+//
+// Writes one CSV row of hand error against true time per sample (stdout by
+// default) and a summary on stderr.
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim/ClockSimulator.h"
+
+static const time_t START_TIME = 1753577342;
+
+static void usage() {
+    fprintf(stderr, "usage: clock_simulator [--days N] [--drift PPM] [--ntp-hours H] [--loop-ms MS]\n"
+                    "                       [--sample S] [--outage HOURS:MINUTES[:isr]]... [--csv FILE]\n"
+                    "                       [--start UNIX_UTC] [--tz HOURS[:dst]] [--schedule on|off]\n"
+                    "                       [--driver-hold-off MS] [--sweep on|off] [--boot-sync S]\n"
+                    "                       [--rtc-backup on|off]\n");
+}
+
+int main(int argc, char** argv) {
+    double days = 7.0;
+    long driftPpm = 0;
+    double ntpHours = 1.0;
+    uint32_t loopMs = 20;
+    uint32_t sampleSeconds = 60;
+    const char* csvPath = nullptr;
+    time_t startTime = START_TIME;
+    int timeZoneHours = 0;
+    bool useDst = false;
+    bool stepScheduling = true;
+    bool sweepMode = false;
+    long bootSyncSeconds = -1; // NTP at power-up: none
+    bool rtcBackup = true;
+    DriverPowerConfig driverPower = DriverPowerPolicy::defaultConfig();
+
+    struct { uint32_t at, length; bool isr; } outages[SIMULATOR_MAX_OUTAGES];
+    int outageCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (value == nullptr) { usage(); return 1; }
+        if (!strcmp(arg, "--days")) days = atof(value);
+        else if (!strcmp(arg, "--drift")) driftPpm = atol(value);
+        else if (!strcmp(arg, "--ntp-hours")) ntpHours = atof(value);
+        else if (!strcmp(arg, "--loop-ms")) loopMs = (uint32_t)atol(value);
+        else if (!strcmp(arg, "--sample")) sampleSeconds = (uint32_t)atol(value);
+        else if (!strcmp(arg, "--csv")) csvPath = value;
+        else if (!strcmp(arg, "--start")) startTime = (time_t)atoll(value);
+        else if (!strcmp(arg, "--tz")) {
+            timeZoneHours = atoi(value);
+            useDst = (strstr(value, ":dst") != nullptr);
+        }
+        else if (!strcmp(arg, "--schedule")) stepScheduling = strcmp(value, "off") != 0;
+        else if (!strcmp(arg, "--sweep")) sweepMode = strcmp(value, "on") == 0;
+        else if (!strcmp(arg, "--boot-sync")) bootSyncSeconds = atol(value);
+        else if (!strcmp(arg, "--rtc-backup")) rtcBackup = strcmp(value, "off") != 0;
+        else if (!strcmp(arg, "--driver-hold-off")) driverPower.holdOffMs = (uint32_t)atol(value);
+        else if (!strcmp(arg, "--outage") && outageCount < SIMULATOR_MAX_OUTAGES) {
+            double hours = 0.0, minutes = 0.0;
+            if (sscanf(value, "%lf:%lf", &hours, &minutes) != 2) { usage(); return 1; }
+            outages[outageCount].at = (uint32_t)(hours * 3600.0);
+            outages[outageCount].length = (uint32_t)(minutes * 60.0);
+            outages[outageCount].isr = (strstr(value, ":isr") != nullptr);
+            outageCount++;
+        } else { usage(); return 1; }
+        i++;
+    }
+
+    FILE* csv = csvPath ? fopen(csvPath, "w") : stdout;
+    if (csv == nullptr) { perror(csvPath); return 1; }
+
+    ClockSimulator sim(startTime, timeZoneHours, useDst);
+    sim.setRtcDriftPpm(driftPpm);
+    sim.setNtpInterval((uint32_t)(ntpHours * 3600.0));
+    sim.setLoopPeriod(loopMs);
+    sim.setStepScheduling(stepScheduling);
+    sim.setSweepMode(sweepMode);
+    if (bootSyncSeconds >= 0) sim.setBootSync((uint32_t)bootSyncSeconds);
+    sim.setRtcBackup(rtcBackup);
+    sim.setDriverPowerConfig(driverPower);
+    sim.setCsvOutput(csv, sampleSeconds);
+    for (int i = 0; i < outageCount; i++) sim.scheduleOutage(outages[i].at, outages[i].length, outages[i].isr);
+
+    auto begin = std::chrono::steady_clock::now();
+    sim.run((uint32_t)(days * 86400.0));
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (csv != stdout) fclose(csv);
+
+    const SimulatorStats& s = sim.stats();
+    fprintf(stderr, "Simulated %.1f days in %.2f s (%.0fx real time)\n", days, wallSeconds, days * 86400.0 / wallSeconds);
+    fprintf(stderr, "Hand error: worst lag %.2f s, worst lead %.2f s, final %.2f s\n",
+            s.worstLagSeconds, s.worstLeadSeconds, sim.handErrorSeconds());
+    fprintf(stderr, "Steps: %lu (%lu reverse), direction changes %lu, largest burst %lu, missed %lu, off-grid %lu\n",
+            s.steps, s.reverseSteps, s.directionChanges, s.largestBurst, s.missedSteps, s.offGridSteps);
+    fprintf(stderr, "Power-ups: %lu, time to correct dial %.2f s (last), %.2f s (worst)\n",
+            s.boots, s.lastBootSettleSeconds, s.worstBootSettleSeconds);
+    fprintf(stderr, "Catch-up time saved by coarse steps: %.1f s\n", s.catchUpTimeSavedMs / 1000.0);
+    fprintf(stderr, "DST changes: %lu (%lu planned moves), longest settle %.2f s\n",
+            s.dstChanges, sim.clock().getDstJumps(), s.worstDstSettleSeconds);
+    fprintf(stderr, "Step phase error: %lu steps, p50 %.1f ms, p99 %.1f ms, max %.2f ms, mean %+.2f ms\n",
+            s.phaseSamples, sim.phaseErrorPercentileMs(0.5), sim.phaseErrorPercentileMs(0.99),
+            s.worstPhaseErrorMs, s.meanPhaseErrorMs);
+    fprintf(stderr, "Step interval: %lu intervals, worst %.2f ms off nominal\n", s.intervalSamples, s.worstIntervalErrorMs);
+    fprintf(stderr, "EEPROM journal records: %lu since last boot\n", sim.clock().getJournalWrites());
+    char driverSummary[96];
+    DriverPowerPolicy::formatSummary(sim.clock().getDriverPowerStats(), driverSummary, sizeof(driverSummary));
+    fprintf(stderr, "Stepper %s since last boot\n", driverSummary);
+    return 0;
+}
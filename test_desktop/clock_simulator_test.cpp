@@ -0,0 +1,369 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <stdio.h>
+
+// Time-warp simulator: the real MechanicalClock on virtual time, motor and RTC
+#include "sim/ClockSimulator.h"
+#include "TimeUtils.h"
+
+static const time_t START_TIME = 1753577342;
+static const double STEP_SECONDS = 1.125;     // Time keeping in 1/16 steps through the 12:1 gear train
+static const double FULL_STEP_SECONDS = 18.0; // Catch-up moves in full steps
+static const uint32_t DAY = 86400;
+static const uint32_t LOOP_PERIOD_MS = 50;
+
+// Lag allowance: one time-keeping step, the RTC's whole-second resolution and a loop pass
+static const double MAX_LAG_SECONDS = STEP_SECONDS + 1.0 + 0.1;
+
+static void printStats(const char* label, ClockSimulator& sim) {
+    const SimulatorStats& s = sim.stats();
+    std::cout << "  " << label << ": lag " << s.worstLagSeconds << " s, lead " << s.worstLeadSeconds
+              << " s, " << s.steps << " steps, largest burst " << s.largestBurst
+              << ", direction changes " << s.directionChanges << std::endl;
+}
+
+// Two weeks with a fast RTC and hourly NTP: the hands never drift beyond one step
+TEST(ClockSimulatorTest, HourlyNtpHoldsDriftingRtc) {
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    sim.setRtcDriftPpm(50);
+    sim.setNtpInterval(3600);
+    sim.run(14 * DAY);
+    printStats("50 ppm, hourly NTP", sim);
+
+    const SimulatorStats& s = sim.stats();
+    EXPECT_LT(s.worstLagSeconds, MAX_LAG_SECONDS);
+    EXPECT_LT(s.worstLeadSeconds, 0.5); // 50 ppm of an hour
+    EXPECT_EQ(s.largestBurst, 1u);     // Corrections are absorbed without bursts...
+    EXPECT_EQ(s.directionChanges, 0u); // ...or reversals
+    EXPECT_EQ(s.missedSteps, 0u);
+    EXPECT_NEAR((double)s.steps, 14.0 * DAY / STEP_SECONDS, 32.0);
+}
+
+// Without NTP the simulator shows the RTC error going straight onto the dial
+TEST(ClockSimulatorTest, FreeRunningRtcDriftReachesTheDial) {
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    sim.setRtcDriftPpm(100);
+    sim.run(7 * DAY);
+    printStats("100 ppm, no NTP", sim);
+
+    double drift = 7.0 * DAY * 100e-6; // 60.5 s
+    EXPECT_NEAR(sim.handErrorSeconds(), drift, STEP_SECONDS + 1.0);
+    EXPECT_NEAR(sim.stats().worstLeadSeconds, drift, 1.0);
+}
+
+// A two-hour outage with the power-off interrupt: one full-step catch-up burst
+// (plus the 1/16 steps onto and off the full-step grid), then back within a step
+TEST(ClockSimulatorTest, OutageRecovery) {
+    ClockSimulator sim(START_TIME);
+    sim.setNtpInterval(3600);
+    sim.scheduleOutage(DAY, 2 * 3600, true);
+    sim.run(DAY + 2 * 3600 + 60);
+    printStats("2 h outage", sim);
+    EXPECT_NEAR((double)sim.stats().largestBurst, 2.0 * 3600 / FULL_STEP_SECONDS, 32.0);
+    EXPECT_EQ(sim.stats().directionChanges, 0u);
+    EXPECT_EQ(sim.stats().offGridSteps, 0u); // Every full step started on the full-step grid
+
+    // Settled: the rest of the day looks like normal running
+    sim.resetStats();
+    sim.run(DAY);
+    EXPECT_LT(sim.stats().worstLagSeconds, MAX_LAG_SECONDS);
+    EXPECT_LT(sim.stats().worstLeadSeconds, 0.1);
+    EXPECT_EQ(sim.stats().largestBurst, 1u);
+}
+
+// Without the interrupt the journal is up to one interval stale, which stays on the dial
+TEST(ClockSimulatorTest, OutageRecoveryWithoutPowerOffIsr) {
+    ClockSimulator sim(START_TIME);
+    sim.setNtpInterval(3600);
+    sim.scheduleOutage(DAY + 1234, 2 * 3600, false);
+    sim.run(DAY + 1234 + 2 * 3600 + 60);
+
+    sim.resetStats();
+    sim.run(DAY);
+    printStats("2 h outage, no ISR", sim);
+    EXPECT_LT(sim.stats().worstLagSeconds, MAX_LAG_SECONDS);
+    EXPECT_LT(sim.stats().worstLeadSeconds, HAND_JOURNAL_MIN_INTERVAL_MS / 1000.0 + 0.1);
+}
+
+// Power comes back and WiFi plus NTP take 90 s. An RTC that kept running on its backup supply
+// puts the hands right within seconds; NTP then only trims the drift of the outage (100 ppm of
+// six hours, two fine steps). The previous firmware left the hands wrong until NTP answered.
+TEST(ClockSimulatorTest, BootCatchUpFromRtcBeforeNtp) {
+    const uint32_t outage = 6 * 3600 - 600;
+    const uint32_t bootSync = 90;
+    double settleSeconds[2] = {0.0, 0.0};
+    for (bool fromRtc : {true, false}) {
+        ClockSimulator sim(START_TIME); // One at a time: they share the virtual world
+        sim.setLoopPeriod(LOOP_PERIOD_MS);
+        sim.setRtcDriftPpm(100);
+        sim.setNtpInterval(3600);
+        sim.setBootSync(bootSync);
+        sim.setRecoverFromRtc(fromRtc);
+        sim.scheduleOutage(3600, outage, true);
+        sim.run(3600 + outage + 60);
+        EXPECT_EQ(sim.stats().boots, 1u);
+        long positionBeforeSync = sim.motor().position();
+        sim.run(bootSync);
+        settleSeconds[fromRtc ? 0 : 1] = sim.stats().lastBootSettleSeconds;
+        if (!fromRtc) break;
+
+        long syncCorrection = sim.motor().position() - positionBeforeSync - lround(bootSync / STEP_SECONDS);
+        std::cout << "  Correction when NTP answers: " << syncCorrection << " steps" << std::endl;
+        EXPECT_LE(labs(syncCorrection), 3);
+        EXPECT_LT(fabs(sim.handErrorSeconds()), MAX_LAG_SECONDS);
+        EXPECT_EQ(sim.stats().directionChanges, 0u);
+    }
+    std::cout << "  Time to correct dial: " << settleSeconds[0] << " s from the RTC, " << settleSeconds[1]
+              << " s waiting for NTP" << std::endl;
+    EXPECT_LT(settleSeconds[0], 10.0); // Catch-up of most of a dial at full-step speed
+    EXPECT_GT(settleSeconds[1], (double)bootSync);
+}
+
+// An RTC without its backup supply restarts in 2000: the hands stay put until NTP has set it,
+// rather than chasing the reset date
+TEST(ClockSimulatorTest, BootWithResetRtcWaitsForNtp) {
+    const uint32_t bootSync = 90;
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    sim.setNtpInterval(3600);
+    sim.setBootSync(bootSync);
+    sim.setRtcBackup(false);
+    sim.scheduleOutage(3600, 2 * 3600, true);
+    sim.run(3600 + 2 * 3600 + 1);
+    long stopped = sim.motor().position();
+    sim.run(bootSync - 2);
+    EXPECT_EQ(sim.motor().position(), stopped);
+
+    sim.run(60);
+    std::cout << "  Time to correct dial with a reset RTC: " << sim.stats().lastBootSettleSeconds << " s" << std::endl;
+    EXPECT_GT(sim.stats().lastBootSettleSeconds, (double)bootSync);
+    EXPECT_LT(sim.stats().lastBootSettleSeconds, bootSync + 10.0);
+    EXPECT_LT(fabs(sim.handErrorSeconds()), MAX_LAG_SECONDS);
+    EXPECT_EQ(sim.stats().reverseSteps, 0u);
+}
+
+// Full steps for the catch-up: a 12-hour-scale move is over in seconds rather than the
+// half a minute the same pulse rate needs in 1/16 steps
+TEST(ClockSimulatorTest, FullStepCatchUpSavesTime) {
+    ClockSimulator sim(START_TIME);
+    sim.scheduleOutage(3600 + 7, 2 * 3600, true);
+    sim.run(3600 + 7 + 2 * 3600 - 1);
+    sim.resetStats();
+
+    sim.run(6);
+    std::cout << "  Catch-up time saved: " << sim.stats().catchUpTimeSavedMs << " ms" << std::endl;
+    EXPECT_GT(sim.stats().catchUpTimeSavedMs, 25000u);
+    EXPECT_EQ(sim.stats().offGridSteps, 0u);
+    EXPECT_EQ(sim.clock().getActiveMicrostepMode(), CURRENT_MICROSTEP); // Back to fine steps
+    EXPECT_LT(sim.handErrorSeconds(), STEP_SECONDS);
+    EXPECT_GT(sim.handErrorSeconds(), -MAX_LAG_SECONDS);
+}
+
+// One CSV row per sample, hand error in the fourth column
+TEST(ClockSimulatorTest, CsvOutput) {
+    FILE* csv = tmpfile();
+    ASSERT_NE(csv, nullptr);
+
+    ClockSimulator sim(START_TIME);
+    sim.setCsvOutput(csv, 60);
+    sim.run(3600);
+
+    rewind(csv);
+    char line[256];
+    ASSERT_NE(fgets(line, sizeof(line), csv), nullptr);
+    EXPECT_EQ(strncmp(line, "elapsed_s,true_utc,rtc_utc,hand_error_s,", 40), 0);
+
+    int rows = 0;
+    double elapsed, trueUtc, error;
+    long long rtc;
+    while (fgets(line, sizeof(line), csv)) {
+        ASSERT_EQ(sscanf(line, "%lf,%lf,%lld,%lf", &elapsed, &trueUtc, &rtc, &error), 4);
+        EXPECT_LE(error, 0.0);
+        EXPECT_GT(error, -STEP_SECONDS - 0.5);
+        rows++;
+    }
+    EXPECT_EQ(rows, 60);
+    fclose(csv);
+}
+
+// The point of the exercise: weeks of running in well under a second per simulated week
+TEST(ClockSimulatorTest, RunsFarFasterThanRealTime) {
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    auto begin = clock();
+    sim.run(7 * DAY);
+    double cpuSeconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    std::cout << "  One week in " << cpuSeconds << " s (" << 7.0 * DAY / cpuSeconds << "x real time)" << std::endl;
+    EXPECT_LT(cpuSeconds, 7.0 * DAY / 1000.0);
+}
+
+// Both US changes over four years on Eastern time: the dial follows local time and
+// each change runs as the planned one-hour move from the second it happens
+TEST(ClockSimulatorTest, DstChangesAcrossYears) {
+    struct DstChange {
+        time_t utc;
+        long shiftSeconds;
+    };
+    const DstChange changes[] = {
+        {1741503600, 3600}, {1762063200, -3600}, // 2025: 9 Mar, 2 Nov
+        {1772953200, 3600}, {1793512800, -3600}, // 2026: 8 Mar, 1 Nov
+        {1805007600, 3600}, {1825567200, -3600}, // 2027: 14 Mar, 7 Nov
+        {1836457200, 3600}, {1857016800, -3600}, // 2028: 12 Mar, 5 Nov
+    };
+
+    for (const DstChange& change : changes) {
+        // TimeUtils (and so the LCD) changes on the same second
+        EXPECT_EQ(utcOffsetSeconds(change.utc, -5, true) - utcOffsetSeconds(change.utc - 1, -5, true), change.shiftSeconds);
+
+        ClockSimulator sim(change.utc - 600, -5, true);
+        sim.setLoopPeriod(LOOP_PERIOD_MS);
+        sim.run(599);
+        ASSERT_EQ(sim.clock().getNextDstChangeUTC(), change.utc); // Planned ahead of time
+        EXPECT_EQ(sim.clock().getDstJumps(), 0u);
+        long offsetBefore = sim.clock().getUtcOffsetSeconds();
+
+        sim.resetStats();
+        sim.run(600);
+        const SimulatorStats& s = sim.stats();
+        std::cout << "  " << change.utc << " (" << (change.shiftSeconds > 0 ? "+" : "-") << "1 h): settled in "
+                  << s.worstDstSettleSeconds << " s, " << s.reverseSteps << " reverse steps, lag "
+                  << s.worstLagSeconds << " s" << std::endl;
+
+        EXPECT_EQ(s.dstChanges, 1u);
+        EXPECT_EQ(sim.clock().getDstJumps(), 1u);
+        EXPECT_EQ(sim.clock().getUtcOffsetSeconds() - offsetBefore, change.shiftSeconds);
+        EXPECT_GT(sim.clock().getNextDstChangeUTC(), change.utc);
+        EXPECT_LT(s.worstDstSettleSeconds, 3.0); // 200 full steps plus the fine steps either side
+        EXPECT_EQ(s.offGridSteps, 0u);
+        EXPECT_LT(s.worstLagSeconds, MAX_LAG_SECONDS);
+        EXPECT_LT(s.worstLeadSeconds, 0.5);
+        if (change.shiftSeconds < 0) {
+            EXPECT_LE(s.reverseSteps, 200u + MechanicalClock::CATCHUP_STEP_MICROSTEPS);
+        } else {
+            EXPECT_EQ(s.reverseSteps, 0u);
+        }
+    }
+}
+
+// Time-keeping steps fire on the RTC instant they are due, not when loop() next looks:
+// a day of hourly NTP, every isolated step timed against true local time
+TEST(ClockSimulatorTest, TimedStepsHitTheirDeadlines) {
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    sim.setNtpInterval(3600);
+    sim.run(DAY);
+    const SimulatorStats& s = sim.stats();
+    std::cout << "  Scheduled: " << s.phaseSamples << " steps, p50 " << sim.phaseErrorPercentileMs(0.5) << " ms, p99 "
+              << sim.phaseErrorPercentileMs(0.99) << " ms, max " << s.worstPhaseErrorMs << " ms" << std::endl;
+    EXPECT_GT(s.phaseSamples, (unsigned long)(0.95 * DAY / STEP_SECONDS));
+    EXPECT_LT(sim.phaseErrorPercentileMs(0.99), 1.0);
+    EXPECT_LT(s.worstPhaseErrorMs, 10.0);
+    EXPECT_EQ(s.largestBurst, 1u);
+
+    // Reference: steps go out when an update finds them due, up to a second and a loop pass late
+    ClockSimulator polled(START_TIME);
+    polled.setLoopPeriod(LOOP_PERIOD_MS);
+    polled.setNtpInterval(3600);
+    polled.setStepScheduling(false);
+    polled.run(DAY);
+    std::cout << "  Polled: p50 " << polled.phaseErrorPercentileMs(0.5) << " ms, p99 "
+              << polled.phaseErrorPercentileMs(0.99) << " ms, max " << polled.stats().worstPhaseErrorMs << " ms" << std::endl;
+    EXPECT_GT(polled.phaseErrorPercentileMs(0.5), 100.0);
+}
+
+// Sweep mode keeps one even pulse train. With a fast RTC and hourly NTP every correction moves
+// the RTC back by up to 360 ms: scheduled steps take that in one shortened interval, the sweep
+// slews it off over many steps without ever changing the interval by more than 0.5%.
+TEST(ClockSimulatorTest, SweepModeSlewsRtcCorrections) {
+    const long driftPpm = 100;
+    ClockSimulator scheduled(START_TIME);
+    scheduled.setLoopPeriod(LOOP_PERIOD_MS);
+    scheduled.setRtcDriftPpm(driftPpm);
+    scheduled.setNtpInterval(3600);
+    scheduled.run(DAY);
+
+    ClockSimulator sweep(START_TIME);
+    sweep.setLoopPeriod(LOOP_PERIOD_MS);
+    sweep.setRtcDriftPpm(driftPpm);
+    sweep.setNtpInterval(3600);
+    sweep.setSweepMode(true);
+    sweep.run(DAY);
+
+    for (ClockSimulator* sim : {&scheduled, &sweep}) {
+        const SimulatorStats& s = sim->stats();
+        std::cout << "  " << (sim == &sweep ? "Sweep" : "Scheduled") << ": " << s.intervalSamples
+                  << " intervals, worst " << s.worstIntervalErrorMs << " ms off nominal; phase p50 "
+                  << sim->phaseErrorPercentileMs(0.5) << " ms, p99 " << sim->phaseErrorPercentileMs(0.99)
+                  << " ms, max " << s.worstPhaseErrorMs << " ms" << std::endl;
+        EXPECT_GT(s.intervalSamples, (unsigned long)(0.95 * DAY / STEP_SECONDS));
+        EXPECT_EQ(s.largestBurst, 1u);
+        EXPECT_EQ(s.directionChanges, 0u);
+    }
+
+    const double maxSlewMs = STEP_SECONDS * 1000.0 * SWEEP_MAX_SLEW_PPM / 1e6;
+    EXPECT_GT(scheduled.stats().worstIntervalErrorMs, 300.0);
+    EXPECT_LE(sweep.stats().worstIntervalErrorMs, maxSlewMs + STEP_ENGINE_TICK_US / 1000.0);
+    // The hands follow the RTC, which is up to 360 ms fast by the end of each hour either way
+    EXPECT_LT(sweep.phaseErrorPercentileMs(0.99), 400.0);
+    EXPECT_LT(sweep.stats().worstPhaseErrorMs, 400.0);
+    EXPECT_LT(sweep.stats().worstLagSeconds, MAX_LAG_SECONDS);
+}
+
+// One large correction: the RTC has gained or lost 720 ms when NTP sets it. The sweep slews
+// the hands back onto it within a few minutes and then holds them on the RTC to the tick.
+TEST(ClockSimulatorTest, SweepModeLocksBackOntoTheRtc) {
+    for (long driftPpm : {200L, -200L}) {
+        ClockSimulator sim(START_TIME);
+        sim.setLoopPeriod(LOOP_PERIOD_MS);
+        sim.setSweepMode(true);
+        sim.setRtcDriftPpm(driftPpm);
+        sim.run(3600);
+        sim.setRtcDriftPpm(0); // 720 ms off from here on, and the hands with it
+        sim.resetStats();
+        sim.run(600);
+        EXPECT_NEAR(sim.stats().meanPhaseErrorMs, -3.6 * driftPpm, 1.0); // Early when the RTC is fast
+
+        sim.setNtpInterval(60);
+        sim.run(61);
+        sim.setNtpInterval(0);
+        sim.resetStats();
+        sim.run(600);
+        const SimulatorStats& slew = sim.stats();
+        std::cout << "  " << driftPpm << " ppm, slewing 720 ms: worst interval error " << slew.worstIntervalErrorMs
+                  << " ms" << std::endl;
+        EXPECT_LE(slew.worstIntervalErrorMs, STEP_SECONDS * 1000.0 * SWEEP_MAX_SLEW_PPM / 1e6 + STEP_ENGINE_TICK_US / 1000.0);
+        EXPECT_EQ(slew.largestBurst, 1u);
+        EXPECT_EQ(slew.directionChanges, 0u);
+
+        sim.resetStats();
+        sim.run(3600);
+        const SimulatorStats& locked = sim.stats();
+        std::cout << "  " << driftPpm << " ppm, locked: phase max " << locked.worstPhaseErrorMs
+                  << " ms, worst interval error " << locked.worstIntervalErrorMs << " ms" << std::endl;
+        EXPECT_LE(locked.worstPhaseErrorMs, STEP_ENGINE_TICK_US / 1000.0);
+        EXPECT_LE(locked.worstIntervalErrorMs, STEP_ENGINE_TICK_US / 1000.0);
+    }
+}
+
+// On a steady RTC the sweep is exact: every interval is the nominal one and every step is on
+// its due tick
+TEST(ClockSimulatorTest, SweepModeSteadyRtc) {
+    ClockSimulator sim(START_TIME);
+    sim.setLoopPeriod(LOOP_PERIOD_MS);
+    sim.setSweepMode(true);
+    sim.run(DAY);
+    const SimulatorStats& s = sim.stats();
+    std::cout << "  Steady sweep: worst interval error " << s.worstIntervalErrorMs << " ms, phase p99 "
+              << sim.phaseErrorPercentileMs(0.99) << " ms, max " << s.worstPhaseErrorMs << " ms" << std::endl;
+    EXPECT_GT(s.intervalSamples, (unsigned long)(0.95 * DAY / STEP_SECONDS));
+    EXPECT_LE(s.worstIntervalErrorMs, STEP_ENGINE_TICK_US / 1000.0);
+    EXPECT_LT(s.worstPhaseErrorMs, 1.0);
+    EXPECT_EQ(sim.clock().getSweepSlewTicks(), 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
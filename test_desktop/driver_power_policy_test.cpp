@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "DriverPowerPolicy.h"
+
+static const long STEP_MS = 1125; // One 1/16 time-keeping step
+
+// --- The policy on its own ---
+
+TEST(DriverPowerPolicyTest, EnableWindows) {
+    DriverPowerConfig config = DriverPowerPolicy::defaultConfig();
+    config.preEnableMs = 30;
+    config.postDisableMs = 100;
+    config.holdOffMs = 500;
+    DriverPowerPolicy policy(config);
+    policy.begin(0);
+
+    EXPECT_TRUE(policy.wantEnabled(1000, true, 0));    // Pulses going out
+    EXPECT_TRUE(policy.wantEnabled(1099, false, -1));  // Settling after the last one
+    EXPECT_FALSE(policy.wantEnabled(1100, false, 400)); // Gap (500 ms) long enough to release
+    EXPECT_TRUE(policy.wantEnabled(1100, false, 399));  // Too short to bother
+    config.holdOffMs = 0;
+    policy.setConfig(config);
+    EXPECT_FALSE(policy.wantEnabled(1100, false, 31));
+    EXPECT_TRUE(policy.wantEnabled(1100, false, 30));   // Wake-up ahead of the step
+    EXPECT_FALSE(policy.wantEnabled(1100, false, -1));  // Nothing known to be coming
+}
+
+// Next step not known (before the first RTC tick, or just after a move): held through the
+// hold-off, rather than released after every pulse and woken again for the next
+TEST(DriverPowerPolicyTest, UnknownNextStepHoldsForTheHoldOff) {
+    DriverPowerConfig config = DriverPowerPolicy::defaultConfig();
+    config.preEnableMs = 30;
+    config.postDisableMs = 100;
+    config.holdOffMs = 500;
+    DriverPowerPolicy policy(config);
+    policy.begin(0);
+
+    EXPECT_TRUE(policy.wantEnabled(1000, true, 0));
+    EXPECT_TRUE(policy.wantEnabled(1100, false, -1));
+    EXPECT_TRUE(policy.wantEnabled(1499, false, -1));
+    EXPECT_FALSE(policy.wantEnabled(1500, false, -1)); // Hold-off over
+    EXPECT_FALSE(policy.wantEnabled(1500, false, 500)); // A known step: the whole gap counts
+    EXPECT_TRUE(policy.wantEnabled(1500, false, 30));   // ...and the wake-up ahead of it
+
+    // A hold-off shorter than the wake-up: the wake-up still applies to a known step
+    config.holdOffMs = 10;
+    policy.setConfig(config);
+    EXPECT_TRUE(policy.wantEnabled(1500, false, 30));
+    EXPECT_FALSE(policy.wantEnabled(1500, false, 31));
+}
+
+// Updates 50 ms apart: the driver wakes on the last one that still leaves the wake-up before
+// the step, not on one that finds the step already due
+TEST(DriverPowerPolicyTest, WakeUpAllowsForTheUpdateInterval) {
+    DriverPowerConfig config = DriverPowerPolicy::defaultConfig();
+    config.preEnableMs = 30;
+    config.postDisableMs = 100;
+    config.holdOffMs = 0;
+    DriverPowerPolicy policy(config);
+    policy.begin(0);
+
+    EXPECT_TRUE(policy.wantEnabled(1000, true, 0));
+    EXPECT_TRUE(policy.wantEnabled(1050, false, -1));
+    EXPECT_FALSE(policy.wantEnabled(1100, false, 131));
+    EXPECT_FALSE(policy.wantEnabled(1150, false, 81)); // The next update is still 31 ms ahead
+    EXPECT_TRUE(policy.wantEnabled(1200, false, 31));
+    EXPECT_FALSE(policy.wantEnabled(1250, false, 500));
+    EXPECT_TRUE(policy.wantEnabled(1300, false, 79)); // The next update would be 29 ms ahead: too late
+}
+
+TEST(DriverPowerPolicyTest, DutyCycleAndEnergy) {
+    DriverPowerConfig config = DriverPowerPolicy::defaultConfig();
+    config.onPowerMw = 1000;
+    config.offPowerMw = 0;
+    DriverPowerPolicy policy(config);
+    policy.begin(0);
+
+    policy.noteEnabled(1000, true);
+    policy.noteEnabled(2000, false);
+    policy.noteEnabled(3000, true);
+    DriverPowerStats stats = policy.stats(4000); // On 2 of 4 s, still on
+    EXPECT_EQ(stats.onMs, 2000u);
+    EXPECT_EQ(stats.totalMs, 4000u);
+    EXPECT_EQ(stats.enables, 2u);
+    EXPECT_EQ(stats.dutyPermille, 500u);
+    EXPECT_EQ(stats.energyMwhPerDay, 12000u); // Half of 1 W over 24 h
+
+    char line[96];
+    DriverPowerPolicy::formatSummary(stats, line, sizeof(line));
+    EXPECT_STREQ(line, "driver on 50.0% enables=2 energy=12000 mWh/day");
+}
+
+// --- Inside MechanicalClock ---
+
+class MechanicalClockPowerTest : public ClockTestFixture<> {
+protected:
+    uint32_t holdOffMs;
+
+    void configure(MechanicalClock& newClock) override {
+        DriverPowerConfig config = DriverPowerPolicy::defaultConfig();
+        config.holdOffMs = holdOffMs;
+        newClock.setDriverPowerConfig(config);
+    }
+
+    void start(uint32_t driverHoldOffMs) {
+        holdOffMs = driverHoldOffMs;
+        ClockTestFixture::start();
+    }
+
+    void print(const char* label) {
+        char line[96];
+        DriverPowerPolicy::formatSummary(clock->getDriverPowerStats(), line, sizeof(line));
+        std::cout << "  " << label << ": " << line << std::endl;
+    }
+};
+
+// Default hold-off: released between time-keeping steps 1.125 s apart, for a duty well below
+// the old full-step clock's (on for the 5 s idle timeout after each step, every 18 s)
+TEST_F(MechanicalClockPowerTest, DefaultReleasesBetweenTimeKeepingSteps) {
+    start(DRIVER_HOLD_OFF_MS);
+    runFor(HAND_ERROR_WINDOW_MS);
+    print("Default hold-off");
+
+    DriverPowerStats stats = clock->getDriverPowerStats();
+    const uint32_t baselinePermille = 1000 * 5000 / 18000;
+    EXPECT_LT(stats.dutyPermille, baselinePermille);
+    EXPECT_GT(stats.enables, 50u);
+    EXPECT_EQ(motor.missedSteps(), 0u);
+    EXPECT_GE(motor.position(), 3199);
+}
+
+// No hold-off: the driver is on from just before each step until it has settled, and every
+// step still reaches the motor on its deadline
+TEST_F(MechanicalClockPowerTest, ReleasingBetweenStepsKeepsTime) {
+    start(0);
+    runFor(HAND_ERROR_WINDOW_MS + 60000);
+    print("No hold-off");
+
+    DriverPowerStats stats = clock->getDriverPowerStats();
+    long expectedOnMs = DRIVER_PRE_ENABLE_MS + DRIVER_POST_DISABLE_MS + 2 * LOOP_PERIOD_MS;
+    EXPECT_LT(stats.dutyPermille, 1000u * expectedOnMs / STEP_MS);
+    EXPECT_GT(stats.enables, 3000u);
+    EXPECT_LT(stats.energyMwhPerDay, STEPPER_DRIVE_POWER_MW * 24 / 5);
+
+    EXPECT_EQ(motor.missedSteps(), 0u);
+    EXPECT_GE(motor.position(), 3199);
+    HandErrorStats error = clock->getHandErrorStats();
+    EXPECT_LE(error.maxMs, 1);
+    EXPECT_GE(error.minMs, -STEP_MS - 1);
+}
+
+// A catch-up from a released driver: the move waits for the driver to wake, nothing is lost
+TEST_F(MechanicalClockPowerTest, CatchUpFromReleasedDriver) {
+    start(0);
+    runFor(10000);
+    long before = motor.position();
+
+    stepRtc(600);
+    runFor(60000);
+
+    EXPECT_EQ(motor.missedSteps(), 0u);
+    EXPECT_NEAR(motor.position() - before, (600 + 60) * 16 / 18, 2);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
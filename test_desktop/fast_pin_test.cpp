@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "FastPin.h"
+#include "LED.h"
+
+static const uint8_t SPARE_PIN = 12; // Not used by the clock
+
+// --- The pin on its own ---
+
+TEST(FastPinTest, OnlyChangesReachTheGpio) {
+    hostResetPins();
+    FastPin<SPARE_PIN> pin;
+    pin.begin(LOW);
+    EXPECT_EQ(hostPinWrites(SPARE_PIN), 1u); // begin() always drives the pin
+
+    EXPECT_FALSE(pin.low());
+    EXPECT_FALSE(pin.write(LOW));
+    EXPECT_TRUE(pin.high());
+    EXPECT_FALSE(pin.high());
+    EXPECT_FALSE(pin.write(5)); // Any non-zero level is HIGH
+    EXPECT_EQ(hostPinLevel(SPARE_PIN), HIGH);
+    EXPECT_EQ(hostPinWrites(SPARE_PIN), 2u);
+    EXPECT_EQ(pin.level(), HIGH);
+}
+
+TEST(FastPinTest, LedWritesOnlyOnChange) {
+    hostResetPins();
+    LED<SPARE_PIN> led;
+    led.begin();
+    for (int i = 0; i < 100; i++) led.on();
+    EXPECT_TRUE(led.isOn());
+    for (int i = 0; i < 100; i++) led.off();
+    led.toggle();
+    led.setState(true);
+    EXPECT_EQ(hostPinLevel(SPARE_PIN), HIGH);
+    EXPECT_EQ(hostPinWrites(SPARE_PIN), 4u); // begin, on, off, toggle
+}
+
+// The pin map matches the UNO R4 WiFi's: the clock's pins are all direct port writes
+static_assert(fastPinPortBit(ENABLE_PIN) == 0x15, "D3 is P105");
+static_assert(fastPinPortBit(MS1_PIN) == 0x16, "D4 is P106");
+static_assert(fastPinPortBit(LED_PIN) == 0x12, "D13 is P102");
+static_assert(fastPinPortBit(20) == 0xFF, "Pins outside the table use digitalWrite()");
+
+// --- GPIO transactions per step inside MechanicalClock ---
+
+class MechanicalClockPinTest : public ClockTestFixture<> {
+protected:
+    void SetUp() override {
+        ClockTestFixture::SetUp();
+        start();
+    }
+
+    static uint32_t controlWrites() {
+        return hostPinWrites(ENABLE_PIN) + hostPinWrites(MS1_PIN) + hostPinWrites(MS2_PIN) + hostPinWrites(MS3_PIN) +
+               hostPinWrites(LED_PIN);
+    }
+};
+
+// Time keeping: the driver is released between steps 1.125 s apart and the microstep lines
+// never change, so the enable line and the LED are written at most once each way per step
+TEST_F(MechanicalClockPinTest, TimeKeepingWritesOnlyEnableAndLed) {
+    runFor(10000); // Settle: driver enabled, first steps out
+    long startPosition = motor.position();
+    uint32_t enableBefore = hostPinWrites(ENABLE_PIN);
+    uint32_t msBefore = hostPinWrites(MS1_PIN) + hostPinWrites(MS2_PIN) + hostPinWrites(MS3_PIN);
+    uint32_t ledBefore = hostPinWrites(LED_PIN);
+    uint32_t stepBefore = hostPinWrites(STEP_PIN);
+    uint32_t dirBefore = hostPinWrites(DIR_PIN);
+
+    uint32_t passes = runFor(3600000);
+    long steps = motor.position() - startPosition;
+    uint32_t ledWrites = hostPinWrites(LED_PIN) - ledBefore;
+    uint32_t stepWrites = hostPinWrites(STEP_PIN) - stepBefore;
+    std::cout << "  " << steps << " steps over " << passes << " loop passes: "
+              << (double)ledWrites / steps << " LED writes/step, "
+              << (double)stepWrites / steps << " STEP writes/step, "
+              << hostPinWrites(ENABLE_PIN) - enableBefore << " enable writes" << std::endl;
+
+    EXPECT_GE(steps, 3199);
+    EXPECT_LE(hostPinWrites(ENABLE_PIN) - enableBefore, 2u * (uint32_t)steps);
+    EXPECT_EQ(hostPinWrites(MS1_PIN) + hostPinWrites(MS2_PIN) + hostPinWrites(MS3_PIN), msBefore);
+    EXPECT_LE(ledWrites, 2u * (uint32_t)steps); // On and off at most once per step
+    EXPECT_EQ(stepWrites, 2u * (uint32_t)steps);  // The pulse's rising and falling edge, nothing else
+    EXPECT_EQ(hostPinWrites(DIR_PIN), dirBefore); // Same direction throughout
+}
+
+// A catch-up move: one microstep switch each way and the enable line once, however long it runs
+TEST_F(MechanicalClockPinTest, CatchUpWritesAreIndependentOfItsLength) {
+    runFor(10000);
+    uint32_t before = controlWrites();
+    uint32_t stepBefore = hostPinWrites(STEP_PIN);
+    uint32_t dirBefore = hostPinWrites(DIR_PIN);
+    unsigned long pulsesBefore = motor.steps();
+    long startPosition = motor.position();
+
+    stepRtc(1800);
+    uint32_t passes = runUntil([&] { return motor.position() - startPosition >= 1600; }, 60000);
+    passes += runFor(1000); // Rotor settled, driver released
+
+    uint32_t writes = controlWrites() - before;
+    std::cout << "  Catch-up of " << motor.position() - startPosition << " 1/16 steps over " << passes
+              << " loop passes: " << writes << " control pin writes" << std::endl;
+    EXPECT_GT(motor.position() - startPosition, 1600);
+    EXPECT_LE(hostPinWrites(MS1_PIN) + hostPinWrites(MS2_PIN) + hostPinWrites(MS3_PIN), 3u + 6u); // begin + out and back
+    EXPECT_LE(writes, 12u); // MS lines, enable and the LED, once each way
+    EXPECT_EQ(hostPinWrites(STEP_PIN) - stepBefore, 2u * (uint32_t)(motor.steps() - pulsesBefore)); // Coarse pulses
+    EXPECT_EQ(hostPinWrites(DIR_PIN), dirBefore);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "GearRatio.h"
+#include "StepAccumulator.h"
+
+static const uint32_t MICROSTEPS_PER_REV = BASE_STEPS_PER_REV * 16;
+static const long SECONDS_PER_YEAR = 31557600; // 365.25 days
+
+// --- Storage ---
+
+TEST(GearRatioTest, EepromRecord) {
+    EEPROM.hostErase();
+    GearRatio ratio;
+    EXPECT_FALSE(loadGearRatio(EEPROM_ADDRESS_GEAR_RATIO, ratio)); // Erased
+
+    EXPECT_TRUE(saveGearRatio(EEPROM_ADDRESS_GEAR_RATIO, GearRatio{14, 6}));
+    ASSERT_TRUE(loadGearRatio(EEPROM_ADDRESS_GEAR_RATIO, ratio));
+    EXPECT_EQ(ratio.motorRevs, 7u); // Stored in lowest terms
+    EXPECT_EQ(ratio.dialRevs, 3u);
+
+    EXPECT_FALSE(saveGearRatio(EEPROM_ADDRESS_GEAR_RATIO, GearRatio{0, 1}));
+    EXPECT_FALSE(saveGearRatio(EEPROM_ADDRESS_GEAR_RATIO, GearRatio{GEAR_RATIO_MAX_TERM + 1, 1}));
+    ASSERT_TRUE(loadGearRatio(EEPROM_ADDRESS_GEAR_RATIO, ratio)); // Still the old record
+    EXPECT_EQ(ratio.motorRevs, 7u);
+
+    EEPROM.write(EEPROM_ADDRESS_GEAR_RATIO + 4, 9); // Corrupt motorRevs
+    EXPECT_FALSE(loadGearRatio(EEPROM_ADDRESS_GEAR_RATIO, ratio));
+}
+
+// --- The hand position model over years ---
+
+struct Movement {
+    const char* name;
+    uint32_t motorRevs;
+    uint32_t dialRevs;
+};
+
+// Real gear trains: this clock's, 4800 microsteps per 12 hours, ones whose step does not
+// divide 43200 s evenly, and a direct drive
+static const Movement MOVEMENTS[] = {
+    {"12/1 (18 s full step)", 12, 1},
+    {"3/2 (4800 steps per 12 h)", 3, 2},
+    {"7/3", 7, 3},
+    {"127/40", 127, 40},
+    {"1/1 (direct drive)", 1, 1},
+};
+
+// Runs the model for `years` of irregular updates (and the odd RTC correction backwards)
+// and checks that the hands are exactly on the rational step count at every update
+template <typename Model>
+static void runYears(const char* name, Model& model, uint64_t stepsPerCycle, uint64_t secondsPerCycle, int years) {
+    model.anchor(START_TIME);
+    uint32_t seed = 12345;
+    long committed = 0;
+    time_t now = START_TIME;
+    time_t end = START_TIME + (time_t)years * SECONDS_PER_YEAR;
+    uint64_t updates = 0;
+    while (now < end) {
+        seed = seed * 1664525u + 1013904223u;
+        now += 1 + (seed >> 16) % 120;
+        if ((seed & 0x3FF) == 0) now -= 1 + (seed >> 10) % 30; // NTP sets the RTC back a little
+
+        long due = model.stepsDue(now);
+        model.commit(due);
+        committed += due;
+        updates++;
+
+        // Exact position: floor of elapsed x rate, except that hands at most one step ahead wait
+        int64_t exact = (int64_t)((uint64_t)(now - START_TIME) * stepsPerCycle / secondsPerCycle);
+        if (committed != exact && committed != exact + 1) {
+            FAIL() << "At " << (now - START_TIME) << " s: " << committed << " steps, exact " << exact;
+        }
+    }
+    long finalDue = model.stepsDue(end);
+    model.commit(finalDue);
+    committed += finalDue;
+    EXPECT_EQ((uint64_t)committed, (uint64_t)(end - START_TIME) * stepsPerCycle / secondsPerCycle);
+    std::cout << "  " << name << ": " << updates << " updates, " << committed << " steps, no rounding error" << std::endl;
+}
+
+class GearRatioYearsTest : public ::testing::TestWithParam<Movement> {};
+
+TEST_P(GearRatioYearsTest, RuntimeModelIsExactOverTenYears) {
+    const Movement& movement = GetParam();
+    uint32_t steps = MICROSTEPS_PER_REV * movement.motorRevs;
+    uint32_t seconds = SECONDS_IN_12_HOURS * movement.dialRevs;
+    StepAccumulator model(steps, seconds);
+    runYears(movement.name, model, steps, seconds, 10);
+}
+
+INSTANTIATE_TEST_SUITE_P(Movements, GearRatioYearsTest, ::testing::ValuesIn(MOVEMENTS));
+
+// Compile-time ratios take the same path as the runtime model
+TEST(GearRatioYearsTest, FixedModelsAreExactOverTenYears) {
+    FixedStepAccumulator<MICROSTEPS_PER_REV * 7, SECONDS_IN_12_HOURS * 3> sevenThirds;
+    runYears("7/3 fixed", sevenThirds, MICROSTEPS_PER_REV * 7, SECONDS_IN_12_HOURS * 3, 10);
+    FixedStepAccumulator<MICROSTEPS_PER_REV * 127, SECONDS_IN_12_HOURS * 40> oddTrain;
+    runYears("127/40 fixed", oddTrain, MICROSTEPS_PER_REV * 127, SECONDS_IN_12_HOURS * 40, 10);
+    EXPECT_TRUE(sevenThirds.setRatio(MICROSTEPS_PER_REV * 14, SECONDS_IN_12_HOURS * 6));
+    EXPECT_FALSE(sevenThirds.setRatio(MICROSTEPS_PER_REV * 12, SECONDS_IN_12_HOURS));
+}
+
+// --- Inside MechanicalClock ---
+
+class MechanicalClockGearTest : public ClockTestFixture<RuntimeRatioMechanicalClock, ::testing::TestWithParam<Movement>> {
+protected:
+    GearRatio gearRatio = {0, 0}; // Set before begin() unless 0 (the stored or built-in ratio)
+
+    void configure(RuntimeRatioMechanicalClock& newClock) override {
+        if (gearRatio.motorRevs != 0) EXPECT_TRUE(newClock.setGearRatio(gearRatio));
+    }
+
+    // Motor position the movement should be at after `seconds` of running, in whole microsteps
+    long expectedPosition(time_t seconds) const {
+        return (long)((uint64_t)seconds * clock->getStepsPerDialCycle() / clock->getSecondsPerDialCycle());
+    }
+};
+
+// The ratio stored in EEPROM drives the clock: a day of running lands on the exact step count
+TEST_P(MechanicalClockGearTest, RatioFromEepromKeepsTimeForADay) {
+    const Movement& movement = GetParam();
+    ASSERT_TRUE(saveGearRatio(EEPROM_ADDRESS_GEAR_RATIO, GearRatio{movement.motorRevs, movement.dialRevs}));
+    start();
+    EXPECT_EQ(clock->getGearRatio().motorRevs, movement.motorRevs);
+    EXPECT_EQ(clock->getGearRatio().dialRevs, movement.dialRevs);
+
+    runFor(86400000UL);
+    RTCTime now;
+    RTC.getTime(now);
+    long expected = expectedPosition(now.getUnixTime() - START_TIME);
+    EXPECT_GE(motor.position(), expected - 1);
+    EXPECT_LE(motor.position(), expected);
+    EXPECT_EQ(motor.missedSteps(), 0u);
+
+    // Hands never ahead, and behind by less than a step
+    long stepMs = (long)((uint64_t)clock->getSecondsPerDialCycle() * 1000 / clock->getStepsPerDialCycle());
+    HandErrorStats error = clock->getHandErrorStats();
+    EXPECT_LE(error.maxMs, 1);
+    EXPECT_GE(error.minMs, -stepMs - 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Movements, MechanicalClockGearTest, ::testing::ValuesIn(MOVEMENTS));
+
+// A year of running on a 7/3 train (one loop pass a second keeps the run short), across
+// millis() and step timer wraps: not a step lost
+TEST_F(MechanicalClockGearTest, SevenThirdsTrainOverAYear) {
+    gearRatio = GearRatio{7, 3};
+    loopPeriodMs = 1000;
+    start();
+    for (long day = 0; day < SECONDS_PER_YEAR / 86400; day++) runFor(86400000UL);
+
+    RTCTime now;
+    RTC.getTime(now);
+    long expected = expectedPosition(now.getUnixTime() - START_TIME);
+    std::cout << "  " << motor.position() << " microsteps in a year, exact " << expected << std::endl;
+    EXPECT_GE(motor.position(), expected - 1);
+    EXPECT_LE(motor.position(), expected);
+    EXPECT_EQ(motor.missedSteps(), 0u);
+}
+
+// The journal is keyed by the gear train: a record from another movement is not trusted
+TEST_F(MechanicalClockGearTest, JournalIgnoresAnotherTrain) {
+    gearRatio = GearRatio{7, 3};
+    start();
+    runFor(120000);
+    EXPECT_GT(clock->getJournalWrites(), 0u);
+
+    HandJournal sameTrain(EEPROM_ADDRESS_HAND_JOURNAL, 0);
+    sameTrain.setCycle(MICROSTEPS_PER_REV * 7, SECONDS_IN_12_HOURS * 3);
+    EXPECT_TRUE(sameTrain.begin());
+    HandJournal otherTrain(EEPROM_ADDRESS_HAND_JOURNAL, 0);
+    otherTrain.setCycle(MICROSTEPS_PER_REV * 7, SECONDS_IN_12_HOURS * 2);
+    EXPECT_FALSE(otherTrain.begin());
+}
+
+// A fixed-ratio build keeps its own ratio whatever EEPROM says
+TEST(FixedRatioClockTest, IgnoresAnotherStoredRatio) {
+    hostDetachTimers();
+    hostResetTime();
+    EEPROM.hostErase();
+    ASSERT_TRUE(saveGearRatio(EEPROM_ADDRESS_GEAR_RATIO, GearRatio{7, 3}));
+
+    LCDDisplay lcd(0x27);
+    MechanicalClock clock(STEP_PIN, DIR_PIN, RTC, lcd);
+    EXPECT_FALSE(clock.setGearRatio(GearRatio{7, 3}));
+    EXPECT_TRUE(clock.setGearRatio(GearRatio{24, 2})); // Same ratio, other terms
+    RTCTime start(START_TIME);
+    RTC.setTime(start);
+    clock.begin();
+    EXPECT_EQ(clock.getGearRatio().motorRevs, (uint32_t)GEAR_RATIO_NUM);
+    EXPECT_EQ(clock.getGearRatio().dialRevs, (uint32_t)GEAR_RATIO_DEN);
+    EXPECT_EQ(clock.getStepsPerDialCycle(), MechanicalClock::STEPS_PER_DIAL_CYCLE);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
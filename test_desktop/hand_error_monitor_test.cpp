@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "HandErrorMonitor.h"
+
+static const long STEP_MS = 1125; // One 1/16 time-keeping step
+
+// --- The monitor on its own ---
+
+TEST(HandErrorMonitorTest, WindowStatistics) {
+    HandErrorMonitor monitor(1000);
+    monitor.begin(0);
+    for (int i = 0; i < 1000; i++) monitor.addSample(-(i % 100)); // 0..-99 ms, evenly
+    monitor.addSample(-4000);
+    monitor.addSample(250);
+
+    HandErrorStats current = monitor.currentWindow();
+    EXPECT_EQ(current.samples, 1002u);
+    EXPECT_EQ(current.minMs, -4000);
+    EXPECT_EQ(current.maxMs, 250);
+    EXPECT_EQ(current.meanMs, (-49500 - 4000 + 250) / 1002);
+    EXPECT_EQ(current.p99Ms, 100); // Bin edge covering 99%: the two outliers are the top 0.2%
+
+    EXPECT_FALSE(monitor.rotate(999));
+    EXPECT_EQ(monitor.lastWindow().samples, 0u);
+    EXPECT_TRUE(monitor.rotate(1000));
+    EXPECT_EQ(monitor.lastWindow().minMs, -4000);
+    EXPECT_EQ(monitor.currentWindow().samples, 0u);
+}
+
+TEST(HandErrorMonitorTest, BurstsAndReversals) {
+    HandErrorMonitor monitor;
+    monitor.begin(0);
+    monitor.noteMove(1);
+    monitor.noteMove(1);
+    monitor.noteMove(-3); // Burst and reversal
+    monitor.noteMove(-1);
+    monitor.noteMove(48); // Burst and reversal
+    HandErrorStats stats = monitor.currentWindow();
+    EXPECT_EQ(stats.bursts, 2u);
+    EXPECT_EQ(stats.reversals, 2u);
+
+    char line[96];
+    HandErrorMonitor::formatSummary(stats, line, sizeof(line));
+    EXPECT_STREQ(line, "hand error ms min/mean/max/p99 0/0/0/0 n=0 bursts=2 reversals=2");
+}
+
+// --- Inside MechanicalClock ---
+
+class MechanicalClockErrorTest : public ClockTestFixture<> {
+protected:
+    void SetUp() override {
+        ClockTestFixture::SetUp();
+        start();
+    }
+
+    void print(const char* label, const HandErrorStats& stats) {
+        char line[96];
+        HandErrorMonitor::formatSummary(stats, line, sizeof(line));
+        std::cout << "  " << label << ": " << line << std::endl;
+    }
+};
+
+// Steps on their deadlines: the hands never lead and trail by at most one step
+TEST_F(MechanicalClockErrorTest, HealthyClockStaysWithinOneStep) {
+    runFor(HAND_ERROR_WINDOW_MS + 60000);
+    HandErrorStats stats = clock->getHandErrorStats();
+    print("Scheduled steps", stats);
+
+    EXPECT_GT(stats.samples, HAND_ERROR_WINDOW_MS / LOOP_PERIOD_MS / 2);
+    EXPECT_LE(stats.maxMs, 1);
+    EXPECT_GE(stats.minMs, -STEP_MS - 1);
+    EXPECT_NEAR(stats.meanMs, -STEP_MS / 2, 20);
+    EXPECT_LE(stats.p99Ms, STEP_MS);
+    EXPECT_EQ(stats.bursts, 0u);
+    EXPECT_EQ(stats.reversals, 0u);
+}
+
+// Steps that wait for the loop to notice them trail by up to a further second: the metric shows it
+TEST_F(MechanicalClockErrorTest, LoopTimedStepsShowAsExtraLag) {
+    clock->setStepScheduling(false);
+    runFor(HAND_ERROR_WINDOW_MS + 60000);
+    HandErrorStats stats = clock->getHandErrorStats();
+    print("Loop-timed steps", stats);
+
+    EXPECT_LT(stats.minMs, -STEP_MS - 500);
+    EXPECT_GE(stats.p99Ms, 2000);
+}
+
+// A large RTC step back shows up as a burst, a reversal and the size of the correction
+TEST_F(MechanicalClockErrorTest, CorrectionsAreCounted) {
+    runFor(60000);
+    stepRtc(-3 * 3600);
+    runFor(60000);
+
+    HandErrorStats stats = clock->getHandErrorStats(true);
+    print("After a 3 h step back", stats);
+    EXPECT_GT(stats.maxMs, 3600000L); // Hands hours ahead while the reverse move runs
+    EXPECT_GE(stats.bursts, 1u);
+    EXPECT_EQ(stats.reversals, 2u); // Back, then forwards again
+
+    // Once the window closes its summary is the one reported
+    runFor(HAND_ERROR_WINDOW_MS);
+    EXPECT_EQ(clock->getHandErrorStats().reversals, 2u);
+    EXPECT_EQ(clock->getHandErrorStats(true).reversals, 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
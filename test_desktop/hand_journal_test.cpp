@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+
+#include "ClockTestFixture.h"
+#include "HandJournal.h"
+#include "TimeUtils.h"
+
+static const double STEP_SECONDS = 1.125;     // Time keeping in 1/16 steps
+static const double FULL_STEP_SECONDS = 18.0; // Catch-up moves in full steps
+static const uint32_t FULL_STEPS_PER_CYCLE = 2400;
+static const int RING_BYTES = HAND_JOURNAL_SLOTS * (int)sizeof(HandJournalRecord);
+
+// Most writes any one journal cell has taken
+static uint32_t worstCellWrites() {
+    uint32_t worst = 0;
+    for (int i = 0; i < RING_BYTES; i++) {
+        worst = std::max(worst, EEPROM.hostWriteCount(EEPROM_ADDRESS_HAND_JOURNAL + i));
+    }
+    return worst;
+}
+
+class HandJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        EEPROM.hostErase();
+    }
+};
+
+// Consecutive writes go round the ring, so each cell takes 1/HAND_JOURNAL_SLOTS of them
+TEST_F(HandJournalTest, WritesSpreadEvenlyOverSlots) {
+    HandJournal journal(EEPROM_ADDRESS_HAND_JOURNAL, FULL_STEPS_PER_CYCLE);
+    EXPECT_FALSE(journal.begin());
+
+    const long writes = HAND_JOURNAL_SLOTS * 100L;
+    for (long i = 0; i < writes; i++) {
+        journal.markChanged(true);
+        ASSERT_TRUE(journal.writeDue());
+        ASSERT_TRUE(journal.write((uint32_t)(i % FULL_STEPS_PER_CYCLE), 0));
+    }
+
+    uint32_t fewest = UINT32_MAX;
+    for (int slot = 0; slot < HAND_JOURNAL_SLOTS; slot++) {
+        fewest = std::min(fewest, EEPROM.hostWriteCount(EEPROM_ADDRESS_HAND_JOURNAL + slot * (int)sizeof(HandJournalRecord)));
+    }
+    std::cout << "  " << writes << " records: worst cell " << worstCellWrites() << " writes, least-used slot "
+              << fewest << std::endl;
+    EXPECT_EQ(worstCellWrites(), (uint32_t)(writes / HAND_JOURNAL_SLOTS));
+    EXPECT_EQ(fewest, (uint32_t)(writes / HAND_JOURNAL_SLOTS));
+
+    // Nothing outside the ring is touched
+    EXPECT_EQ(EEPROM.hostWriteCount(EEPROM_ADDRESS_HAND_JOURNAL - 1), 0u);
+    EXPECT_EQ(EEPROM.hostWriteCount(EEPROM_ADDRESS_HAND_JOURNAL + RING_BYTES), 0u);
+}
+
+// Routine changes are coalesced into one write per interval; unchanged positions are not rewritten
+TEST_F(HandJournalTest, RoutineWritesAreRateLimited) {
+    HandJournal journal(EEPROM_ADDRESS_HAND_JOURNAL, FULL_STEPS_PER_CYCLE);
+    journal.begin();
+
+    journal.markChanged();
+    EXPECT_TRUE(journal.writeDue()); // First write after boot
+    EXPECT_TRUE(journal.write(10, 0));
+
+    journal.markChanged();
+    EXPECT_FALSE(journal.writeDue());
+    delay(HAND_JOURNAL_MIN_INTERVAL_MS / 2);
+    journal.markChanged();
+    EXPECT_FALSE(journal.writeDue());
+    journal.markChanged(true); // A correction goes straight through
+    EXPECT_TRUE(journal.writeDue());
+    EXPECT_FALSE(journal.write(10, 0)); // Back where it was: nothing to write
+    EXPECT_EQ(journal.getWriteCount(), 1u);
+    EXPECT_EQ(journal.getCoalescedCount(), 2u);
+
+    journal.markChanged();
+    delay(HAND_JOURNAL_MIN_INTERVAL_MS);
+    EXPECT_TRUE(journal.writeDue());
+    EXPECT_TRUE(journal.write(13, 0));
+    EXPECT_FALSE(journal.writeDue());
+}
+
+// Power fails at a random byte of a random write: a reboot finds either the record
+// being written (if it completed) or the one before it, never a torn one
+TEST_F(HandJournalTest, RecoversUnderRandomPowerCuts) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> position(0, FULL_STEPS_PER_CYCLE - 1);
+    std::uniform_int_distribution<long> cutAt(0, 2 * (long)sizeof(HandJournalRecord));
+
+    uint32_t committed = 0;
+    bool haveCommitted = false;
+    int torn = 0;
+    for (int boot = 0; boot < 5000; boot++) {
+        HandJournal journal(EEPROM_ADDRESS_HAND_JOURNAL, FULL_STEPS_PER_CYCLE);
+        uint32_t steps = 0, phase = 0;
+        ASSERT_EQ(journal.begin(), haveCommitted);
+        if (haveCommitted) {
+            ASSERT_TRUE(journal.recover(steps, phase));
+            ASSERT_EQ(steps, committed) << "boot " << boot;
+        }
+
+        uint32_t target = position(rng);
+        if (haveCommitted && target == committed) target = (target + 1) % FULL_STEPS_PER_CYCLE;
+        long cut = cutAt(rng);
+        EEPROM.hostCutPowerAfter(cut);
+        journal.markChanged(true);
+        journal.write(target, 0);
+
+        if (cut >= (long)sizeof(HandJournalRecord)) {
+            committed = target; // Every byte made it before the power went
+            haveCommitted = true;
+        } else {
+            torn++;
+        }
+        EEPROM.hostRestorePower();
+    }
+    std::cout << "  5000 boots, " << torn << " torn writes" << std::endl;
+    EXPECT_GT(torn, 1000);
+}
+
+// A build with a different gear train or microstep mode ignores the old records
+TEST_F(HandJournalTest, IgnoresRecordsFromAnotherStepRate) {
+    HandJournal fullStep(EEPROM_ADDRESS_HAND_JOURNAL, FULL_STEPS_PER_CYCLE);
+    fullStep.begin();
+    fullStep.markChanged(true);
+    fullStep.write(100, 0);
+
+    HandJournal sixteenthStep(EEPROM_ADDRESS_HAND_JOURNAL, FULL_STEPS_PER_CYCLE * 16);
+    EXPECT_FALSE(sixteenthStep.begin());
+    EXPECT_TRUE(fullStep.begin());
+}
+
+// --- The journal inside MechanicalClock ---
+
+class MechanicalClockJournalTest : public ClockTestFixture<> {
+protected:
+    MechanicalClockJournalTest() { loopPeriodMs = 50; }
+
+    // Power disappears: the step timer stops and nothing else runs
+    void cutPower(uint32_t outageSeconds) {
+        hostDetachTimers();
+        hostAdvanceMicros((uint64_t)outageSeconds * 1000000ULL); // The RTC keeps running on its battery
+    }
+
+    // Time shown by the hands minus real time (s), from the pulses that actually reached the motor
+    double handErrorSeconds() {
+        return (double)START_TIME + motor.position() * STEP_SECONDS - (double)getCurrentUTC();
+    }
+};
+
+// No power-off interrupt: the hands are recovered from the journal, at most one
+// journal interval of routine ticking behind where they stopped
+TEST_F(MechanicalClockJournalTest, ColdBootWithoutPowerOffIsr) {
+    start(); // First sync: the hands show START_TIME
+    runFor(20 * 60000 + 37000);
+    EXPECT_GT(motor.position(), 60 * 16);
+
+    cutPower(2 * 3600 + 500);
+    boot();
+    runFor(30000);
+
+    std::cout << "  After a 2 h outage: hands " << handErrorSeconds() << " s from real time" << std::endl;
+    EXPECT_GE(handErrorSeconds(), -FULL_STEP_SECONDS);
+    EXPECT_LE(handErrorSeconds(), HAND_JOURNAL_MIN_INTERVAL_MS / 1000 + FULL_STEP_SECONDS);
+}
+
+// Without the journal the same boot has nothing to go on and leaves the hands two hours out
+TEST_F(MechanicalClockJournalTest, ColdBootWithoutJournalReference) {
+    start();
+    runFor(20 * 60000 + 37000);
+
+    cutPower(2 * 3600 + 500);
+    EEPROM.hostErase();
+    boot();
+    runFor(30000);
+    EXPECT_LT(handErrorSeconds(), -2 * 3600 + 600);
+}
+
+// The power-off interrupt journals the exact position, even in the middle of a catch-up move
+TEST_F(MechanicalClockJournalTest, PowerOffIsrDuringCatchUp) {
+    start();
+    runFor(60000);
+
+    RTCTime ahead(getCurrentUTC() + 3 * 3600); // NTP moves the clock on by three hours
+    RTC.setTime(ahead);
+    runFor(1000);
+    ASSERT_GT(clock->getCatchUpEtaMs(), 0u); // Still travelling
+
+    clock->handlePowerOff();
+    cutPower(600);
+    boot();
+    runFor(30000);
+
+    std::cout << "  Cut mid-move: hands " << handErrorSeconds() << " s from real time" << std::endl;
+    EXPECT_GE(handErrorSeconds(), -FULL_STEP_SECONDS);
+    EXPECT_LE(handErrorSeconds(), FULL_STEP_SECONDS);
+}
+
+// A day of normal running stays inside the wear budget
+TEST_F(MechanicalClockJournalTest, DailyWearWithinBudget) {
+    start();
+    runFor(24UL * 3600UL * 1000UL);
+
+    uint32_t perDay = worstCellWrites();
+    double years = 100000.0 / perDay / 365.0;
+    std::cout << "  24 h: " << clock->getJournalWrites() << " records, worst cell " << perDay
+              << " writes/day (" << years << " years to 100k cycles)" << std::endl;
+    EXPECT_LE(clock->getJournalWrites(), 24UL * 3600UL * 1000UL / HAND_JOURNAL_MIN_INTERVAL_MS + 2);
+    EXPECT_GE(years, 10.0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
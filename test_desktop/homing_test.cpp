@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "VirtualHomeSensor.h"
+
+static const long STEPS_PER_DIAL = 38400; // 1/16 steps per 12-hour dial revolution (12/1 gear train)
+static const long COARSE = MechanicalClock::CATCHUP_STEP_MICROSTEPS;
+
+// Dial position (1/16 steps past 12:00) the hands should show at local time `seconds`
+static long dialPositionAt(time_t seconds) {
+    return (long)((seconds % SECONDS_IN_12_HOURS) * STEPS_PER_DIAL / SECONDS_IN_12_HOURS);
+}
+
+// a - b around the dial, in -STEPS_PER_DIAL / 2 .. STEPS_PER_DIAL / 2
+static long dialDifference(long a, long b) {
+    long diff = ((a - b) % STEPS_PER_DIAL + STEPS_PER_DIAL) % STEPS_PER_DIAL;
+    return (diff > STEPS_PER_DIAL / 2) ? diff - STEPS_PER_DIAL : diff;
+}
+
+class HomingTest : public ClockTestFixture<> {
+protected:
+    VirtualHomeSensor sensor;
+    bool sensorFitted = false;
+
+    HomingTest() : sensor(motor, HOME_SENSOR_PIN, HOME_SENSOR_ACTIVE_LEVEL, STEPS_PER_DIAL) {}
+
+    // Puts the hands `dial` 1/16 steps past 12:00 (by hand, with the power off)
+    void placeHands(long dial) {
+        sensor.setDialAtZero(dial - motor.position());
+    }
+
+    void configure(MechanicalClock& newClock) override {
+        newClock.setHomeSensor(sensorFitted);
+    }
+
+    // Power-up with the hands where they are
+    void boot(bool withSensor) {
+        sensorFitted = withSensor;
+        ClockTestFixture::boot();
+        sensor.attach();
+    }
+
+    // Runs until homing is over; returns false if it never finished
+    bool runHoming(uint32_t timeoutMs = 60000) {
+        runUntil([this] { return !clock->isHoming(); }, timeoutMs);
+        return !clock->isHoming();
+    }
+
+    // Where the hands are against where they should be now, in 1/16 steps
+    long handError() const {
+        RTCTime now;
+        RTC.getTime(now);
+        return dialDifference(sensor.dialPosition(), dialPositionAt(now.getUnixTime()));
+    }
+};
+
+// Benchmark: the hands start all round the dial. Each boot finds the home edge to the
+// microstep, quickly, and the catch-up that follows puts the hands on real time.
+TEST_F(HomingTest, FindsHomeFromAnyStartingPosition) {
+    const int starts = 48;
+    unsigned long totalMs = 0;
+    unsigned long worstMs = 0;
+    for (int i = 0; i < starts; i++) {
+        SetUp();
+        long dialAtStart = (long)i * (STEPS_PER_DIAL / starts) + (i * 37) % COARSE; // Off the coarse grid too
+        placeHands(dialAtStart);
+        boot(true);
+        ASSERT_TRUE(runHoming()) << "start " << dialAtStart;
+        EXPECT_EQ(clock->getHomingFailures(), 0u);
+        EXPECT_EQ(sensor.dialPosition(), 0) << "start " << dialAtStart; // Latched on the first microstep past the edge
+
+        unsigned long ms = clock->getLastHomingMs();
+        totalMs += ms;
+        if (ms > worstMs) worstMs = ms;
+
+        runFor(90000); // Catch-up to real time and a little time keeping
+        EXPECT_LE(abs(handError()), 1) << "start " << dialAtStart; // RTC seconds are whole, steps are not
+        EXPECT_EQ(motor.missedSteps(), 0u);
+    }
+    std::cout << "  Homing over " << starts << " starting positions: mean " << totalMs / starts
+              << " ms, worst " << worstMs << " ms" << std::endl;
+
+    // Never more than half a dial at catch-up speed, plus the stop, the return and the creep
+    float halfDialSeconds = (STEPS_PER_DIAL / COARSE / 2) / CATCHUP_MAX_SPEED;
+    EXPECT_LT(worstMs, (unsigned long)(halfDialSeconds * 1000.0f) + 3000);
+}
+
+// The seek takes the short way: hands just past home go back, hands just short of it go on
+TEST_F(HomingTest, SeeksTheShortWay) {
+    placeHands(STEPS_PER_DIAL / 12); // 1:00
+    boot(true);
+    ASSERT_TRUE(runHoming());
+    EXPECT_GT(motor.reverseSteps(), 0u);
+    EXPECT_LT(motor.steps(), 400u);
+    unsigned long shortSeekMs = clock->getLastHomingMs();
+
+    SetUp();
+    placeHands(STEPS_PER_DIAL - STEPS_PER_DIAL / 12); // 11:00
+    boot(true);
+    ASSERT_TRUE(runHoming());
+    EXPECT_LT(motor.steps(), 400u);
+    EXPECT_LT(clock->getLastHomingMs(), shortSeekMs + 500);
+    EXPECT_EQ(sensor.dialPosition(), 0);
+}
+
+// The sensor trumps the journal: hands turned by hand while the power was off are found
+TEST_F(HomingTest, OverridesAStaleJournal) {
+    placeHands(dialPositionAt(START_TIME));
+    boot(false);
+    clock->updateCurrentTime(); // First sync: the hands are right
+    runFor(120000);
+    ASSERT_GT(clock->getJournalWrites(), 0u);
+    clock->handlePowerOff();
+
+    placeHands(sensor.dialPosition() + 5000); // Somebody moved them
+    boot(true);
+    ASSERT_TRUE(runHoming());
+    EXPECT_EQ(clock->getHomingFailures(), 0u);
+    runFor(90000);
+    EXPECT_LE(abs(handError()), 1);
+}
+
+// A dead sensor: homing gives up after the seek span and the hands carry on from the journal,
+// the steps the seek made included
+TEST_F(HomingTest, BrokenSensorFallsBackToJournal) {
+    placeHands(dialPositionAt(START_TIME));
+    boot(false);
+    clock->updateCurrentTime();
+    runFor(120000);
+    clock->handlePowerOff();
+
+    sensor.setBroken(true);
+    boot(true);
+    ASSERT_TRUE(runHoming());
+    EXPECT_EQ(clock->getHomingFailures(), 1u);
+    EXPECT_GT(motor.reverseSteps(), 0u); // It did look
+
+    runFor(90000);
+    EXPECT_LE(abs(handError()), 1);
+    EXPECT_EQ(motor.missedSteps(), 0u);
+}
+
+// No sensor fitted: nothing changes
+TEST_F(HomingTest, NoSensorNoHoming) {
+    boot(false);
+    EXPECT_FALSE(clock->isHoming());
+    clock->startHoming();
+    EXPECT_FALSE(clock->isHoming());
+    clock->updateCurrentTime();
+    runFor(10000);
+    EXPECT_EQ(motor.reverseSteps(), 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+// Host stand-in for the Arduino core, used by the desktop simulation and host tests.
+// Time is virtual: it only moves when delay()/delayMicroseconds() or
+// hostAdvanceMicros() is called, and simulated timers see every elapsed tick.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define FALLING 2
+#define HEX 16
+#define DEC 10
+
+#define B00000 0
+#define B00001 1
+#define B00100 4
+#define B01010 10
+#define B01110 14
+#define B10001 17
+#define B10101 21
+
+// Virtual time base shared by millis()/micros()/delay()
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+// --- Host harness controls (not part of the Arduino API) ---
+#define HOST_PIN_COUNT 32
+#define HOST_MAX_TIMERS 4
+
+typedef void (*HostTimerCallback)(uint32_t elapsedTicks);
+typedef void (*HostPinListener)(uint8_t pin, uint8_t value);
+typedef int (*HostPinReader)(uint8_t pin); // Level of an input pin, or -1 for the driven level
+
+// Periodic timer standing in for a hardware timer interrupt. The callback
+// receives the number of whole periods elapsed since its previous call.
+bool hostAttachTimer(uint32_t periodUs, HostTimerCallback callback);
+bool hostTimerAttached(HostTimerCallback callback);
+void hostDetachTimers();
+
+// Interrupt at an exact virtual instant (the RTC's 1 Hz interrupt). Timers are serviced up
+// to that instant before the callback runs, so it sees their state at that moment. The
+// callback returns the instant of its next call (0 = no more). hostDetachTimers() removes it.
+typedef uint64_t (*HostEventCallback)();
+void hostSetEvent(uint64_t atUs, HostEventCallback callback);
+HostEventCallback hostEvent();
+
+void hostAdvanceMicros(uint64_t us); // Moves virtual time and services timers
+uint64_t hostMicros64();             // Virtual time without 32-bit wrap
+void hostResetTime(uint64_t us = 0);
+
+uint8_t hostPinLevel(uint8_t pin);
+uint32_t hostPinWrites(uint8_t pin); // digitalWrite() calls, including redundant ones
+void hostSetPinListener(HostPinListener listener);
+void hostSetPinReader(HostPinReader reader); // Inputs driven by a simulated sensor
+void hostResetPins();
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+inline uint16_t word(uint8_t high, uint8_t low) { return (uint16_t)((high << 8) | low); }
+
+// Heap allocations String makes, counted the way the Arduino core's String makes them: a
+// buffer for any assigned value (empty ones included) and a reallocation whenever one outgrows
+// it. A moved-from String gives its buffer away.
+unsigned long hostStringAllocations();
+void hostNoteStringAllocation();
+
+class String {
+private:
+    std::string _s;
+    size_t _capacity = 0;
+    bool _buffer = false;
+
+    void _reserve() {
+        if (_buffer && _capacity >= _s.size()) return;
+        hostNoteStringAllocation();
+        _buffer = true;
+        _capacity = _s.size();
+    }
+
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") { _reserve(); }
+    String(const std::string& s) : _s(s) { _reserve(); }
+    String(char c) : _s(1, c) { _reserve(); }
+    String(int v) : _s(std::to_string(v)) { _reserve(); }
+    String(unsigned int v) : _s(std::to_string(v)) { _reserve(); }
+    String(long v) : _s(std::to_string(v)) { _reserve(); }
+    String(unsigned long v) : _s(std::to_string(v)) { _reserve(); }
+    String(const String& o) : _s(o._s) { if (o._buffer) _reserve(); }
+    String(String&& o) noexcept : _s(std::move(o._s)), _capacity(o._capacity), _buffer(o._buffer) {
+        o._s.clear();
+        o._capacity = 0;
+        o._buffer = false;
+    }
+    String& operator=(const String& o) {
+        if (this != &o) {
+            _s = o._s;
+            _reserve();
+        }
+        return *this;
+    }
+    String& operator=(String&& o) noexcept {
+        if (this != &o) {
+            _s = std::move(o._s);
+            if (!_buffer || _capacity < _s.size()) { // Takes the other buffer rather than copying
+                _capacity = o._capacity;
+                _buffer = o._buffer;
+                o._capacity = 0;
+                o._buffer = false;
+            }
+            o._s.clear();
+        }
+        return *this;
+    }
+    String& operator=(const char* s) {
+        _s = s ? s : "";
+        _reserve();
+        return *this;
+    }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char* c_str() const { return _s.c_str(); }
+    char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(""); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > _s.size()) return String("");
+        if (to > _s.size()) to = (unsigned int)_s.size();
+        return to > from ? String(_s.substr(from, to - from)) : String("");
+    }
+    int indexOf(const char* needle) const { size_t p = _s.find(needle); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(char c) const { size_t p = _s.find(c); return p == std::string::npos ? -1 : (int)p; }
+    String& operator+=(const String& o) { _s += o._s; _reserve(); return *this; }
+    String& operator+=(const char* o) { _s += o; _reserve(); return *this; }
+    String& operator+=(char c) { _s += c; _reserve(); return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + b); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b._s); }
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == o; }
+    bool startsWith(const char* p) const { return _s.compare(0, strlen(p), p) == 0; }
+    void trim() {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        size_t b = _s.find_last_not_of(" \t\r\n");
+        _s = (a == std::string::npos) ? std::string() : _s.substr(a, b - a + 1);
+    }
+    int toInt() const { return atoi(_s.c_str()); }
+    void replace(const char* from, const char* to) {
+        std::string f(from), t(to);
+        if (f.empty()) return;
+        size_t p = 0;
+        while ((p = _s.find(f, p)) != std::string::npos) { _s.replace(p, f.size(), t); p += t.size(); }
+        _reserve();
+    }
+};
+
+// Serial output is discarded unless a test enables echo
+class HostSerial {
+public:
+    bool echo = false;
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    template <typename T> void print(const T& v) { if (echo) _write(v); }
+    template <typename T> void print(const T& v, int) { if (echo) _write(v); }
+    void println() { if (echo) fputs("\n", stdout); }
+    template <typename T> void println(const T& v) { if (echo) { _write(v); fputs("\n", stdout); } }
+    template <typename T> void println(const T& v, int) { println(v); }
+    int available() { return 0; }
+    int read() { return -1; }
+private:
+    void _write(const String& v) { fputs(v.c_str(), stdout); }
+    void _write(const char* v) { fputs(v, stdout); }
+    void _write(char v) { fputc(v, stdout); }
+    template <typename T> void _write(const T& v) { _writeValue(v, 0); }
+    // Library types (IPAddress, RTCTime) print through their toString()
+    template <typename T> auto _writeValue(const T& v, int) -> decltype(v.toString(), void()) { fputs(v.toString().c_str(), stdout); }
+    template <typename T> void _writeValue(const T& v, long) { fputs(std::to_string(v).c_str(), stdout); }
+};
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,89 @@
+// Shared fixture of the host tests that run MechanicalClock on virtual time (desktop only).
+//
+// Firmware sources built against the Arduino stand-ins in host/: the clock on the firmware's
+// pins, its LCD, and a VirtualStepper following the driver pins. Every test starts from fresh
+// host state (virtual time at zero, pins, erased EEPROM, the RTC at START_TIME), so the test
+// files keep only what is specific to the behaviour they check.
+#ifndef HOST_CLOCK_TEST_FIXTURE_H
+#define HOST_CLOCK_TEST_FIXTURE_H
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "MechanicalClock.h"
+#include "Constants.h"
+#include "VirtualStepper.h"
+
+static const time_t START_TIME = 1753577342; // RTC at the start of every test (arbitrary valid Unix time)
+static const uint32_t LOOP_PERIOD_MS = 20;    // Default time between loop() passes
+
+// `Clock` is the clock class under test; `Base` the gtest fixture (TestWithParam<> for
+// parameterised suites)
+template <typename Clock = MechanicalClock, typename Base = ::testing::Test>
+class ClockTestFixture : public Base {
+protected:
+    LCDDisplay lcd;
+    std::unique_ptr<Clock> clock; // Created by boot()
+    VirtualStepper motor;         // Where the hands physically are
+    uint32_t loopPeriodMs;
+
+    ClockTestFixture()
+        : lcd(0x27), motor(STEP_PIN, DIR_PIN, ENABLE_PIN, MS1_PIN, MS2_PIN, MS3_PIN), loopPeriodMs(LOOP_PERIOD_MS) {}
+
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        hostResetPins();
+        EEPROM.hostErase();
+        motor.reset();
+        RTCTime start(START_TIME);
+        RTC.setTime(start);
+    }
+
+    // Settings a test makes before begin() (called by boot())
+    virtual void configure(Clock& newClock) { (void)newClock; }
+
+    // Power-up with the hands where they are: the previous clock's step timer stops, a new
+    // clock begins and the motor follows its pins
+    void boot() {
+        hostDetachTimers();
+        motor.powerCycle();
+        clock.reset(new Clock(STEP_PIN, DIR_PIN, RTC, lcd));
+        configure(*clock);
+        clock->begin();
+        motor.attach();
+    }
+
+    // boot() and the first sync, which anchors the hands at the RTC's time
+    void start() {
+        boot();
+        clock->updateCurrentTime();
+    }
+
+    // Runs loop() until `done()` or for `timeoutMs`, whichever comes first. Returns the passes.
+    template <typename Done>
+    uint32_t runUntil(Done done, uint32_t timeoutMs) {
+        uint32_t begin = millis(); // millis() wraps every 49.7 days
+        uint32_t passes = 0;
+        while (!done() && millis() - begin < timeoutMs) {
+            clock->updateCurrentTime();
+            delay(loopPeriodMs);
+            passes++;
+        }
+        return passes;
+    }
+
+    uint32_t runFor(uint32_t ms) {
+        return runUntil([] { return false; }, ms);
+    }
+
+    // Steps the RTC by `seconds` (an NTP correction)
+    void stepRtc(long seconds) {
+        RTCTime now;
+        RTC.getTime(now);
+        RTCTime corrected(now.getUnixTime() + seconds);
+        RTC.setTime(corrected);
+    }
+};
+
+#endif // HOST_CLOCK_TEST_FIXTURE_H
@@ -0,0 +1,66 @@
+// Host stand-in for the EEPROM library (desktop simulation and tests only)
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_EEPROM_SIZE 8192
+
+class HostEEPROM {
+private:
+    uint8_t _data[HOST_EEPROM_SIZE];
+    uint32_t _writes[HOST_EEPROM_SIZE]; // Program cycles per cell (wear)
+    long _cutAfter;                     // Bytes still programmed before the scripted power cut (-1 = none)
+    bool _powerCut;
+
+    void _program(int address, uint8_t value) {
+        if (address < 0 || address >= HOST_EEPROM_SIZE || _powerCut) return;
+        if (_cutAfter == 0) {
+            // Power fails while this byte is programmed: it is left holding garbage
+            value ^= 0xA5;
+            _powerCut = true;
+        } else if (_cutAfter > 0) {
+            _cutAfter--;
+        }
+        if (_data[address] != value) _writes[address]++;
+        _data[address] = value;
+    }
+
+public:
+    HostEEPROM() { hostErase(); }
+
+    uint8_t read(int address) const { return (address >= 0 && address < HOST_EEPROM_SIZE) ? _data[address] : 0xFF; }
+    void write(int address, uint8_t value) { _program(address, value); }
+    void update(int address, uint8_t value) { _program(address, value); }
+    uint16_t length() const { return HOST_EEPROM_SIZE; }
+
+    template <typename T> T& get(int address, T& value) const {
+        for (size_t i = 0; i < sizeof(T); i++) ((uint8_t*)&value)[i] = read(address + (int)i);
+        return value;
+    }
+    template <typename T> const T& put(int address, const T& value) {
+        for (size_t i = 0; i < sizeof(T); i++) _program(address + (int)i, ((const uint8_t*)&value)[i]);
+        return value;
+    }
+
+    // --- Host harness controls ---
+    void hostErase() {
+        memset(_data, 0xFF, sizeof(_data));
+        memset(_writes, 0, sizeof(_writes));
+        hostRestorePower();
+    }
+    uint32_t hostWriteCount(int address) const { return _writes[address]; }
+
+    // Power cut: `bytes` more bytes are programmed, the next one is torn and later writes are lost
+    void hostCutPowerAfter(long bytes) { _cutAfter = bytes; }
+    bool hostPowerCut() const { return _powerCut; }
+    void hostRestorePower() {
+        _cutAfter = -1;
+        _powerCut = false;
+    }
+};
+
+extern HostEEPROM EEPROM;
+
+#endif // HOST_EEPROM_H
@@ -0,0 +1,123 @@
+// Host implementation of the Arduino core stand-in (see host/Arduino.h)
+#include "Arduino.h"
+
+HostSerial Serial;
+
+struct HostTimer {
+    uint32_t periodUs;
+    uint64_t nextTickUs;
+    HostTimerCallback callback;
+};
+
+static uint64_t hostNowUs = 0;
+static HostTimer hostTimers[HOST_MAX_TIMERS];
+static uint8_t hostTimerCount = 0;
+static HostEventCallback hostEventCallback = nullptr;
+static uint64_t hostEventUs = 0;
+
+static uint8_t hostPinLevels[HOST_PIN_COUNT];
+static uint32_t hostPinWriteCounts[HOST_PIN_COUNT];
+static HostPinListener hostPinListener = nullptr;
+static HostPinReader hostPinReader = nullptr;
+
+uint32_t millis() { return (uint32_t)(hostNowUs / 1000ULL); }
+uint32_t micros() { return (uint32_t)hostNowUs; }
+void delay(uint32_t ms) { hostAdvanceMicros((uint64_t)ms * 1000ULL); }
+void delayMicroseconds(uint32_t us) { hostAdvanceMicros(us); }
+
+bool hostAttachTimer(uint32_t periodUs, HostTimerCallback callback) {
+    if (hostTimerCount >= HOST_MAX_TIMERS || periodUs == 0 || callback == nullptr) return false;
+    hostTimers[hostTimerCount].periodUs = periodUs;
+    hostTimers[hostTimerCount].nextTickUs = hostNowUs + periodUs;
+    hostTimers[hostTimerCount].callback = callback;
+    hostTimerCount++;
+    return true;
+}
+
+bool hostTimerAttached(HostTimerCallback callback) {
+    for (uint8_t i = 0; i < hostTimerCount; i++) {
+        if (hostTimers[i].callback == callback) return true;
+    }
+    return false;
+}
+
+void hostDetachTimers() {
+    hostTimerCount = 0;
+    hostEventCallback = nullptr;
+}
+
+void hostSetEvent(uint64_t atUs, HostEventCallback callback) {
+    hostEventUs = atUs;
+    hostEventCallback = callback;
+}
+
+HostEventCallback hostEvent() { return hostEventCallback; }
+
+// Moves virtual time to `us` and delivers the timer ticks up to it
+static void hostServiceTimers(uint64_t us) {
+    if (us > hostNowUs) hostNowUs = us;
+    for (uint8_t i = 0; i < hostTimerCount; i++) {
+        HostTimer& timer = hostTimers[i];
+        if (hostNowUs < timer.nextTickUs) continue;
+        uint64_t ticks = (hostNowUs - timer.nextTickUs) / timer.periodUs + 1;
+        timer.nextTickUs += ticks * timer.periodUs;
+        while (ticks > 0) { // Deliver in 32-bit chunks
+            uint32_t chunk = (ticks > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : (uint32_t)ticks;
+            timer.callback(chunk);
+            ticks -= chunk;
+        }
+    }
+}
+
+void hostAdvanceMicros(uint64_t us) {
+    uint64_t endUs = hostNowUs + us;
+    while (hostEventCallback && hostEventUs <= endUs) {
+        hostServiceTimers(hostEventUs);
+        hostEventUs = hostEventCallback();
+        if (hostEventUs == 0) hostEventCallback = nullptr;
+    }
+    hostServiceTimers(endUs);
+}
+
+uint64_t hostMicros64() { return hostNowUs; }
+
+void hostResetTime(uint64_t us) {
+    hostNowUs = us;
+    for (uint8_t i = 0; i < hostTimerCount; i++) {
+        hostTimers[i].nextTickUs = us + hostTimers[i].periodUs;
+    }
+}
+
+static unsigned long hostStringAllocationCount = 0;
+
+unsigned long hostStringAllocations() { return hostStringAllocationCount; }
+void hostNoteStringAllocation() { hostStringAllocationCount++; }
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= HOST_PIN_COUNT) return;
+    hostPinWriteCounts[pin]++;
+    hostPinLevels[pin] = value ? HIGH : LOW;
+    if (hostPinListener) hostPinListener(pin, hostPinLevels[pin]);
+}
+
+int digitalRead(uint8_t pin) {
+    if (hostPinReader) {
+        int level = hostPinReader(pin);
+        if (level >= 0) return level;
+    }
+    return (pin < HOST_PIN_COUNT) ? hostPinLevels[pin] : LOW;
+}
+
+uint8_t hostPinLevel(uint8_t pin) { return (pin < HOST_PIN_COUNT) ? hostPinLevels[pin] : LOW; }
+uint32_t hostPinWrites(uint8_t pin) { return (pin < HOST_PIN_COUNT) ? hostPinWriteCounts[pin] : 0; }
+void hostSetPinListener(HostPinListener listener) { hostPinListener = listener; }
+void hostSetPinReader(HostPinReader reader) { hostPinReader = reader; }
+
+void hostResetPins() {
+    memset(hostPinLevels, 0, sizeof(hostPinLevels));
+    memset(hostPinWriteCounts, 0, sizeof(hostPinWriteCounts));
+    hostPinListener = nullptr;
+    hostPinReader = nullptr;
+}
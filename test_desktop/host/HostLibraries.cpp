@@ -0,0 +1,408 @@
+// Host implementations of the Arduino library stand-ins (RTC, EEPROM, Wire, LCD, WiFi)
+#include "Arduino.h"
+#include "RTC.h"
+#include "EEPROM.h"
+#include "Wire.h"
+#include "LiquidCrystal_I2C.h"
+#include "WiFiS3.h"
+
+#include <algorithm>
+
+RTClock RTC;
+HostEEPROM EEPROM;
+TwoWire Wire;
+HostWiFi WiFi;
+
+// --- RTC ---
+
+int Month2int(Month month) {
+    return (int)month + 1;
+}
+
+int DayOfWeek2int(DayOfWeek dayOfWeek, bool sundayFirst) {
+    int day = (int)dayOfWeek; // Sunday = 0
+    if (!sundayFirst) day = (day == 0) ? 6 : day - 1;
+    return day;
+}
+
+void RTCTime::_refresh() {
+    time_t t = _unixTime;
+    gmtime_r(&t, &_fields);
+}
+
+RTCTime::RTCTime(int day, Month month, int year, int hour, int minute, int second,
+                 DayOfWeek dayOfWeek, SaveLight saveLight) {
+    (void)dayOfWeek;
+    (void)saveLight;
+    struct tm fields = {};
+    fields.tm_mday = day;
+    fields.tm_mon = (int)month;
+    fields.tm_year = year - 1900;
+    fields.tm_hour = hour;
+    fields.tm_min = minute;
+    fields.tm_sec = second;
+    _unixTime = timegm(&fields);
+    _refresh();
+}
+
+String RTCTime::toString() const {
+    char text[32];
+    snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d", getYear(), Month2int(getMonth()),
+             getDayOfMonth(), getHour(), getMinutes(), getSeconds());
+    return String(text);
+}
+
+RTClock::RTClock() : _setTime(0), _setAtMicros(0), _driftPpm(0), _periodicCallback(nullptr) {}
+
+bool RTClock::getTime(RTCTime& time) {
+    uint64_t elapsedUs = hostMicros64() - _setAtMicros;
+    int64_t driftUs = (int64_t)elapsedUs * _driftPpm / 1000000;
+    time.setUnixTime(_setTime + (time_t)(((int64_t)elapsedUs + driftUs) / 1000000));
+    return true;
+}
+
+bool RTClock::setTime(RTCTime& time) {
+    _setTime = time.getUnixTime();
+    _setAtMicros = hostMicros64();
+    if (hostEvent() == _hostSecondEvent) {
+        hostSetEvent(_nextSecondUs(), _hostSecondEvent); // Seconds now start from the new setting
+    }
+    return true;
+}
+
+// Virtual time at which getTime() next moves on a second
+uint64_t RTClock::_nextSecondUs() const {
+    uint64_t elapsedUs = hostMicros64() - _setAtMicros;
+    uint64_t rtcUs = elapsedUs + (uint64_t)((int64_t)elapsedUs * _driftPpm / 1000000);
+    uint64_t nextRtcUs = (rtcUs / 1000000ULL + 1) * 1000000ULL;
+    // Estimate, then walk up to the first microsecond getTime() rounds into the new second
+    int64_t untilUs = (int64_t)((double)nextRtcUs * 1e6 / (1e6 + (double)_driftPpm)) - 2;
+    if (untilUs < (int64_t)elapsedUs) untilUs = (int64_t)elapsedUs;
+    while (untilUs + untilUs * _driftPpm / 1000000 < (int64_t)nextRtcUs) untilUs++;
+    return _setAtMicros + (uint64_t)untilUs;
+}
+
+uint64_t RTClock::_hostSecondEvent() {
+    if (RTC._periodicCallback) RTC._periodicCallback();
+    return RTC._nextSecondUs();
+}
+
+bool RTClock::setPeriodicCallback(void (*callback)(), Period period) {
+    if (period != Period::ONCE_EVERY_1_SEC || callback == nullptr) return false;
+    _periodicCallback = callback;
+    hostSetEvent(_nextSecondUs(), _hostSecondEvent);
+    return true;
+}
+
+void RTClock::hostSetDriftPpm(long ppm) {
+    // Re-base so the new drift only applies from here on, keeping the phase of the current second
+    uint64_t elapsedUs = hostMicros64() - _setAtMicros;
+    int64_t rtcUs = (int64_t)elapsedUs + (int64_t)elapsedUs * _driftPpm / 1000000;
+    _setTime += (time_t)(rtcUs / 1000000);
+    _driftPpm = ppm;
+    uint64_t intoSecondUs = (uint64_t)((double)(rtcUs % 1000000) * 1e6 / (1e6 + (double)ppm));
+    _setAtMicros = hostMicros64() - std::min(intoSecondUs, hostMicros64());
+    if (hostEvent() == _hostSecondEvent) hostSetEvent(_nextSecondUs(), _hostSecondEvent);
+}
+
+// --- Wire ---
+
+TwoWire::TwoWire()
+    : _txAddress(0), _txLength(0), _transmissions(0), _bytes(0), _busClockHz(0), _writeBusy(false),
+      _writeAddress(0), _writeData(nullptr), _writeLength(0), _writeDone(nullptr), _writeUsLeft(0),
+      _completing(false), _interruptDriven(true) {
+    for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+        _deviceAddresses[i] = 0;
+        _devices[i] = nullptr;
+    }
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t value) {
+    if (_txLength >= HOST_WIRE_BUFFER_LENGTH) return 0;
+    _txBuffer[_txLength++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) written++;
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    if (_busClockHz > 0) {
+        if (_writeBusy) delayMicroseconds(_writeUsLeft); // The bus is taken until then
+        delayMicroseconds(_transferUs(_txLength));       // Blocks like the library does
+    }
+    _deliver(_txAddress, _txBuffer, _txLength);
+    _txLength = 0;
+    return 0;
+}
+
+void TwoWire::_deliver(uint8_t address, const uint8_t* data, size_t length) {
+    _transmissions++;
+    _bytes += 1 + length; // Address byte, then the data
+    for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+        if (_devices[i] && _deviceAddresses[i] == address) _devices[i]->hostReceive(data, length);
+    }
+}
+
+uint32_t TwoWire::_transferUs(size_t length) const {
+    uint64_t clocks = 9ULL * (1 + length) + 2;
+    return (uint32_t)((clocks * 1000000ULL + _busClockHz - 1) / _busClockHz);
+}
+
+void TwoWire::hostSetBusClock(uint32_t hz) {
+    _busClockHz = hz;
+}
+
+bool TwoWire::hostStartWrite(uint8_t address, const uint8_t* data, size_t length, HostI2CDone done) {
+    if (_writeBusy) return false;
+    _writeBusy = true;
+    _writeAddress = address;
+    _writeData = data;
+    _writeLength = length;
+    _writeDone = done;
+
+    if (_busClockHz > 0) {
+        _writeUsLeft = _transferUs(length);
+        if (!hostTimerAttached(_busTimerCallback)) hostAttachTimer(1, _busTimerCallback);
+        return true;
+    }
+
+    // Untimed: done at once. A write started from the callback is finished by this loop
+    // rather than by recursion, so a long queue drains in constant stack.
+    if (_completing) return true;
+    _completing = true;
+    while (_writeBusy) _finishWrite();
+    _completing = false;
+    return true;
+}
+
+void TwoWire::_finishWrite() {
+    _writeBusy = false;
+    _writeUsLeft = 0;
+    _deliver(_writeAddress, _writeData, _writeLength);
+    if (_writeDone) _writeDone(true); // May start the next write
+}
+
+// One tick per microsecond of bus time
+void TwoWire::_busTimerCallback(uint32_t elapsedUs) {
+    while (Wire._writeBusy && elapsedUs >= Wire._writeUsLeft) {
+        elapsedUs -= Wire._writeUsLeft;
+        Wire._finishWrite();
+    }
+    if (Wire._writeBusy) Wire._writeUsLeft -= elapsedUs;
+}
+
+void TwoWire::hostAttach(uint8_t address, HostI2CDevice* device) {
+    for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+        if (_devices[i] && _deviceAddresses[i] == address) _devices[i] = nullptr;
+    }
+    if (!device) return;
+    for (uint8_t i = 0; i < MAX_DEVICES; i++) {
+        if (!_devices[i]) {
+            _deviceAddresses[i] = address;
+            _devices[i] = device;
+            return;
+        }
+    }
+}
+
+// --- LCD ---
+// Byte for byte the traffic of the LiquidCrystal_I2C library: P0 RS, P1 RW, P2 EN,
+// P3 backlight, P4..P7 D4..D7 of the HD44780, driven in 4-bit mode
+
+static const uint8_t LCD_EN = 0x04;
+static const uint8_t LCD_RS = 0x01;
+static const uint8_t LCD_BACKLIGHT = 0x08;
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t cols, uint8_t rows)
+    : _address(address), _cols(cols), _rows(rows), _backlight(LCD_BACKLIGHT) {
+}
+
+void LiquidCrystal_I2C::begin() {
+    Wire.begin();
+    _expanderWrite(_backlight);
+    // Three 8-bit function sets put the controller in a known state from any mode, then 4-bit
+    _write4bits(0x03 << 4);
+    _write4bits(0x03 << 4);
+    _write4bits(0x03 << 4);
+    _write4bits(0x02 << 4);
+    _command(0x20 | (_rows > 1 ? 0x08 : 0x00)); // Function set: 4-bit, lines, 5x8 dots
+    _command(0x0C);                             // Display on, cursor and blink off
+    clear();
+    _command(0x06);                             // Entry mode: left to right, no shift
+    home();
+}
+
+void LiquidCrystal_I2C::clear() { _command(0x01); }
+void LiquidCrystal_I2C::home() { _command(0x02); }
+
+void LiquidCrystal_I2C::backlight() {
+    _backlight = LCD_BACKLIGHT;
+    _expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::noBacklight() {
+    _backlight = 0;
+    _expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
+    _command(0x40 | ((location & 0x07) << 3));
+    for (int i = 0; i < 8; i++) write(charmap[i]);
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+    static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+    if (row >= _rows) row = _rows - 1;
+    _command(0x80 | (col + rowOffsets[row]));
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value) {
+    _send(value, LCD_RS);
+    return 1;
+}
+
+size_t LiquidCrystal_I2C::print(const char* text) {
+    size_t count = 0;
+    while (text && *text) count += write((uint8_t)*text++);
+    return count;
+}
+
+void LiquidCrystal_I2C::_send(uint8_t value, uint8_t mode) {
+    _write4bits((value & 0xF0) | mode);
+    _write4bits(((value << 4) & 0xF0) | mode);
+}
+
+void LiquidCrystal_I2C::_write4bits(uint8_t value) {
+    _expanderWrite(value);
+    _pulseEnable(value);
+}
+
+void LiquidCrystal_I2C::_expanderWrite(uint8_t data) {
+    Wire.beginTransmission(_address);
+    Wire.write((uint8_t)(data | _backlight));
+    Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::_pulseEnable(uint8_t data) {
+    _expanderWrite(data | LCD_EN);
+    _expanderWrite(data & ~LCD_EN);
+}
+
+// --- WiFi ---
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+    return String(text);
+}
+
+HostWiFi::HostWiFi() {
+    hostReset();
+}
+
+void HostWiFi::hostReset() {
+    _linkUp = true;
+    _joining = false;
+    _associatedAtUs = 0;
+    _beginBlockMs = 0;
+    _associateMs = 0;
+    _apStatus = WL_IDLE_STATUS;
+    _ntpClock = nullptr;
+    _ntpLatencyMs = 0;
+    _ntpDrops = 0;
+}
+
+int HostWiFi::status() {
+    if (_apStatus == WL_AP_LISTENING) return WL_AP_LISTENING;
+    if (!_joining) return WL_IDLE_STATUS;
+    if (!_linkUp) return WL_CONNECTION_LOST;
+    return (hostMicros64() >= _associatedAtUs) ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+int HostWiFi::begin(const char* ssid, const char* password) {
+    (void)ssid;
+    (void)password;
+    _apStatus = WL_IDLE_STATUS;
+    delay(_beginBlockMs); // The module blocks the caller while it starts the join
+    _joining = true;
+    _associatedAtUs = hostMicros64() + (uint64_t)_associateMs * 1000ULL;
+    return status();
+}
+
+int HostWiFi::beginAP(const char* ssid) {
+    (void)ssid;
+    _joining = false;
+    _apStatus = WL_AP_LISTENING;
+    return _apStatus;
+}
+
+void HostWiFi::end() {
+    _joining = false;
+    _apStatus = WL_IDLE_STATUS;
+}
+
+void HostWiFi::disconnect() {
+    _joining = false;
+}
+
+IPAddress HostWiFi::localIP() {
+    if (_apStatus == WL_AP_LISTENING) return IPAddress(192, 168, 4, 1);
+    return (status() == WL_CONNECTED) ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+void HostWiFi::hostSetLinkUp(bool up) {
+    _linkUp = up;
+}
+
+void HostWiFi::hostSetJoinTiming(uint32_t beginBlockMs, uint32_t associateMs) {
+    _beginBlockMs = beginBlockMs;
+    _associateMs = associateMs;
+}
+
+void HostWiFi::hostSetNtpServer(HostNtpClock clock, uint32_t latencyMs) {
+    _ntpClock = clock;
+    _ntpLatencyMs = latencyMs;
+}
+
+void HostWiFi::hostDropNtpResponses(int count) {
+    _ntpDrops = count;
+}
+
+int WiFiUDP::endPacket() {
+    _requestPending = true;
+    _requestSentUs = hostMicros64();
+    if (WiFi._ntpDrops > 0) {
+        WiFi._ntpDrops--;
+        _requestPending = false; // Lost on the way
+    }
+    return 1;
+}
+
+int WiFiUDP::parsePacket() {
+    if (!_requestPending || !WiFi._ntpClock || WiFi.status() != WL_CONNECTED) return 0;
+    if (hostMicros64() - _requestSentUs < (uint64_t)WiFi._ntpLatencyMs * 1000ULL) return 0;
+    return 48;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t length) {
+    if (!_requestPending || length < 48) return 0;
+    _requestPending = false;
+    memset(buffer, 0, length);
+
+    // Transmit timestamp, seconds since 1900, big endian
+    uint32_t secondsSince1900 = (uint32_t)(WiFi._ntpClock() + 2208988800UL);
+    buffer[40] = (uint8_t)(secondsSince1900 >> 24);
+    buffer[41] = (uint8_t)(secondsSince1900 >> 16);
+    buffer[42] = (uint8_t)(secondsSince1900 >> 8);
+    buffer[43] = (uint8_t)secondsSince1900;
+    return 48;
+}
@@ -0,0 +1,39 @@
+// Host stand-in for LiquidCrystal_I2C (desktop simulation and tests only).
+// Sends the same PCF8574 byte traffic through Wire as the library does (one transmission per
+// expander write, three per nibble), so a VirtualLcd on the bus shows what the display would
+// and the bus cost can be counted. The library's settling delays are left out.
+#ifndef HOST_LIQUID_CRYSTAL_I2C_H
+#define HOST_LIQUID_CRYSTAL_I2C_H
+
+#include "Arduino.h"
+
+class LiquidCrystal_I2C {
+private:
+    uint8_t _address;
+    uint8_t _cols;
+    uint8_t _rows;
+    uint8_t _backlight; // Backlight bit of every expander write
+
+    void _command(uint8_t value) { _send(value, 0); }
+    void _send(uint8_t value, uint8_t mode);
+    void _write4bits(uint8_t value);
+    void _expanderWrite(uint8_t data);
+    void _pulseEnable(uint8_t data);
+
+public:
+    LiquidCrystal_I2C(uint8_t address, uint8_t cols, uint8_t rows);
+    void init() { begin(); }
+    void begin();
+    void clear();
+    void home();
+    void backlight();
+    void noBacklight();
+    void createChar(uint8_t location, uint8_t charmap[]);
+    void setCursor(uint8_t col, uint8_t row);
+    size_t write(uint8_t value);
+    size_t print(const char* text);
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char value) { return write((uint8_t)value); }
+};
+
+#endif // HOST_LIQUID_CRYSTAL_I2C_H
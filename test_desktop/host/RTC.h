@@ -0,0 +1,78 @@
+// Host stand-in for the UNO R4 RTC library (desktop simulation and tests only).
+// The RTC counts seconds of the virtual time base in Arduino.h.
+#ifndef HOST_RTC_H
+#define HOST_RTC_H
+
+#include "Arduino.h"
+#include <time.h>
+
+enum class Month : uint8_t {
+    JANUARY = 0, FEBRUARY, MARCH, APRIL, MAY, JUNE,
+    JULY, AUGUST, SEPTEMBER, OCTOBER, NOVEMBER, DECEMBER
+};
+
+enum class DayOfWeek : uint8_t {
+    MONDAY = 1, TUESDAY = 2, WEDNESDAY = 3, THURSDAY = 4, FRIDAY = 5, SATURDAY = 6, SUNDAY = 0
+};
+
+enum class SaveLight : uint8_t { SAVING_TIME_INACTIVE = 0, SAVING_TIME_ACTIVE };
+
+enum class Period : uint8_t {
+    ONCE_EVERY_2_SEC, ONCE_EVERY_1_SEC, N2_TIMES_EVERY_SEC, N4_TIMES_EVERY_SEC,
+    N8_TIMES_EVERY_SEC, N16_TIMES_EVERY_SEC, N32_TIMES_EVERY_SEC, N64_TIMES_EVERY_SEC,
+    N128_TIMES_EVERY_SEC, N256_TIMES_EVERY_SEC
+};
+
+int Month2int(Month month);                             // 1..12
+int DayOfWeek2int(DayOfWeek dayOfWeek, bool sundayFirst); // 0 = Sunday when sundayFirst
+
+class RTCTime {
+private:
+    time_t _unixTime;
+    struct tm _fields;
+    void _refresh();
+
+public:
+    RTCTime() : _unixTime(0) { _refresh(); }
+    RTCTime(time_t unixTime) : _unixTime(unixTime) { _refresh(); }
+    RTCTime(int day, Month month, int year, int hour, int minute, int second,
+            DayOfWeek dayOfWeek, SaveLight saveLight);
+
+    int getDayOfMonth() const { return _fields.tm_mday; }
+    Month getMonth() const { return (Month)_fields.tm_mon; }
+    int getYear() const { return _fields.tm_year + 1900; }
+    int getHour() const { return _fields.tm_hour; }
+    int getMinutes() const { return _fields.tm_min; }
+    int getSeconds() const { return _fields.tm_sec; }
+    DayOfWeek getDayOfWeek() const { return (DayOfWeek)_fields.tm_wday; }
+    time_t getUnixTime() const { return _unixTime; }
+    bool setUnixTime(time_t unixTime) { _unixTime = unixTime; _refresh(); return true; }
+    String toString() const;
+};
+
+class RTClock {
+private:
+    time_t _setTime;        // Time written by the last setTime()
+    uint64_t _setAtMicros;  // Virtual time of that write
+    long _driftPpm;         // Positive = RTC runs fast
+    void (*_periodicCallback)();
+
+    uint64_t _nextSecondUs() const;
+    static uint64_t _hostSecondEvent();
+
+public:
+    RTClock();
+    bool begin() { return true; }
+    bool getTime(RTCTime& time);
+    bool setTime(RTCTime& time);
+    bool isRunning() { return true; }
+    // Only ONCE_EVERY_1_SEC: called as each second begins
+    bool setPeriodicCallback(void (*callback)(), Period period);
+
+    // --- Host harness controls ---
+    void hostSetDriftPpm(long ppm);
+};
+
+extern RTClock RTC;
+
+#endif // HOST_RTC_H
@@ -0,0 +1,29 @@
+// Host homing sensor model (see host/VirtualHomeSensor.h)
+#include "VirtualHomeSensor.h"
+
+VirtualHomeSensor* VirtualHomeSensor::_attached = nullptr;
+
+VirtualHomeSensor::VirtualHomeSensor(const VirtualStepper& motor, uint8_t pin, uint8_t activeLevel, long stepsPerDial)
+    : _motor(motor), _pin(pin), _activeLevel(activeLevel), _stepsPerDial(stepsPerDial), _dialAtZero(0),
+      _flagSteps(stepsPerDial / 2), _broken(false) {
+}
+
+void VirtualHomeSensor::attach() {
+    _attached = this;
+    hostSetPinReader(_pinReader);
+}
+
+int VirtualHomeSensor::_pinReader(uint8_t pin) {
+    if (!_attached || pin != _attached->_pin) return -1;
+    bool active = _attached->isActive();
+    return active ? _attached->_activeLevel : (_attached->_activeLevel == HIGH ? LOW : HIGH);
+}
+
+long VirtualHomeSensor::dialPosition() const {
+    long dial = (_dialAtZero + _motor.position()) % _stepsPerDial;
+    return (dial < 0) ? dial + _stepsPerDial : dial;
+}
+
+bool VirtualHomeSensor::isActive() const {
+    return !_broken && dialPosition() >= _stepsPerDial - _flagSteps;
+}
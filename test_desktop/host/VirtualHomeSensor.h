@@ -0,0 +1,39 @@
+// Host stand-in for the homing sensor (desktop simulation and tests only).
+// A flag on the hour wheel covers the half of the dial before the home position; the sensor
+// reads active while the flag is in front of it. The dial position follows a VirtualStepper.
+#ifndef HOST_VIRTUAL_HOME_SENSOR_H
+#define HOST_VIRTUAL_HOME_SENSOR_H
+
+#include "Arduino.h"
+#include "VirtualStepper.h"
+
+class VirtualHomeSensor {
+private:
+    const VirtualStepper& _motor;
+    const uint8_t _pin;
+    const uint8_t _activeLevel;
+    long _stepsPerDial;    // Motor 1/16 steps per 12-hour dial revolution
+    long _dialAtZero;      // Dial position (1/16 steps past home) at motor position 0
+    long _flagSteps;       // Length of the flag before home
+    bool _broken;          // Stuck inactive (wire off, magnet gone)
+
+    static VirtualHomeSensor* _attached;
+    static int _pinReader(uint8_t pin);
+
+public:
+    VirtualHomeSensor(const VirtualStepper& motor, uint8_t pin, uint8_t activeLevel, long stepsPerDial);
+
+    // Starts answering digitalRead() on the sensor pin (replaces any other pin reader)
+    void attach();
+
+    // Where the hands are on the dial when the motor is at position 0, in 1/16 steps past home
+    void setDialAtZero(long steps) { _dialAtZero = steps; }
+    void setFlagSteps(long steps) { _flagSteps = steps; }
+    void setBroken(bool broken) { _broken = broken; }
+
+    // Dial position now (1/16 steps past home, 0 .. stepsPerDial - 1)
+    long dialPosition() const;
+    bool isActive() const;
+};
+
+#endif // HOST_VIRTUAL_HOME_SENSOR_H
@@ -0,0 +1,143 @@
+// Host I2C character LCD model (see host/VirtualLcd.h)
+#include "VirtualLcd.h"
+#include <string.h>
+
+// PCF8574 outputs on the usual backpack
+static const uint8_t PIN_RS = 0x01;
+static const uint8_t PIN_EN = 0x04;
+static const uint8_t PIN_BACKLIGHT = 0x08;
+
+VirtualLcd::VirtualLcd(uint8_t i2cAddress, uint8_t cols, uint8_t rows)
+    : _i2cAddress(i2cAddress), _cols(cols), _rows(rows), _pins(0), _fourBit(false), _haveHighNibble(false),
+      _highNibble(0), _address(0), _cgramSelected(false), _increment(true), _displayOn(false), _backlight(false),
+      _protocolErrors(0) {
+    memset(_ddram, ' ', sizeof(_ddram));
+    memset(_cgram, 0, sizeof(_cgram));
+}
+
+VirtualLcd::~VirtualLcd() {
+    detach();
+}
+
+void VirtualLcd::attach() {
+    Wire.hostAttach(_i2cAddress, this);
+}
+
+void VirtualLcd::detach() {
+    Wire.hostAttach(_i2cAddress, nullptr);
+}
+
+void VirtualLcd::hostReceive(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t pins = data[i];
+        if (!(_pins & PIN_EN) && (pins & PIN_EN) && ((pins ^ _pins) & PIN_RS)) {
+            _protocolErrors++; // RS must be set up before EN rises
+        }
+        if ((_pins & PIN_EN) && !(pins & PIN_EN)) {
+            if ((pins ^ _pins) & (0xF0 | PIN_RS)) _protocolErrors++; // ...and held as EN falls
+            _latch(_pins); // The controller takes D4..D7 and RS on the falling edge of EN
+        }
+        _pins = pins;
+        _backlight = (pins & PIN_BACKLIGHT) != 0;
+    }
+}
+
+void VirtualLcd::_latch(uint8_t pins) {
+    uint8_t nibble = pins & 0xF0;
+    bool data = (pins & PIN_RS) != 0;
+    if (!_fourBit) {
+        _execute(data, nibble); // 8-bit interface: D0..D3 are not wired, so read as 0
+        return;
+    }
+    if (!_haveHighNibble) {
+        _highNibble = nibble;
+        _haveHighNibble = true;
+        return;
+    }
+    _haveHighNibble = false;
+    _execute(data, (uint8_t)(_highNibble | (nibble >> 4)));
+}
+
+void VirtualLcd::_execute(bool data, uint8_t value) {
+    _ops.push_back(VirtualLcdOp{data, value});
+
+    if (data) {
+        if (_cgramSelected) {
+            _cgram[_address & 0x3F] = value;
+        } else {
+            _ddram[_address & 0x7F] = value;
+        }
+        _advanceAddress();
+        return;
+    }
+
+    if (value & 0x80) { // Set DDRAM address
+        _address = value & 0x7F;
+        _cgramSelected = false;
+    } else if (value & 0x40) { // Set CGRAM address
+        _address = value & 0x3F;
+        _cgramSelected = true;
+    } else if (value & 0x20) { // Function set
+        _fourBit = (value & 0x10) == 0;
+        _haveHighNibble = false;
+    } else if (value & 0x10) { // Cursor or display shift (cursor moves only)
+        if (!(value & 0x08)) {
+            bool right = (value & 0x04) != 0;
+            bool saved = _increment;
+            _increment = right;
+            _advanceAddress();
+            _increment = saved;
+        }
+    } else if (value & 0x08) { // Display control
+        _displayOn = (value & 0x04) != 0;
+    } else if (value & 0x04) { // Entry mode
+        _increment = (value & 0x02) != 0;
+    } else if (value & 0x02) { // Return home
+        _address = 0;
+        _cgramSelected = false;
+    } else if (value & 0x01) { // Clear display
+        memset(_ddram, ' ', sizeof(_ddram));
+        _address = 0;
+        _cgramSelected = false;
+        _increment = true;
+    }
+}
+
+// Two-line addressing: 0x00..0x27 and 0x40..0x67, each running on into the other
+void VirtualLcd::_advanceAddress() {
+    if (_cgramSelected) {
+        _address = (uint8_t)((_address + (_increment ? 1 : -1)) & 0x3F);
+        return;
+    }
+    if (_increment) {
+        if (_address == 0x27) _address = 0x40;
+        else if (_address == 0x67) _address = 0x00;
+        else _address++;
+    } else {
+        if (_address == 0x40) _address = 0x27;
+        else if (_address == 0x00) _address = 0x67;
+        else _address--;
+    }
+}
+
+char VirtualLcd::charAt(uint8_t col, uint8_t row) const {
+    static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+    if (row >= _rows || col >= _cols) return '\0';
+    return (char)_ddram[(rowOffsets[row] + col) & 0x7F];
+}
+
+String VirtualLcd::line(uint8_t row) const {
+    String text;
+    for (uint8_t col = 0; col < _cols; col++) text += charAt(col, row);
+    return text;
+}
+
+unsigned long VirtualLcd::commandCount() const {
+    unsigned long count = 0;
+    for (const VirtualLcdOp& op : _ops) count += op.data ? 0 : 1;
+    return count;
+}
+
+unsigned long VirtualLcd::dataCount() const {
+    return (unsigned long)_ops.size() - commandCount();
+}
@@ -0,0 +1,68 @@
+// Host model of an I2C character LCD (desktop simulation and tests only): a PCF8574 backpack in
+// front of an HD44780 controller. Decodes the expander writes on the bus back into controller
+// operations (nibbles latched on the falling edge of EN, 8-bit until a function set selects
+// 4-bit) and keeps display memory, so tests can read what the display shows and what it cost.
+// Writes that change RS as EN rises, or RS or data as EN falls, are counted as protocol errors.
+#ifndef HOST_VIRTUAL_LCD_H
+#define HOST_VIRTUAL_LCD_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include <vector>
+
+// One controller operation decoded from the bus
+struct VirtualLcdOp {
+    bool data;     // Data write (RS high), else a command
+    uint8_t value;
+};
+
+class VirtualLcd : public HostI2CDevice {
+private:
+    uint8_t _i2cAddress;
+    uint8_t _cols;
+    uint8_t _rows;
+    uint8_t _pins;         // Expander outputs after the last write
+    bool _fourBit;         // Interface width set by the last function set
+    bool _haveHighNibble;  // First nibble of a 4-bit transfer latched
+    uint8_t _highNibble;
+    uint8_t _ddram[128];   // Display data (two-line addressing: 0x00.. and 0x40..)
+    uint8_t _cgram[64];    // Custom glyphs
+    uint8_t _address;      // Address counter
+    bool _cgramSelected;   // Data goes to CGRAM (after a CGRAM address command)
+    bool _increment;       // Entry mode I/D
+    bool _displayOn;
+    bool _backlight;
+    unsigned long _protocolErrors;
+    std::vector<VirtualLcdOp> _ops;
+
+    void _latch(uint8_t pins);
+    void _execute(bool data, uint8_t value);
+    void _advanceAddress();
+
+public:
+    VirtualLcd(uint8_t i2cAddress = 0x27, uint8_t cols = 16, uint8_t rows = 2);
+    ~VirtualLcd();
+
+    // Connects the model to the host Wire bus at its address (and back off)
+    void attach();
+    void detach();
+
+    void hostReceive(const uint8_t* data, size_t length) override;
+
+    // Character at a display position (custom glyphs are codes 0..7)
+    char charAt(uint8_t col, uint8_t row) const;
+    // One display line as text
+    String line(uint8_t row) const;
+    const uint8_t* glyph(uint8_t location) const { return &_cgram[(location & 0x07) * 8]; }
+    bool isDisplayOn() const { return _displayOn; }
+    bool isBacklightOn() const { return _backlight; }
+
+    // Operations decoded since the last clearOps()
+    const std::vector<VirtualLcdOp>& ops() const { return _ops; }
+    unsigned long commandCount() const;
+    unsigned long dataCount() const;
+    void clearOps() { _ops.clear(); }
+    unsigned long protocolErrors() const { return _protocolErrors; }
+};
+
+#endif // HOST_VIRTUAL_LCD_H
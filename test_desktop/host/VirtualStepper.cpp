@@ -0,0 +1,81 @@
+// Host motor model (see host/VirtualStepper.h)
+#include "VirtualStepper.h"
+
+VirtualStepper* VirtualStepper::_attached = nullptr;
+
+VirtualStepper::VirtualStepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin, uint8_t ms1Pin, uint8_t ms2Pin,
+                               uint8_t ms3Pin)
+    : _stepPin(stepPin), _dirPin(dirPin), _enablePin(enablePin), _ms1Pin(ms1Pin), _ms2Pin(ms2Pin), _ms3Pin(ms3Pin) {
+    reset();
+}
+
+// A4988 MS1..MS3 table: full, half, quarter, eighth, sixteenth
+uint8_t VirtualStepper::stepSize() const {
+    uint8_t pattern = (uint8_t)((hostPinLevel(_ms1Pin) << 2) | (hostPinLevel(_ms2Pin) << 1) | hostPinLevel(_ms3Pin));
+    switch (pattern) {
+        case 0b100: return 8;
+        case 0b010: return 4;
+        case 0b110: return 2;
+        case 0b111: return 1;
+        default: return 16;
+    }
+}
+
+void VirtualStepper::attach() {
+    _attached = this;
+    _stepLevel = hostPinLevel(_stepPin);
+    hostSetPinListener(_pinListener);
+}
+
+void VirtualStepper::reset() {
+    _stepLevel = LOW;
+    _position = 0;
+    _homePosition = 0;
+    _steps = 0;
+    _reverseSteps = 0;
+    _directionChanges = 0;
+    _missedSteps = 0;
+    _offGridSteps = 0;
+    _lastDirection = 0;
+    _lastStepUs = 0;
+    _burst = 0;
+    _largestBurst = 0;
+}
+
+void VirtualStepper::_pinListener(uint8_t pin, uint8_t value) {
+    if (_attached) _attached->_onPin(pin, value);
+}
+
+void VirtualStepper::_onPin(uint8_t pin, uint8_t value) {
+    if (pin != _stepPin) return;
+    bool rising = (value == HIGH && _stepLevel == LOW);
+    _stepLevel = value;
+    if (!rising) return;
+
+    if (hostPinLevel(_enablePin) == HIGH) {
+        _missedSteps++;
+        return;
+    }
+
+    // The translator only has the coarse mode's positions: from between two of them a
+    // coarse step ends on the next one, which is less than a whole step
+    int8_t direction = (hostPinLevel(_dirPin) == HIGH) ? 1 : -1;
+    long size = stepSize();
+    long offset = (((_position - _homePosition) % size) + size) % size;
+    if (offset != 0) {
+        _offGridSteps++;
+        _position += (direction > 0) ? size - offset : -offset;
+    } else {
+        _position += direction * size;
+    }
+    _steps++;
+    if (direction < 0) _reverseSteps++;
+    if (_lastDirection != 0 && direction != _lastDirection) _directionChanges++;
+    _lastDirection = direction;
+
+    // Timer ticks arrive in bulk, so pulses carry the time of the end of their batch
+    uint64_t now = hostMicros64();
+    _burst = (_steps > 1 && now - _lastStepUs < VIRTUAL_STEPPER_BURST_GAP_US) ? _burst + 1 : 1;
+    if (_burst > _largestBurst) _largestBurst = _burst;
+    _lastStepUs = now;
+}
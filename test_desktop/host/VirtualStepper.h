@@ -0,0 +1,65 @@
+// Host stand-in for the A4988 and the motor (desktop simulation and tests only).
+// Follows the STEP/DIR/ENABLE/MS1..MS3 pins the firmware drives and keeps the
+// shaft position, so a simulation sees the pulses that actually reached the motor.
+#ifndef HOST_VIRTUAL_STEPPER_H
+#define HOST_VIRTUAL_STEPPER_H
+
+#include "Arduino.h"
+
+// Pulses closer together than this are counted as one burst
+#define VIRTUAL_STEPPER_BURST_GAP_US 500000UL
+
+// Position resolution: the A4988's finest microstep (1/16 of a full step)
+#define VIRTUAL_STEPPER_MICROSTEPS 16
+
+class VirtualStepper {
+private:
+    const uint8_t _stepPin;
+    const uint8_t _dirPin;
+    const uint8_t _enablePin; // Active LOW, like the A4988
+    const uint8_t _ms1Pin;
+    const uint8_t _ms2Pin;
+    const uint8_t _ms3Pin;
+
+    uint8_t _stepLevel;
+    long _position;                   // Shaft position in 1/16 steps, clockwise positive
+    long _homePosition;               // Shaft position when the translator was last at home (power-up)
+    unsigned long _steps;             // Pulses that moved the shaft
+    unsigned long _reverseSteps;      // ...of which anticlockwise
+    unsigned long _directionChanges;  // Steps in the opposite direction to the one before
+    unsigned long _missedSteps;       // Pulses while the driver was disabled (the shaft does not move)
+    unsigned long _offGridSteps;      // Coarse steps taken from between their grid positions
+    int8_t _lastDirection;
+    uint64_t _lastStepUs;
+    unsigned long _burst;             // Steps in the current burst
+    unsigned long _largestBurst;
+
+    static VirtualStepper* _attached;
+    static void _pinListener(uint8_t pin, uint8_t value);
+    void _onPin(uint8_t pin, uint8_t value);
+
+public:
+    VirtualStepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin, uint8_t ms1Pin, uint8_t ms2Pin, uint8_t ms3Pin);
+
+    // 1/16 steps one pulse moves with the MS1..MS3 levels currently on the pins
+    uint8_t stepSize() const;
+
+    // Starts following the pins (replaces any other pin listener)
+    void attach();
+    void reset();
+
+    // Driver power-up: the translator returns to home wherever the shaft is
+    void powerCycle() { _homePosition = _position; }
+
+    long position() const { return _position; }
+    unsigned long steps() const { return _steps; }
+    unsigned long reverseSteps() const { return _reverseSteps; }
+    unsigned long directionChanges() const { return _directionChanges; }
+    unsigned long missedSteps() const { return _missedSteps; }
+    unsigned long offGridSteps() const { return _offGridSteps; }
+    unsigned long currentBurst() const { return _burst; }
+    unsigned long largestBurst() const { return _largestBurst; }
+    void resetLargestBurst() { _largestBurst = _burst; }
+};
+
+#endif // HOST_VIRTUAL_STEPPER_H
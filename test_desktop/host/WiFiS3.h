@@ -0,0 +1,105 @@
+// Host stand-in for the UNO R4 WiFiS3 library (desktop simulation and tests only).
+// The link and the NTP server are scripted by the test through the hostXxx() controls;
+// blocking calls consume virtual time like the real module does.
+#ifndef HOST_WIFIS3_H
+#define HOST_WIFIS3_H
+
+#include "Arduino.h"
+#include <time.h>
+
+#define WL_NO_MODULE 255
+#define WL_IDLE_STATUS 0
+#define WL_NO_SSID_AVAIL 1
+#define WL_CONNECTED 3
+#define WL_CONNECT_FAILED 4
+#define WL_CONNECTION_LOST 5
+#define WL_DISCONNECTED 6
+#define WL_AP_LISTENING 7
+#define WL_AP_CONNECTED 8
+
+class IPAddress {
+private:
+    uint8_t _octets[4];
+
+public:
+    IPAddress() : _octets{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+    uint8_t operator[](int index) const { return _octets[index]; }
+    String toString() const;
+};
+
+class WiFiClient {
+public:
+    operator bool() const { return false; } // No HTTP clients in host runs
+    bool connected() { return false; }
+    int available() { return 0; }
+    int read() { return -1; }
+    void stop() {}
+    IPAddress remoteIP() { return IPAddress(); }
+    size_t print(const String& text) { return text.length(); }
+    size_t println(const String& text = String()) { return text.length() + 2; }
+};
+
+class WiFiServer {
+public:
+    WiFiServer(uint16_t) {}
+    void begin() {}
+    WiFiClient available() { return WiFiClient(); }
+};
+
+class WiFiUDP {
+private:
+    bool _requestPending;
+    uint64_t _requestSentUs;
+
+public:
+    WiFiUDP() : _requestPending(false), _requestSentUs(0) {}
+    uint8_t begin(uint16_t) { return 1; }
+    void stop() { _requestPending = false; }
+    int beginPacket(IPAddress, uint16_t) { return 1; }
+    size_t write(const uint8_t*, size_t length) { return length; }
+    int endPacket();
+    int parsePacket();
+    int read(uint8_t* buffer, size_t length);
+};
+
+typedef time_t (*HostNtpClock)(); // True UTC as served by the simulated NTP server
+
+class HostWiFi {
+private:
+    bool _linkUp;
+    bool _joining;
+    uint64_t _associatedAtUs;
+    uint32_t _beginBlockMs;
+    uint32_t _associateMs;
+    int _apStatus;
+
+    HostNtpClock _ntpClock;
+    uint32_t _ntpLatencyMs;
+    int _ntpDrops;
+
+    friend class WiFiUDP;
+
+public:
+    HostWiFi();
+
+    int status();
+    int begin(const char* ssid, const char* password);
+    int beginAP(const char* ssid);
+    void end();
+    void disconnect();
+    void config(IPAddress, IPAddress, IPAddress) {}
+    String firmwareVersion() { return String("host"); }
+    IPAddress localIP();
+
+    // --- Host harness controls ---
+    void hostReset();
+    void hostSetLinkUp(bool up);                                 // Access point in range
+    void hostSetJoinTiming(uint32_t beginBlockMs, uint32_t associateMs); // begin() blocking, then association
+    void hostSetNtpServer(HostNtpClock clock, uint32_t latencyMs);
+    void hostDropNtpResponses(int count);                         // Lose the next `count` replies
+};
+
+extern HostWiFi WiFi;
+
+#endif // HOST_WIFIS3_H
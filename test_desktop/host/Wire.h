@@ -0,0 +1,85 @@
+// Host stand-in for the Wire (I2C) library (desktop simulation and tests only).
+// Every address acknowledges. Transmissions are counted as they would go out on the bus and
+// handed to the device attached at their address, if any (see VirtualLcd). With a bus clock
+// set they also take virtual time: endTransmission() blocks for it, as on the board, and
+// hostStartWrite() completes from a simulated I2C interrupt.
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+// Transmit buffer of the Wire library
+#define HOST_WIRE_BUFFER_LENGTH 32
+
+// A device on the host I2C bus: receives the data bytes of each transmission to its address
+class HostI2CDevice {
+public:
+    virtual ~HostI2CDevice() {}
+    virtual void hostReceive(const uint8_t* data, size_t length) = 0;
+};
+
+// Completion of a hostStartWrite() transfer (the I2C interrupt)
+typedef void (*HostI2CDone)(bool acknowledged);
+
+class TwoWire {
+private:
+    static const uint8_t MAX_DEVICES = 4;
+
+    uint8_t _txAddress;
+    uint8_t _txBuffer[HOST_WIRE_BUFFER_LENGTH];
+    size_t _txLength;
+    uint8_t _deviceAddresses[MAX_DEVICES];
+    HostI2CDevice* _devices[MAX_DEVICES];
+    unsigned long _transmissions;
+    unsigned long _bytes;
+
+    // Bus timing and the interrupt-driven transfer on the bus
+    uint32_t _busClockHz;          // 0 = transfers take no time
+    bool _writeBusy;
+    uint8_t _writeAddress;
+    const uint8_t* _writeData;     // The caller's buffer, read when the transfer ends
+    size_t _writeLength;
+    HostI2CDone _writeDone;
+    uint32_t _writeUsLeft;
+    bool _completing;              // Inside a completion callback (untimed bus)
+    bool _interruptDriven;
+
+    void _deliver(uint8_t address, const uint8_t* data, size_t length);
+    void _finishWrite();
+    uint32_t _transferUs(size_t length) const;
+    static void _busTimerCallback(uint32_t elapsedUs);
+
+public:
+    TwoWire();
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool stop = true); // 0 = ACK
+
+    // --- Host harness controls ---
+    void hostAttach(uint8_t address, HostI2CDevice* device); // nullptr detaches
+    unsigned long hostTransmissions() const { return _transmissions; }
+    unsigned long hostBytes() const { return _bytes; } // Address and data bytes on the bus
+    void hostResetStats() { _transmissions = 0; _bytes = 0; }
+
+    // Bus clock for the timing model (0, the default, makes every transfer instant). Each byte
+    // takes 9 clocks (8 bits and the ACK), plus one each for START and STOP.
+    void hostSetBusClock(uint32_t hz);
+
+    // Interrupt-driven write, as the UNO R4's IIC driver does it: returns at once and calls
+    // `done` when the transfer ends (within this call if the bus is untimed). `data` must stay
+    // valid until then. Returns false if a transfer is already on the bus.
+    bool hostStartWrite(uint8_t address, const uint8_t* data, size_t length, HostI2CDone done);
+    bool hostBusy() const { return _writeBusy; }
+
+    // Whether the interrupt-driven driver opens (default true); false makes the firmware's
+    // I2CTransactionQueue::begin() fail, as a driver that cannot be opened on the board would
+    void hostSetInterruptDriven(bool available) { _interruptDriven = available; }
+    bool hostInterruptDriven() const { return _interruptDriven; }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
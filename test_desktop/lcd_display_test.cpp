@@ -0,0 +1,364 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <new>
+#include <random>
+
+// Firmware sources built against the Arduino stand-ins in host/
+#include "LCDDisplay.h"
+#include "VirtualLcd.h"
+
+static const time_t START_TIME = 1753577342;
+// LiquidCrystal_I2C: a character or command is two nibbles of three one-byte transmissions
+static const unsigned long LIBRARY_BYTES_PER_SEND = 2 * 3 * 2;
+
+// Every C++ heap allocation in this test binary is counted (String's own buffers are counted
+// by the host core, as the Arduino String would allocate them)
+static unsigned long newCount = 0;
+
+void* operator new(size_t size) {
+    newCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static unsigned long heapAllocations() {
+    return newCount + hostStringAllocations();
+}
+
+class LCDDisplayTest : public ::testing::Test {
+protected:
+    VirtualLcd screen;
+    LCDDisplay lcd;
+
+    LCDDisplayTest() : screen(0x27), lcd(0x27) {}
+
+    void TearDown() override {
+        EXPECT_EQ(screen.protocolErrors(), 0u); // Setup and hold of RS and data around EN
+    }
+
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        RTCTime start(START_TIME);
+        RTC.setTime(start);
+        screen.attach();
+        ASSERT_TRUE(lcd.begin());
+        screen.clearOps();
+        Wire.hostResetStats();
+    }
+
+    // What the whole-line flush through LiquidCrystal_I2C sent for the change from `before` to
+    // the screen now: per changed line a cursor move and columns 0-14, and the status icon apart
+    unsigned long lineRewriteBytes(const String before[LCD_HEIGHT]) const {
+        unsigned long sends = 0;
+        for (uint8_t row = 0; row < LCD_HEIGHT; row++) {
+            String now = screen.line(row);
+            if (now == before[row]) continue;
+            sends += 1 + 15;
+            if (now[15] != before[row][15]) sends += 2;
+        }
+        return sends * LIBRARY_BYTES_PER_SEND;
+    }
+
+    static String expectedTime(time_t t) {
+        RTCTime time(t);
+        char text[17];
+        snprintf(text, sizeof(text), "%02d:%02d:%02d       ", time.getHour(), time.getMinutes(), time.getSeconds());
+        return String(text);
+    }
+};
+
+// Benchmark: an hour of the once-a-second update. Only the digits that change go out, packed
+// into one transmission, and the display shows the time throughout.
+TEST_F(LCDDisplayTest, SecondsUpdateSendsOnlyChangedDigits) {
+    RTCTime now;
+    RTC.getTime(now);
+    lcd.updateTimeAndDate(now); // First frame fills the screen
+    Wire.hostResetStats();
+
+    const int frames = 3600;
+    unsigned long baselineBytes = 0;
+    unsigned long worstBytes = 0;
+    for (int i = 0; i < frames; i++) {
+        String before[LCD_HEIGHT] = {screen.line(0), screen.line(1)};
+        unsigned long bytesBefore = Wire.hostBytes();
+
+        delay(1000);
+        RTC.getTime(now);
+        lcd.updateTimeAndDate(now);
+
+        unsigned long bytes = Wire.hostBytes() - bytesBefore;
+        if (bytes > worstBytes) worstBytes = bytes;
+        baselineBytes += lineRewriteBytes(before);
+        ASSERT_EQ(screen.line(1).substring(0, 15), expectedTime(now.getUnixTime()).substring(0, 15));
+    }
+
+    double mean = (double)Wire.hostBytes() / frames;
+    double baseline = (double)baselineBytes / frames;
+    std::cout << "  I2C bytes per frame: whole-line rewrite " << baseline << ", runs " << mean << " (worst "
+              << worstBytes << ", " << baseline / mean << "x fewer)" << std::endl;
+
+    // Most frames: a cursor move and the seconds digit, 11 bytes
+    EXPECT_LT(mean, 12);
+    EXPECT_LT(mean * 15, baseline);
+    // Hour change: cursor move and "HH:MM:SS" at most
+    EXPECT_LE(worstBytes, (unsigned long)(LCD_I2C_BYTES_PER_CURSOR_MOVE + 8 * LCD_I2C_BYTES_PER_CHAR));
+}
+
+// A run is one transmission that the display decodes to the same operations the library's
+// setCursor() and write() calls give, for a third of the bus bytes
+TEST_F(LCDDisplayTest, RunPacketDecodesLikeTheLibrary) {
+    lcd.printLine(1, "Hello");
+    EXPECT_EQ(Wire.hostTransmissions(), 1u);
+    EXPECT_EQ(Wire.hostBytes(), (unsigned long)(LCD_I2C_BYTES_PER_CURSOR_MOVE + 5 * LCD_I2C_BYTES_PER_CHAR));
+    std::vector<VirtualLcdOp> packed = screen.ops();
+    EXPECT_EQ(screen.line(1).substring(0, 5), String("Hello"));
+
+    LiquidCrystal_I2C library(0x27, 16, 2);
+    screen.clearOps();
+    Wire.hostResetStats();
+    library.setCursor(0, 1);
+    library.print("Hello");
+    ASSERT_EQ(screen.ops().size(), packed.size());
+    for (size_t i = 0; i < packed.size(); i++) {
+        EXPECT_EQ(screen.ops()[i].data, packed[i].data) << i;
+        EXPECT_EQ(screen.ops()[i].value, packed[i].value) << i;
+    }
+    EXPECT_EQ(Wire.hostTransmissions(), 6u * 6u);
+    EXPECT_EQ(Wire.hostBytes(), 6u * LIBRARY_BYTES_PER_SEND);
+}
+
+// Without the queue the packet goes straight to Wire, in buffer-sized transmissions
+TEST_F(LCDDisplayTest, UnqueuedPacketFitsTheWireBuffer) {
+    LCDDisplay direct(0x27);
+    ASSERT_TRUE(direct.begin(false));
+    screen.clearOps();
+    Wire.hostResetStats();
+    direct.printLine(0, "ABCDEFGHIJKLMNO");
+    unsigned long packetBytes = 1 + 2 * 2 + 1 + 15 * LCD_I2C_BYTES_PER_CHAR;
+    unsigned long transmissions = (packetBytes + LCD_WIRE_CHUNK - 1) / LCD_WIRE_CHUNK;
+    EXPECT_EQ(Wire.hostTransmissions(), transmissions);
+    EXPECT_EQ(Wire.hostBytes(), transmissions + packetBytes);
+    EXPECT_EQ(screen.line(0).substring(0, 15), String("ABCDEFGHIJKLMNO"));
+    EXPECT_EQ(screen.commandCount(), 1u);
+}
+
+// If the interrupt-driven driver will not open, begin() still succeeds and every frame blocks
+// on Wire instead, drawn by the time the call returns
+TEST_F(LCDDisplayTest, DriverFailureFallsBackToWire) {
+    Wire.hostSetInterruptDriven(false);
+    LCDDisplay fallback(0x27);
+    bool started = fallback.begin();
+    Wire.hostSetInterruptDriven(true);
+    ASSERT_TRUE(started);
+    EXPECT_FALSE(fallback.isQueued());
+
+    Wire.hostSetBusClock(100000);
+    uint64_t startUs = hostMicros64();
+    fallback.printLine(1, "Clock Running");
+    uint64_t blockedUs = hostMicros64() - startUs;
+    Wire.hostSetBusClock(0);
+
+    EXPECT_FALSE(Wire.hostBusy());
+    EXPECT_GT(blockedUs, 1000u); // Held up for the bus time
+    EXPECT_EQ(screen.line(1).substring(0, 15), String("Clock Running  "));
+}
+
+// A single clean character between two changed ones costs no more than a cursor move, so it
+// is rewritten; a longer gap is skipped
+TEST_F(LCDDisplayTest, BridgesGapsCheaperThanACursorMove) {
+    lcd.printLine(0, "ABCDEFGHIJKLMNO");
+    screen.clearOps();
+
+    lcd.printLine(0, "ABxDxFGHIJKLMNO"); // Columns 2 and 4
+    EXPECT_EQ(screen.commandCount(), 1u);
+    EXPECT_EQ(screen.dataCount(), 3u);
+    screen.clearOps();
+
+    lcd.printLine(0, "AByDxFGzIJKLMNO"); // Columns 2 and 7
+    EXPECT_EQ(screen.commandCount(), 2u);
+    EXPECT_EQ(screen.dataCount(), 2u);
+    EXPECT_EQ(screen.line(0).substring(0, 15), String("AByDxFGzIJKLMNO"));
+}
+
+// A run that starts where the last one ended needs no cursor move
+TEST_F(LCDDisplayTest, CursorMoveSkippedWhereTheDisplayLeftIt) {
+    lcd.printLine(1, "12345");
+    screen.clearOps();
+    lcd.printLine(1, "123456");
+    EXPECT_EQ(screen.commandCount(), 0u);
+    EXPECT_EQ(screen.dataCount(), 1u);
+    EXPECT_EQ(screen.line(1).substring(0, 6), String("123456"));
+}
+
+// Messages, time and status icons in any order: the display always matches what was drawn
+TEST_F(LCDDisplayTest, DisplayMatchesRandomUpdates) {
+    static const char* MESSAGES[] = {"Initializing...", "Please Wait", "Config Mode", "Connect to AP",
+                                     "Connecting WiFi", "Syncing Time", "NTP Server...", "ERROR:", ""};
+    const int messageCount = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+    std::mt19937 rng(5);
+    String expected[LCD_HEIGHT] = {String("               "), String("               ")};
+
+    for (int i = 0; i < 2000; i++) {
+        int action = (int)(rng() % 4);
+        if (action < 2) {
+            uint8_t row = (uint8_t)(rng() % LCD_HEIGHT);
+            String message(MESSAGES[rng() % messageCount]);
+            lcd.printLine(row, message);
+            expected[row] = message;
+            while (expected[row].length() < 15) expected[row] += " ";
+        } else if (action == 2) {
+            delay(1000 + rng() % 5000);
+            RTCTime now;
+            RTC.getTime(now);
+            lcd.updateTimeAndDate(now);
+            expected[0] = screen.line(0).substring(0, 15); // The date format is not under test here
+            expected[1] = expectedTime(now.getUnixTime()).substring(0, 15);
+        } else {
+            delay(500);
+            lcd.updateNetworkStatus((rng() % 2) ? WL_CONNECTED : WL_DISCONNECTED, 0, 3600000UL);
+        }
+        for (uint8_t row = 0; row < LCD_HEIGHT; row++) {
+            ASSERT_EQ(screen.line(row).substring(0, 15), expected[row]) << "step " << i;
+            char icon = screen.line(row)[15];
+            ASSERT_TRUE(icon == ' ' || icon == (char)row) << "step " << i; // WiFi glyph 0, sync glyph 1
+        }
+    }
+}
+
+// A day of once-a-second updates, time and status icons, without a single heap allocation
+TEST_F(LCDDisplayTest, FramesDoNotTouchTheHeap) {
+    screen.detach(); // The display model logs to a vector
+    RTCTime now;
+    RTC.getTime(now);
+    lcd.updateTimeAndDate(now);
+
+    unsigned long before = heapAllocations();
+    const int frames = 86400;
+    for (int i = 0; i < frames; i++) {
+        delay(500);
+        lcd.updateNetworkStatus((i % 600 < 10) ? WL_DISCONNECTED : WL_CONNECTED, 0, 3600000UL);
+        delay(500);
+        RTC.getTime(now);
+        lcd.updateTimeAndDate(now);
+    }
+    unsigned long allocations = heapAllocations() - before;
+    std::cout << "  Heap allocations over " << frames << " frames: " << allocations << std::endl;
+    EXPECT_EQ(allocations, 0u);
+
+    // Status messages from a literal don't allocate either
+    before = heapAllocations();
+    lcd.printLine(0, "Syncing Time");
+    lcd.printLine(1, "NTP Server...");
+    EXPECT_EQ(heapAllocations() - before, 0u);
+}
+
+// Long messages are cut off before the status icon
+TEST_F(LCDDisplayTest, LongMessageKeepsTheStatusColumn) {
+    delay(500); // Icons are drawn on the blink interval
+    lcd.updateNetworkStatus(WL_CONNECTED, 0, 3600000UL);
+    lcd.printLine(0, "A message longer than the display");
+    EXPECT_EQ(screen.line(0).substring(0, 15), String("A message longe"));
+    EXPECT_EQ(screen.line(0)[15], (char)0); // WiFi glyph
+    lcd.printLine(0, String("Short"));
+    EXPECT_EQ(screen.line(0).substring(0, 15), String("Short          "));
+}
+
+// The date line, as formatted before (snprintf "%02d/%s/%02d %s")
+TEST_F(LCDDisplayTest, DateAndTimeLayout) {
+    RTCTime now(START_TIME); // Sun 27 Jul 2025 00:49:02 UTC
+    lcd.updateTimeAndDate(now);
+    EXPECT_EQ(screen.line(0).substring(0, 15), String("27/Jul/25 Sun  "));
+    EXPECT_EQ(screen.line(1).substring(0, 15), String("00:49:02       "));
+}
+
+// Benchmark: loop() time spent in the once-a-second update on a 100 kHz bus, blocking on Wire
+// against queued for the I2C interrupt (the same packets either way). Virtual time only moves while a call waits on the bus.
+TEST_F(LCDDisplayTest, QueuedFrameReturnsWithoutWaitingForTheBus) {
+    Wire.hostSetBusClock(100000);
+    const int frames = 3600;
+    uint64_t totalUs[2] = {0, 0};
+    uint64_t worstUs[2] = {0, 0};
+
+    for (int queued = 0; queued < 2; queued++) {
+        LCDDisplay display(0x27);
+        ASSERT_TRUE(display.begin(queued != 0));
+        ASSERT_EQ(display.isQueued(), queued != 0);
+        RTCTime now;
+        RTC.getTime(now);
+        display.updateTimeAndDate(now); // First frame fills the screen
+
+        for (int i = 0; i < frames; i++) {
+            delay(1000);
+            RTC.getTime(now);
+            uint64_t startUs = hostMicros64();
+            display.updateTimeAndDate(now);
+            uint64_t us = hostMicros64() - startUs;
+            totalUs[queued] += us;
+            if (us > worstUs[queued]) worstUs[queued] = us;
+
+            display.flush(); // Drawn by the time anyone looks
+            ASSERT_EQ(screen.line(1).substring(0, 15), expectedTime(now.getUnixTime()).substring(0, 15));
+        }
+    }
+    Wire.hostSetBusClock(0);
+
+    std::cout << "  updateTimeAndDate() on a 100 kHz bus: blocking " << (double)totalUs[0] / frames
+              << " us (worst " << worstUs[0] << "), queued " << (double)totalUs[1] / frames << " us (worst "
+              << worstUs[1] << ")" << std::endl;
+
+    EXPECT_GT(totalUs[0] / frames, 1000u); // A cursor move and a digit: 11 bytes of 90 us
+    EXPECT_EQ(worstUs[1], 0u);             // Every frame fits in the ring
+}
+
+// A frame larger than the ring waits for room rather than dropping anything, and the queued
+// output always ends up on the display
+TEST_F(LCDDisplayTest, TimedBusDisplayMatchesAfterFlush) {
+    static const char* MESSAGES[] = {"Initializing...", "Please Wait", "Config Mode", "Connecting WiFi",
+                                     "Syncing Time", "NTP Server...", "ERROR:", ""};
+    const int messageCount = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+    Wire.hostSetBusClock(100000);
+    std::mt19937 rng(7);
+    String expected[LCD_HEIGHT] = {String("               "), String("               ")};
+
+    for (int i = 0; i < 500; i++) {
+        if (rng() % 2) {
+            uint8_t row = (uint8_t)(rng() % LCD_HEIGHT);
+            String message(MESSAGES[rng() % messageCount]);
+            lcd.printLine(row, message);
+            expected[row] = message;
+            while (expected[row].length() < 15) expected[row] += " ";
+        } else {
+            lcd.clear();
+            expected[0] = expected[1] = String("               ");
+        }
+        delay(rng() % 20); // Sometimes the next frame lands while this one is on the bus
+        if (rng() % 4 == 0) {
+            lcd.flush();
+            for (uint8_t row = 0; row < LCD_HEIGHT; row++) {
+                ASSERT_EQ(screen.line(row).substring(0, 15), expected[row]) << "step " << i;
+            }
+        }
+    }
+    lcd.flush();
+    Wire.hostSetBusClock(0);
+    for (uint8_t row = 0; row < LCD_HEIGHT; row++) {
+        EXPECT_EQ(screen.line(row).substring(0, 15), expected[row]);
+    }
+}
+
+// The status glyphs are uploaded at start-up
+TEST_F(LCDDisplayTest, CustomGlyphsUploaded) {
+    EXPECT_EQ(screen.glyph(0)[2], 0x0A); // WiFi
+    EXPECT_EQ(screen.glyph(1)[2], 0x0E); // Sync
+    EXPECT_TRUE(screen.isDisplayOn());
+    EXPECT_TRUE(screen.isBacklightOn());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "ClockTestFixture.h"
+#include "TimeUtils.h"
+
+static const double STEP_SECONDS = 1.125;     // Time keeping in 1/16 steps
+static const double FULL_STEP_SECONDS = 18.0; // Catch-up moves in full steps
+static const double MAX_LAG_SECONDS = STEP_SECONDS + 1.0; // One step plus the RTC's whole-second resolution
+
+class MechanicalClockHoldTest : public ClockTestFixture<> {
+protected:
+    MechanicalClockHoldTest() { loopPeriodMs = 50; }
+
+    void SetUp() override {
+        ClockTestFixture::SetUp();
+        start();
+    }
+
+    double handLagSeconds() {
+        return (double)(getCurrentUTC() - START_TIME) - motor.position() * STEP_SECONDS;
+    }
+};
+
+// An NTP step-back of under a minute pauses the hands instead of reversing them
+TEST_F(MechanicalClockHoldTest, SmallStepBackHolds) {
+    runFor(600000);
+    long positionBefore = motor.position();
+    ASSERT_EQ(motor.reverseSteps(), 0u);
+
+    stepRtc(-50);
+    runFor(30000);
+    EXPECT_EQ(motor.reverseSteps(), 0u);
+    EXPECT_EQ(motor.position(), positionBefore); // Paused while real time catches up
+    EXPECT_GE(clock->getHoldStepsSaved(), 80u); // 44 steps back and the same forward again
+    EXPECT_GT(clock->getHoldEnergySavedMj(), 0u);
+
+    // Once caught up the hands carry on normally and are back within one step
+    runFor(120000);
+    EXPECT_EQ(motor.reverseSteps(), 0u);
+    EXPECT_GT(motor.position(), positionBefore);
+    EXPECT_GE(handLagSeconds(), 0);
+    EXPECT_LT(handLagSeconds(), MAX_LAG_SECONDS);
+
+    std::cout << "  Steps saved: " << clock->getHoldStepsSaved()
+              << ", energy saved: " << clock->getHoldEnergySavedMj() << " mJ" << std::endl;
+}
+
+// Offsets beyond the threshold are still corrected by reversing
+TEST_F(MechanicalClockHoldTest, LargeStepBackReverses) {
+    runFor(60000);
+    stepRtc(-600);
+    runFor(20000);
+    EXPECT_GE(motor.reverseSteps(), (unsigned long)(600 / FULL_STEP_SECONDS) - 1);
+    EXPECT_EQ(motor.offGridSteps(), 0u);
+    // A reverse catch-up in full steps can land up to a full step ahead of real time; that remainder is held
+    EXPECT_LE(clock->getHoldStepsSaved(), 2u * (MechanicalClock::CATCHUP_STEP_MICROSTEPS + 1));
+    EXPECT_GE(handLagSeconds(), -FULL_STEP_SECONDS);
+    EXPECT_LT(handLagSeconds(), MAX_LAG_SECONDS);
+}
+
+// A zero threshold restores the old always-reverse behaviour
+TEST_F(MechanicalClockHoldTest, ZeroThresholdAlwaysReverses) {
+    clock->setHoldThreshold(0);
+    runFor(60000);
+    stepRtc(-50);
+    runFor(5000);
+    EXPECT_GE(motor.reverseSteps(), 2u);
+    EXPECT_EQ(clock->getHoldStepsSaved(), 0u);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+
+// Firmware sources built against the Arduino stand-ins in host/
+#include "MotionGroup.h"
+
+static const uint32_t MICROSTEPS_PER_REV = 3200;
+
+// One motor per hand: hour, minute and seconds hands direct on 1/16-stepped motors, and a
+// 24-hour hand behind an odd gear train on a full-stepped one
+struct Hand {
+    const char* name;
+    uint8_t stepPin;
+    uint8_t dirPin;
+    uint32_t stepsPerRev;
+    GearRatio ratio;
+    uint32_t cycleSeconds;
+};
+
+static const Hand HANDS[] = {
+    {"hour", 20, 21, MICROSTEPS_PER_REV, {1, 1}, 43200},
+    {"minute", 22, 23, MICROSTEPS_PER_REV, {1, 1}, 3600},
+    {"seconds", 24, 25, MICROSTEPS_PER_REV, {1, 1}, 60},
+    {"24-hour", 26, 27, 200, {127, 40}, 86400},
+};
+static const uint8_t HAND_COUNT = sizeof(HANDS) / sizeof(HANDS[0]);
+
+// Every pulse against its exact due tick
+static MotionGroup* observed = nullptr;
+static uint64_t pulseCount[HAND_COUNT];
+static int64_t maxLateTicks[HAND_COUNT];
+static int64_t minLateTicks[HAND_COUNT];
+
+template <uint8_t Axis>
+static void observePulse(uint32_t tick, int8_t direction) {
+    (void)tick;
+    (void)direction;
+    int64_t late = (int64_t)observed->tickCount() - (int64_t)observed->dueTick(Axis, ++pulseCount[Axis]);
+    if (late > maxLateTicks[Axis]) maxLateTicks[Axis] = late;
+    if (late < minLateTicks[Axis]) minLateTicks[Axis] = late;
+}
+
+static const StepPulseEngine::PulseObserver OBSERVERS[] = {observePulse<0>, observePulse<1>, observePulse<2>, observePulse<3>};
+
+class MotionGroupTest : public ::testing::Test {
+protected:
+    StepPulseEngine engines[HAND_COUNT] = {
+        StepPulseEngine(HANDS[0].stepPin, HANDS[0].dirPin), StepPulseEngine(HANDS[1].stepPin, HANDS[1].dirPin),
+        StepPulseEngine(HANDS[2].stepPin, HANDS[2].dirPin), StepPulseEngine(HANDS[3].stepPin, HANDS[3].dirPin)};
+
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        hostResetPins();
+        for (uint8_t i = 0; i < HAND_COUNT; i++) {
+            pulseCount[i] = 0;
+            maxLateTicks[i] = INT64_MIN;
+            minLateTicks[i] = INT64_MAX;
+            engines[i].setPulseObserver(OBSERVERS[i]);
+        }
+    }
+
+    void build(MotionGroup& group) {
+        for (uint8_t i = 0; i < HAND_COUNT; i++) {
+            ASSERT_EQ(group.addAxis(engines[i], HANDS[i].stepsPerRev, HANDS[i].ratio, HANDS[i].cycleSeconds), i);
+        }
+        ASSERT_TRUE(group.begin());
+        observed = &group;
+    }
+
+    // Steps of `axis` due by now
+    uint64_t stepsDue(const MotionGroup& group, uint8_t axis) const {
+        uint64_t now = group.tickCount();
+        if (now < group.startTick()) return 0;
+        uint64_t elapsed = now - group.startTick();
+        const Hand& hand = HANDS[axis];
+        GearRatio ratio = reduceGearRatio(hand.ratio);
+        // Ticks x steps per cycle / ticks per cycle, in 128 bits to be safe over any run
+        unsigned __int128 steps = (unsigned __int128)elapsed * hand.stepsPerRev * ratio.motorRevs;
+        return (uint64_t)(steps / ((unsigned __int128)hand.cycleSeconds * ratio.dialRevs * STEP_ENGINE_TICKS_PER_SECOND));
+    }
+
+    // loop() held up for a random 1..maxBlockMs between updates (LCD, network, NTP)
+    void runLoaded(MotionGroup& group, uint32_t seconds, uint32_t maxBlockMs, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> block(1, maxBlockMs);
+        uint64_t end = hostMicros64() + (uint64_t)seconds * 1000000ULL;
+        while (hostMicros64() < end) {
+            group.update();
+            delay(block(rng));
+            for (uint8_t i = 0; i < HAND_COUNT; i++) {
+                long due = (long)stepsDue(group, i);
+                // Never ahead; behind only by the pulses held this tick
+                if (group.position(i) > due || group.position(i) < due - 1) {
+                    FAIL() << HANDS[i].name << " hand at " << group.position(i) << " steps, due " << due;
+                }
+            }
+        }
+    }
+
+    void report(const MotionGroup& group, const char* label) {
+        std::cout << "  " << label << ":" << std::endl;
+        for (uint8_t i = 0; i < HAND_COUNT; i++) {
+            MotionAxisStats stats = group.axisStats(i);
+            std::cout << "    " << HANDS[i].name << ": " << stats.pulses << " pulses, " << stats.heldPulses
+                      << " held, at most " << stats.maxHeldTicks << " ticks; late " << minLateTicks[i] << ".."
+                      << maxLateTicks[i] << " ticks" << std::endl;
+        }
+    }
+};
+
+// A simulated day with loop() blocked for up to 600 ms at a time: every pulse of every hand on
+// its exact tick, or held by at most (hands - 1) ticks where pulses coincide
+TEST_F(MotionGroupTest, HandsStayInPhaseUnderLoad) {
+    MotionGroup group(1);
+    build(group);
+    group.start(100);
+    runLoaded(group, 86400, 600, 1);
+    report(group, "One pulse per tick, a day");
+
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        EXPECT_EQ((uint64_t)group.position(i), stepsDue(group, i)) << HANDS[i].name;
+        EXPECT_GE(minLateTicks[i], 0) << HANDS[i].name;
+        EXPECT_LE(maxLateTicks[i], HAND_COUNT - 1) << HANDS[i].name;
+        EXPECT_LE(group.axisStats(i).maxHeldTicks, (uint32_t)(HAND_COUNT - 1));
+    }
+    EXPECT_EQ(group.position(0) / 3200, 2);     // Two turns of the hour hand
+    EXPECT_EQ(group.position(2) / 3200, 1440);  // ...and 1440 of the seconds hand
+    // The hour, minute and seconds hands all step together every 13.5 s: the budget shows
+    EXPECT_GT(group.axisStats(1).heldPulses + group.axisStats(2).heldPulses, 6000u);
+}
+
+// With a budget of two pulses per tick, coincident pulses wait at most one tick
+TEST_F(MotionGroupTest, LargerBudgetHoldsLess) {
+    MotionGroup group(2);
+    build(group);
+    group.start();
+    runLoaded(group, 3600, 300, 2);
+    report(group, "Two pulses per tick, an hour");
+
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        EXPECT_LE(maxLateTicks[i], 1) << HANDS[i].name;
+        EXPECT_EQ((uint64_t)group.position(i), stepsDue(group, i)) << HANDS[i].name;
+    }
+}
+
+// loop() stuck well past the lookahead: late steps go out at the catch-up rate and the hands
+// are back in phase once it runs again
+TEST_F(MotionGroupTest, CatchesUpAfterALongStall) {
+    MotionGroup group(1);
+    build(group);
+    group.start();
+    runLoaded(group, 60, 50, 3);
+    delay(5000); // Blocking network call
+    uint64_t stalledAt = group.tickCount();
+    EXPECT_LT((uint64_t)group.position(2), stepsDue(group, 2)); // The seconds hand ran dry
+
+    for (int i = 0; i < 100; i++) {
+        group.update();
+        delay(20);
+    }
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        EXPECT_EQ((uint64_t)group.position(i), stepsDue(group, i)) << HANDS[i].name;
+    }
+    EXPECT_GT(group.tickCount(), stalledAt);
+}
+
+// Motors running flat out from their own queues share the budget fairly: none is starved
+TEST_F(MotionGroupTest, NoMotorStarves) {
+    MotionGroup group(1);
+    build(group);
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        ASSERT_TRUE(engines[i].queueSteps(20000, 100)); // Every other tick, more than the budget allows
+    }
+    delay(1000);
+    long total = 0;
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        std::cout << "  " << HANDS[i].name << ": " << group.position(i) << " pulses in 1 s" << std::endl;
+        total += group.position(i);
+    }
+    EXPECT_EQ(total, 20000); // One pulse on every tick
+    for (uint8_t i = 0; i < HAND_COUNT; i++) {
+        EXPECT_NEAR(group.position(i), total / HAND_COUNT, 1) << HANDS[i].name;
+        EXPECT_LE(group.axisStats(i).maxHeldTicks, (uint32_t)(HAND_COUNT - 1));
+    }
+}
+
+TEST_F(MotionGroupTest, AxisLimits) {
+    MotionGroup group;
+    StepPulseEngine extra(28, 29);
+    EXPECT_EQ(group.addAxis(extra, 200, GearRatio{0, 1}, 60), -1);
+    build(group);
+    EXPECT_EQ(group.addAxis(extra, 200, GearRatio{1, 1}, 60), -1); // Full
+    EXPECT_EQ(group.axisCount(), HAND_COUNT);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
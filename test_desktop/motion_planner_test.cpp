@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <math.h>
+
+// Pure C++ modules - no Arduino mocks needed
+#include "../src/MotionPlanner.h"
+#include "../src/StepAccumulator.h"
+
+static const uint32_t CYCLE_SECONDS = 43200;
+static const time_t POWER_UP_TIME = 1753577342;
+
+struct CatchUpResult {
+    long steps;
+    uint32_t etaMs;
+    double lastPulseSeconds;
+    double handErrorAtMeeting; // Represented time minus real time at the meeting instant (s)
+    double peakSpeed;
+    double peakAcceleration;
+};
+
+// Mirrors MechanicalClock: shortest path, intercept, whole-step commit, then the profile
+static CatchUpResult runCatchUp(long outageSeconds, uint32_t stepsPerCycle, float maxSpeed, float acceleration) {
+    StepAccumulator hands(stepsPerCycle, CYCLE_SECONDS);
+    hands.anchor(POWER_UP_TIME - outageSeconds); // Hands stopped at power-down
+
+    long timeDiff = outageSeconds;
+    long distance = ((POWER_UP_TIME % CYCLE_SECONDS) - ((POWER_UP_TIME - outageSeconds) % CYCLE_SECONDS));
+    if (distance > (long)CYCLE_SECONDS / 2) distance -= CYCLE_SECONDS;
+    else if (distance <= -(long)CYCLE_SECONDS / 2) distance += CYCLE_SECONDS;
+    hands.shiftSeconds(timeDiff - distance);
+
+    MotionPlanner planner(maxSpeed, acceleration);
+    long behind = hands.stepsDue(POWER_UP_TIME);
+    float rate = (float)stepsPerCycle / CYCLE_SECONDS;
+    time_t meeting = POWER_UP_TIME + (time_t)ceilf(planner.interceptSeconds(behind, rate));
+    long steps = hands.stepsDue(meeting);
+    planner.start(steps);
+    hands.commit(steps);
+
+    CatchUpResult result = {steps, planner.durationMs(), 0.0, 0.0, 0.0, 0.0};
+
+    // Walk the pulse train exactly as the step engine would play it
+    std::vector<double> gaps;
+    uint16_t count;
+    uint32_t gapUs;
+    long pulses = 0;
+    while (planner.nextSegment(count, gapUs)) {
+        for (uint16_t i = 0; i < count; i++) gaps.push_back(gapUs / 1e6);
+        pulses += count;
+    }
+    EXPECT_EQ(pulses, labs(steps));
+
+    double t = 0.0;
+    double previousSpeed = 0.0;
+    for (size_t i = 0; i + 1 < gaps.size(); i++) {
+        double speed = 1.0 / gaps[i];
+        result.peakSpeed = fmax(result.peakSpeed, speed);
+        if (i > 0) {
+            double accel = (speed - previousSpeed) / ((gaps[i - 1] + gaps[i]) / 2.0);
+            result.peakAcceleration = fmax(result.peakAcceleration, fabs(accel));
+        }
+        previousSpeed = speed;
+        t += gaps[i];
+    }
+    result.lastPulseSeconds = t;
+
+    // Remainder is in 1/stepsPerCycle-second units
+    result.handErrorAtMeeting = (double)(hands.seconds() - meeting) + (double)hands.remainder() / stepsPerCycle;
+    return result;
+}
+
+class MotionPlannerTest : public ::testing::TestWithParam<long> {};
+
+// Outages from seconds up to 12 hours: the move stays within limits, lands
+// within one step of real time and does so in (near) minimum time
+TEST_P(MotionPlannerTest, CatchUpFullStep) {
+    const float maxSpeed = 200.0f, acceleration = 400.0f;
+    const uint32_t stepsPerCycle = 2400; // 18 s per full step
+    CatchUpResult r = runCatchUp(GetParam(), stepsPerCycle, maxSpeed, acceleration);
+
+    std::cout << "  Outage " << std::setw(6) << GetParam() << " s: " << std::setw(6) << r.steps
+              << " steps, ETA " << std::setw(6) << r.etaMs << " ms, peak "
+              << std::setprecision(4) << r.peakSpeed << " steps/s" << std::endl;
+
+    EXPECT_LE(r.peakSpeed, maxSpeed * 1.001);
+    if (labs(r.steps) > 2) {
+        EXPECT_LE(r.peakAcceleration, acceleration * 1.10); // Discrete ramp vs continuous limit
+    }
+    EXPECT_NEAR(r.lastPulseSeconds, r.etaMs / 1000.0, 0.002);
+
+    // Hands meet real time within one step
+    EXPECT_LT(fabs(r.handErrorAtMeeting), 18.0);
+
+    // Minimum time: never slower than the continuous trapezoid bound plus the
+    // whole-second rounding of the meeting point
+    double distance = (double)labs(r.steps);
+    double bound = (distance > maxSpeed * maxSpeed / acceleration)
+                       ? distance / maxSpeed + maxSpeed / acceleration
+                       : 2.0 * sqrt(distance / acceleration);
+    EXPECT_LE(r.etaMs / 1000.0, bound + 0.01);
+}
+
+TEST_P(MotionPlannerTest, CatchUpSixteenthStep) {
+    const float maxSpeed = 3200.0f, acceleration = 6400.0f; // Same shaft speed as full-step limits
+    const uint32_t stepsPerCycle = 2400 * 16;
+    CatchUpResult r = runCatchUp(GetParam(), stepsPerCycle, maxSpeed, acceleration);
+
+    EXPECT_LE(r.peakSpeed, maxSpeed * 1.001);
+    EXPECT_LT(fabs(r.handErrorAtMeeting), 1.125);
+    EXPECT_LT(r.etaMs, 10000u); // Any 12-hour outage in under ten seconds
+}
+
+INSTANTIATE_TEST_SUITE_P(Outages, MotionPlannerTest,
+                         ::testing::Values(5L, 40L, 60L, 300L, 1800L, 3600L, 3L * 3600L,
+                                           6L * 3600L, 6L * 3600L + 60L, 9L * 3600L,
+                                           12L * 3600L - 60L, 12L * 3600L));
+
+// The intercept accounts for real time advancing during the move
+TEST(MotionPlannerInterceptTest, MovingTargetNeedsMoreStepsThanStaticDistance) {
+    MotionPlanner planner(200.0f, 400.0f);
+    float rate = 1.0f / 18.0f;
+    float t = planner.interceptSeconds(1200, rate);
+    float staticTime = planner.interceptSeconds(1200, 0.0f);
+    EXPECT_GT(t, staticTime);
+    // Distance covered at the intercept equals the initial gap plus target travel
+    EXPECT_NEAR(1200.0f + rate * t, t * 200.0f - 200.0f * 200.0f / 400.0f, 0.5f);
+
+    // Backward moves meet the target sooner than the static distance would take
+    EXPECT_LT(planner.interceptSeconds(-1200, rate), staticTime);
+}
+
+// Previous behaviour for reference: AccelStepper at 50 steps/s and 2 steps/s^2
+TEST(MotionPlannerInterceptTest, FasterThanLegacyProfile) {
+    MotionPlanner legacy(50.0f, 2.0f);
+    MotionPlanner planner(200.0f, 400.0f);
+    for (long steps : {100L, 1200L}) {
+        float before = legacy.moveSeconds(steps);
+        float after = planner.moveSeconds(steps);
+        std::cout << "  " << steps << " steps: legacy " << before << " s, planner " << after << " s" << std::endl;
+        EXPECT_LT(after, before);
+    }
+}
+
+TEST(MotionPlannerInterceptTest, SingleStepAndCancel) {
+    MotionPlanner planner(200.0f, 400.0f);
+    planner.start(-1);
+    uint16_t count;
+    uint32_t gapUs;
+    ASSERT_TRUE(planner.nextSegment(count, gapUs));
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(gapUs, 5000u);
+    EXPECT_EQ(planner.direction(), -1);
+    EXPECT_FALSE(planner.nextSegment(count, gapUs));
+
+    planner.start(500);
+    planner.cancel();
+    EXPECT_FALSE(planner.isActive());
+}
+
+// Stopping a move part way (homing past the sensor edge) ramps down from the speed reached
+TEST(MotionPlannerInterceptTest, StopRampsDown) {
+    MotionPlanner planner(200.0f, 400.0f);
+    uint16_t count;
+    uint32_t gapUs;
+    for (long done : {300L, 20L}) { // Cruising at 200 steps/s (a 50-gap ramp), and still accelerating
+        planner.start(-1000);
+        std::vector<uint32_t> gaps;
+        while (gaps.size() < (size_t)done && planner.nextSegment(count, gapUs)) gaps.insert(gaps.end(), count, gapUs);
+        uint32_t lastGap = gaps[done - 1]; // Still running out in the step engine
+
+        planner.stop(done);
+        EXPECT_EQ(planner.direction(), -1);
+        long pulses = 0;
+        uint32_t previous = lastGap;
+        while (planner.nextSegment(count, gapUs)) {
+            EXPECT_EQ(count, 1);
+            EXPECT_GE(gapUs, previous); // Slowing down all the way
+            previous = gapUs;
+            pulses += count;
+        }
+        EXPECT_EQ(pulses, (done == 300) ? 50 : 20);
+        EXPECT_NEAR(previous, 1000000.0 * sqrt(2.0 / 400.0), 1000.0); // Down to the first ramp gap
+    }
+
+    planner.start(100);
+    planner.stop(0);
+    EXPECT_FALSE(planner.isActive());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
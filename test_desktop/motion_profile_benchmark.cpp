@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+// Pure C++ module - no Arduino mocks needed
+#include "../src/MotionPlanner.h"
+
+// Limits the clock uses: full-step catch-up, and the same shaft speed in 1/16 steps
+static const float FULL_SPEED = 200.0f, FULL_ACCEL = 400.0f;
+static const float FINE_SPEED = 3200.0f, FINE_ACCEL = 6400.0f;
+
+// The previous generator, for reference: every ramp gap from sqrtf as its pulse is handed out
+class ReferenceProfile {
+private:
+    float _maxSpeed, _acceleration;
+    long _totalSteps, _accelGaps, _decelGaps, _nextPulse;
+
+public:
+    ReferenceProfile(float maxSpeed, float acceleration)
+        : _maxSpeed(maxSpeed), _acceleration(acceleration), _totalSteps(0), _accelGaps(0), _decelGaps(0), _nextPulse(0) {}
+
+    void start(long steps) {
+        _totalSteps = labs(steps);
+        _nextPulse = 0;
+        long gaps = (_totalSteps > 0) ? _totalSteps - 1 : 0;
+        long rampGaps = (long)(_maxSpeed * _maxSpeed / (2.0f * _acceleration));
+        _accelGaps = (rampGaps < gaps / 2) ? rampGaps : gaps / 2;
+        _decelGaps = (rampGaps < gaps - _accelGaps) ? rampGaps : gaps - _accelGaps;
+    }
+
+    uint32_t pulseGapUs(long pulseIndex) const {
+        long gaps = _totalSteps - 1;
+        long n = 0;
+        if (pulseIndex < _accelGaps) n = pulseIndex + 1;
+        else if (pulseIndex >= gaps - _decelGaps) n = gaps - pulseIndex;
+        if (n <= 0) return (uint32_t)(1000000.0f / _maxSpeed + 0.5f);
+        float gapSeconds = sqrtf(2.0f / _acceleration) / (sqrtf((float)n) + sqrtf((float)(n - 1)));
+        return (uint32_t)(gapSeconds * 1000000.0f + 0.5f);
+    }
+
+    bool nextSegment(uint16_t& count, uint32_t& gapUs) {
+        if (_nextPulse >= _totalSteps) return false;
+        long gaps = _totalSteps - 1;
+        long cruiseEnd = gaps - _decelGaps;
+        if (_nextPulse >= _accelGaps && _nextPulse < cruiseEnd) {
+            long run = cruiseEnd - _nextPulse;
+            count = (run > 0xFFFF) ? 0xFFFF : (uint16_t)run;
+            gapUs = pulseGapUs(_nextPulse);
+        } else {
+            count = 1;
+            gapUs = pulseGapUs((_nextPulse < gaps || gaps == 0) ? _nextPulse : gaps - 1);
+        }
+        _nextPulse += count;
+        return true;
+    }
+};
+
+// Exact ramp timing in double precision: the profile both generators approximate
+static double exactGapUs(long n, double acceleration) {
+    return (sqrt(2.0 * n / acceleration) - sqrt(2.0 * (n - 1) / acceleration)) * 1e6;
+}
+
+// Every pulse gap of a move, expanded from the segments
+template <typename Profile>
+static std::vector<uint32_t> expand(Profile& profile, long steps) {
+    std::vector<uint32_t> gaps;
+    profile.start(steps);
+    uint16_t count;
+    uint32_t gapUs;
+    while (profile.nextSegment(count, gapUs)) gaps.insert(gaps.end(), count, gapUs);
+    return gaps;
+}
+
+// --- Profile matches the reference ---
+
+static void compareProfiles(float maxSpeed, float acceleration, long steps) {
+    MotionPlanner planner(maxSpeed, acceleration);
+    ReferenceProfile reference(maxSpeed, acceleration);
+    std::vector<uint32_t> table = expand(planner, steps);
+    std::vector<uint32_t> sqrtGaps = expand(reference, steps);
+    ASSERT_EQ(table.size(), sqrtGaps.size());
+
+    // Each gap within 0.1% (or 1 us) of the reference; the move as a whole within 0.02%
+    double tableTotal = 0.0, referenceTotal = 0.0;
+    for (size_t i = 0; i < table.size(); i++) {
+        double tolerance = fmax(1.0, sqrtGaps[i] * 0.001);
+        ASSERT_NEAR((double)table[i], (double)sqrtGaps[i], tolerance) << "pulse " << i << " of " << steps;
+        if (i + 1 < table.size()) {
+            tableTotal += table[i];
+            referenceTotal += sqrtGaps[i];
+        }
+    }
+    EXPECT_NEAR(tableTotal, referenceTotal, fmax(referenceTotal * 2e-4, 2.0)) << steps << " steps";
+    // durationMs() is the continuous-time estimate; whole-microsecond gaps add a little to it
+    EXPECT_NEAR(tableTotal / 1000.0, planner.durationMs(), fmax(2.0, planner.durationMs() * 0.002)) << steps << " steps";
+}
+
+TEST(MotionProfileTest, FullStepMatchesReference) {
+    for (long steps : {1L, 2L, 3L, 50L, 99L, 100L, 101L, 102L, 500L, 1200L, -1200L, 2400L}) {
+        compareProfiles(FULL_SPEED, FULL_ACCEL, steps);
+    }
+}
+
+// 800-gap ramps: most of each ramp comes from the recurrence
+TEST(MotionProfileTest, SixteenthStepMatchesReference) {
+    for (long steps : {129L, 130L, 131L, 1000L, 1601L, 1602L, 1603L, 5000L, 19200L, -19200L}) {
+        compareProfiles(FINE_SPEED, FINE_ACCEL, steps);
+    }
+}
+
+// Slow legacy limits (625-gap ramps, gaps up to a second) stay within tolerance too
+TEST(MotionProfileTest, SlowLimitsMatchReference) {
+    compareProfiles(50.0f, 2.0f, 1251);
+    compareProfiles(50.0f, 2.0f, 4000);
+}
+
+// Recurrence against the exact ramp all the way up an 800-gap ramp and back down. Gaps are
+// whole microseconds, so the ~160 us gaps at the top carry up to 0.3% of rounding on their own.
+TEST(MotionProfileTest, RecurrenceTracksExactRamp) {
+    MotionPlanner planner(FINE_SPEED, FINE_ACCEL);
+    std::vector<uint32_t> gaps = expand(planner, 1601); // Triangle: 800 gaps up, 800 down
+    double worst = 0.0;
+    for (long n = 1; n <= 800; n++) {
+        double exact = exactGapUs(n, FINE_ACCEL);
+        worst = fmax(worst, fabs(gaps[n - 1] - exact) / exact);
+        worst = fmax(worst, fabs(gaps[1600 - n] - exact) / exact);
+    }
+    std::cout << "  Worst ramp gap error: " << worst * 100.0 << " %" << std::endl;
+    EXPECT_LT(worst, 0.002);
+}
+
+// --- Cost per pulse ---
+
+static const int BENCH_MOVES = 2000;
+
+static uint64_t cycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Hands out whole all-ramp moves (the worst case: one segment per pulse) and times it
+template <typename Profile>
+static void timePulses(Profile& profile, long steps, double& nsPerPulse, double& cyclesPerPulse, uint64_t& sink) {
+    long pulses = 0;
+    auto begin = std::chrono::steady_clock::now();
+    uint64_t cyclesBegin = cycleCounter();
+    for (int move = 0; move < BENCH_MOVES; move++) {
+        profile.start(steps + (move & 1));
+        uint16_t count;
+        uint32_t gapUs;
+        while (profile.nextSegment(count, gapUs)) {
+            sink += gapUs;
+            pulses += count;
+        }
+    }
+    uint64_t cyclesEnd = cycleCounter();
+    auto end = std::chrono::steady_clock::now();
+    nsPerPulse = std::chrono::duration<double, std::nano>(end - begin).count() / pulses;
+    cyclesPerPulse = (double)(cyclesEnd - cyclesBegin) / pulses;
+}
+
+static void benchmark(const char* label, float maxSpeed, float acceleration, long steps) {
+    MotionPlanner planner(maxSpeed, acceleration);
+    ReferenceProfile reference(maxSpeed, acceleration);
+    uint64_t sinkTable = 0, sinkReference = 0;
+    double before = 1e9, after = 1e9, beforeCycles = 1e9, afterCycles = 1e9;
+    for (int run = 0; run < 3; run++) { // Best of a few runs against scheduler noise
+        double ns, cycles;
+        timePulses(reference, steps, ns, cycles, sinkReference);
+        before = fmin(before, ns);
+        beforeCycles = fmin(beforeCycles, cycles);
+        timePulses(planner, steps, ns, cycles, sinkTable);
+        after = fmin(after, ns);
+        afterCycles = fmin(afterCycles, cycles);
+    }
+    std::cout << "  " << label << ": sqrtf " << before << " ns/pulse (" << beforeCycles << " host cycles), table "
+              << after << " ns/pulse (" << afterCycles << " host cycles), " << before / after << "x" << std::endl;
+
+    // Same moves, so nearly the same total time (gaps agree to within a microsecond or so)
+    EXPECT_NEAR((double)sinkTable, (double)sinkReference, sinkReference * 1e-3);
+}
+
+TEST(MotionProfileBenchmark, FullStepRamps) { benchmark("Full step, 100-pulse ramps", FULL_SPEED, FULL_ACCEL, 101); }
+TEST(MotionProfileBenchmark, SixteenthStepRamps) { benchmark("1/16 step, 1600-pulse ramps", FINE_SPEED, FINE_ACCEL, 1601); }
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,367 @@
+// Time-warp simulator for MechanicalClock (see sim/ClockSimulator.h)
+#include "ClockSimulator.h"
+#include "Constants.h"
+#include <EEPROM.h>
+#include <RTC.h>
+#include <math.h>
+#include <algorithm>
+#include "TimeUtils.h"
+
+// Dial seconds per 1/16 motor step (the VirtualStepper's position unit) of the configured clock
+static const double SECONDS_PER_STEP =
+    (double)MechanicalClock::SECONDS_PER_DIAL_CYCLE /
+    ((double)MechanicalClock::STEPS_PER_DIAL_CYCLE * VIRTUAL_STEPPER_MICROSTEPS / microstepMultiplier(CURRENT_MICROSTEP));
+
+// Hands within this of true local time again after a DST change or a power-up count as settled
+static const double SETTLED_SECONDS = SECONDS_PER_STEP + 1.0;
+
+// Where an RTC without its backup supply restarts (2000-01-01, the RA4M1 RTC's reset date)
+static const time_t RTC_RESET_UTC = 946684800;
+
+// A time-keeping step is timed only if no other pulse comes within this of it
+// (catch-up remainders and alignment steps go out in quick runs and have no deadline)
+static const uint64_t PHASE_ISOLATION_US = 500000ULL;
+
+ClockSimulator* ClockSimulator::_observed = nullptr;
+
+ClockSimulator::ClockSimulator(time_t startUtc, int timeZoneOffsetHours, bool useDST)
+    : _startUtc(startUtc), _timeZoneOffsetHours(timeZoneOffsetHours), _useDST(useDST),
+      _startDial(startUtc + utcOffsetSeconds(startUtc, timeZoneOffsetHours, useDST)), _lcd(0x27), _motor(STEP_PIN, DIR_PIN, ENABLE_PIN, MS1_PIN, MS2_PIN, MS3_PIN), _clock(nullptr),
+      _loopPeriodMs(20), _stepScheduling(true), _sweepMode(false), _driverPower(DriverPowerPolicy::defaultConfig()), _ntpIntervalUs(0), _nextNtpUs(0),
+      _bootSync(false), _bootSyncUs(0), _bootSyncPending(false), _bootSyncAtUs(0), _rtcBackup(true), _recoverFromRtc(true),
+      _handsRunning(false),
+      _csv(nullptr), _sampleIntervalUs(0), _nextSampleUs(0), _sampleBurst(0),
+      _outageCount(0), _nextOutage(0), _powered(false), _powerOnUs(0),
+      _trueOffsetSeconds(0), _trueOffsetChange(0), _trueOffsetNext(0), _dstSettling(false), _dstChangeUs(0),
+      _bootSettling(false), _bootUs(0),
+      _timerStartUs(0), _lastPulseUs(0), _phasePending(false), _pendingPulseUs(0), _pendingErrorMs(0.0),
+      _pulseCount(0), _pendingPulseIndex(0), _lastSampleIndex(0), _lastSampleUs(0),
+      _phaseErrorSumMs(0.0), _phaseHistogram(SIMULATOR_PHASE_BINS + 1, 0),
+      _savedBeforeBootMs(0) {
+    // Fresh virtual world: time zero, pins low, EEPROM erased, RTC on true time
+    hostDetachTimers();
+    hostResetTime();
+    hostResetPins();
+    EEPROM.hostErase();
+    RTCTime start(startUtc);
+    RTC.setTime(start);
+    RTC.hostSetDriftPpm(0);
+
+    _trueOffsetSeconds = utcOffsetSeconds(startUtc, timeZoneOffsetHours, useDST);
+    _trueOffsetChange = nextUtcOffsetChange(startUtc, timeZoneOffsetHours, useDST, _trueOffsetNext);
+
+    _motor.reset();
+    _motor.attach();
+    resetStats();
+    _boot();
+}
+
+ClockSimulator::~ClockSimulator() {
+    hostDetachTimers();
+    if (_observed == this) _observed = nullptr;
+    delete _clock;
+}
+
+void ClockSimulator::setRtcDriftPpm(long ppm) {
+    RTC.hostSetDriftPpm(ppm);
+}
+
+void ClockSimulator::setStepScheduling(bool enabled) {
+    _stepScheduling = enabled;
+    _clock->setStepScheduling(enabled);
+}
+
+void ClockSimulator::setSweepMode(bool enabled) {
+    _sweepMode = enabled;
+    _clock->setSweepMode(enabled);
+}
+
+void ClockSimulator::setDriverPowerConfig(const DriverPowerConfig& config) {
+    _driverPower = config;
+    _clock->setDriverPowerConfig(config);
+}
+
+void ClockSimulator::setNtpInterval(uint32_t seconds) {
+    _ntpIntervalUs = (uint64_t)seconds * 1000000ULL;
+    _nextNtpUs = _nextWholeSecondUs(hostMicros64() + _ntpIntervalUs);
+}
+
+// NTP sets the RTC on a true second boundary, as a client that corrects for the round trip does
+uint64_t ClockSimulator::_nextWholeSecondUs(uint64_t us) {
+    return (us + 999999ULL) / 1000000ULL * 1000000ULL;
+}
+
+void ClockSimulator::setBootSync(uint32_t seconds) {
+    _bootSync = true;
+    _bootSyncUs = (uint64_t)seconds * 1000000ULL;
+}
+
+void ClockSimulator::setCsvOutput(FILE* csv, uint32_t sampleSeconds) {
+    _csv = csv;
+    _sampleIntervalUs = (uint64_t)((sampleSeconds > 0) ? sampleSeconds : 1) * 1000000ULL;
+    _nextSampleUs = hostMicros64();
+    if (_csv) {
+        fputs("elapsed_s,true_utc,rtc_utc,hand_error_s,position,steps,reverse_steps,direction_changes,burst,powered\n", _csv);
+    }
+}
+
+bool ClockSimulator::scheduleOutage(uint32_t atSeconds, uint32_t lengthSeconds, bool powerOffIsr) {
+    if (_outageCount >= SIMULATOR_MAX_OUTAGES) return false;
+    Outage& outage = _outages[_outageCount++];
+    outage.startUs = (uint64_t)atSeconds * 1000000ULL;
+    outage.lengthUs = (uint64_t)lengthSeconds * 1000000ULL;
+    outage.powerOffIsr = powerOffIsr;
+    return true;
+}
+
+// Power-up: a new MechanicalClock recovers the hands from EEPROM like the firmware does.
+// The first update either anchors the hands (first ever boot) or starts moving them.
+void ClockSimulator::_boot() {
+    if (_clock) _savedBeforeBootMs += _clock->getCatchUpTimeSavedMs();
+    delete _clock;
+    _motor.powerCycle();
+    _clock = new MechanicalClock(STEP_PIN, DIR_PIN, RTC, _lcd);
+    _clock->setTimeZone(_timeZoneOffsetHours, _useDST);
+    _observed = this;
+    _clock->setPulseObserver(_onPulse);
+    _clock->setStepScheduling(_stepScheduling);
+    _clock->setSweepMode(_sweepMode);
+    _clock->setDriverPowerConfig(_driverPower);
+    _phasePending = false;
+    _lastSampleIndex = 0;
+    _timerStartUs = hostMicros64(); // begin() starts the step timer before anything takes time
+    _clock->begin();
+    _powered = true;
+    _handsRunning = !_bootSync;
+    _bootSyncPending = _bootSync;
+    _bootSyncAtUs = _nextWholeSecondUs(hostMicros64() + _bootSyncUs);
+    if (_handsRunning) _clock->updateCurrentTime();
+}
+
+void ClockSimulator::_powerOff(const Outage& outage) {
+    if (outage.powerOffIsr) {
+        _clock->handlePowerOff();
+    }
+    hostDetachTimers(); // The step timer dies with the supply; the RTC runs on
+    _powered = false;
+    _powerOnUs = hostMicros64() + outage.lengthUs;
+}
+
+// Earliest of: the end of the run, a CSV row, an NTP correction or an outage edge
+uint64_t ClockSimulator::_nextEventUs(uint64_t endUs) const {
+    uint64_t next = endUs;
+    if (_csv && _nextSampleUs < next) next = _nextSampleUs;
+    if (!_powered && _powerOnUs < next) next = _powerOnUs;
+    if (_powered && _ntpIntervalUs > 0 && _nextNtpUs < next) next = _nextNtpUs;
+    if (_powered && _bootSyncPending && _bootSyncAtUs < next) next = _bootSyncAtUs;
+    if (_powered && _nextOutage < _outageCount && _outages[_nextOutage].startUs < next) {
+        next = _outages[_nextOutage].startUs;
+    }
+    return next;
+}
+
+void ClockSimulator::run(uint32_t seconds) {
+    uint64_t endUs = hostMicros64() + (uint64_t)seconds * 1000000ULL;
+
+    while (hostMicros64() < endUs) {
+        uint64_t now = hostMicros64();
+        _updateTrueOffset();
+
+        if (_powered && _nextOutage < _outageCount && now >= _outages[_nextOutage].startUs) {
+            _powerOff(_outages[_nextOutage++]);
+        } else if (!_powered && now >= _powerOnUs) {
+            if (!_rtcBackup) {
+                RTCTime reset(RTC_RESET_UTC);
+                RTC.setTime(reset);
+            }
+            _boot();
+            if (_ntpIntervalUs > 0) _nextNtpUs = _nextWholeSecondUs(now + _ntpIntervalUs);
+            _stats.boots++;
+            _bootSettling = true;
+            _bootUs = now;
+        }
+
+        bool bootSync = _powered && _bootSyncPending && now >= _bootSyncAtUs;
+        if (bootSync || (_powered && _ntpIntervalUs > 0 && now >= _nextNtpUs)) {
+            RTCTime corrected((time_t)trueTime());
+            RTC.setTime(corrected);
+            if (bootSync) {
+                _bootSyncPending = false;
+                _handsRunning = true;
+            } else {
+                _nextNtpUs += _ntpIntervalUs;
+            }
+        }
+        if (_powered && !_handsRunning && _recoverFromRtc && _clock->isRtcTimeValid()) {
+            _handsRunning = true;
+        }
+
+        if (_csv && now >= _nextSampleUs) {
+            _writeSample();
+            _nextSampleUs += _sampleIntervalUs;
+        }
+
+        if (_powered) {
+            // One pass of loop(), then the rest of its period (pulses play out meanwhile)
+            if (_handsRunning) _clock->updateCurrentTime();
+            uint64_t step = (uint64_t)_loopPeriodMs * 1000ULL;
+            uint64_t next = _nextEventUs(endUs);
+            if (next > now && next - now < step) step = next - now;
+            hostAdvanceMicros(step > 0 ? step : 1);
+            _track();
+        } else {
+            uint64_t next = _nextEventUs(endUs);
+            hostAdvanceMicros(next > now ? next - now : 1);
+        }
+    }
+}
+
+// True local time changes offset at the planned instant (DST start or end)
+void ClockSimulator::_updateTrueOffset() {
+    time_t utc = (time_t)trueTime();
+    if (_trueOffsetChange == 0 || utc < _trueOffsetChange) return;
+
+    _trueOffsetSeconds = _trueOffsetNext;
+    _trueOffsetChange = nextUtcOffsetChange(utc, _timeZoneOffsetHours, _useDST, _trueOffsetNext);
+    _stats.dstChanges++;
+    _dstSettling = true;
+    _dstChangeUs = hostMicros64();
+}
+
+void ClockSimulator::_track() {
+    _stats.loopPasses++;
+    _updateTrueOffset();
+    double error = handErrorSeconds();
+
+    // A DST change moves true local time by an hour at once; the hands need a moment
+    // to follow, which is timed separately rather than counted as lag or lead
+    if (_dstSettling) {
+        double settle = (double)(hostMicros64() - _dstChangeUs) / 1e6;
+        if (settle > _stats.worstDstSettleSeconds) _stats.worstDstSettleSeconds = settle;
+        if (fabs(error) < SETTLED_SECONDS) _dstSettling = false;
+    }
+    // Likewise the way back onto true time after a power-up
+    if (_bootSettling) {
+        _stats.lastBootSettleSeconds = (double)(hostMicros64() - _bootUs) / 1e6;
+        if (_stats.lastBootSettleSeconds > _stats.worstBootSettleSeconds) {
+            _stats.worstBootSettleSeconds = _stats.lastBootSettleSeconds;
+        }
+        // A catch-up may take the hands the short way round, to the same dial position 12 hours on
+        if (fabs(remainder(error, (double)SECONDS_IN_12_HOURS)) < SETTLED_SECONDS) _bootSettling = false;
+    }
+    if (!_dstSettling && !_bootSettling) {
+        if (-error > _stats.worstLagSeconds) _stats.worstLagSeconds = -error;
+        if (error > _stats.worstLeadSeconds) _stats.worstLeadSeconds = error;
+    }
+
+    unsigned long burst = _motor.currentBurst();
+    if (burst > _stats.largestBurst) _stats.largestBurst = burst;
+    if (burst > _sampleBurst) _sampleBurst = burst;
+
+    _stats.steps = _motor.steps() - _stepsBase;
+    _stats.reverseSteps = _motor.reverseSteps() - _reverseBase;
+    _stats.directionChanges = _motor.directionChanges() - _changesBase;
+    _stats.missedSteps = _motor.missedSteps() - _missedBase;
+    _stats.offGridSteps = _motor.offGridSteps() - _offGridBase;
+    _stats.catchUpTimeSavedMs = _savedBeforeBootMs + _clock->getCatchUpTimeSavedMs() - _savedBase;
+}
+
+void ClockSimulator::_onPulse(uint32_t tick, int8_t direction) {
+    if (_observed) {
+        _observed->_recordPulse(_observed->_timerStartUs + (uint64_t)tick * STEP_ENGINE_TICK_US, direction);
+    }
+}
+
+// Called from the step ISR right after the STEP edge, so the motor position already includes it.
+// The step was due when true local time reached the time that position shows.
+void ClockSimulator::_recordPulse(uint64_t pulseUs, int8_t direction) {
+    if (_phasePending && pulseUs - _pendingPulseUs >= PHASE_ISOLATION_US) _commitPhaseSample();
+    _phasePending = false;
+    _pulseCount++;
+
+    bool isolated = _lastPulseUs == 0 || pulseUs - _lastPulseUs >= PHASE_ISOLATION_US;
+    _lastPulseUs = pulseUs;
+    if (!isolated || direction < 0 || _dstSettling || _clock->getActiveMicrostepMode() != CURRENT_MICROSTEP) return;
+
+    double pulseLocal = (double)_startUtc + (double)pulseUs / 1e6 + (double)_trueOffsetSeconds;
+    _pendingErrorMs = (pulseLocal - handTime()) * 1000.0;
+    _pendingPulseUs = pulseUs;
+    _pendingPulseIndex = _pulseCount;
+    _phasePending = true;
+}
+
+void ClockSimulator::_commitPhaseSample() {
+    double error = fabs(_pendingErrorMs);
+    size_t bin = (size_t)(error / SIMULATOR_PHASE_BIN_MS);
+    _phaseHistogram[(bin < SIMULATOR_PHASE_BINS) ? bin : SIMULATOR_PHASE_BINS]++;
+
+    _stats.phaseSamples++;
+    _phaseErrorSumMs += _pendingErrorMs;
+    _stats.meanPhaseErrorMs = _phaseErrorSumMs / _stats.phaseSamples;
+    if (error > _stats.worstPhaseErrorMs) _stats.worstPhaseErrorMs = error;
+
+    // Two timed steps with no other pulse between them: the gap is the hand's speed
+    if (_lastSampleIndex != 0 && _pendingPulseIndex == _lastSampleIndex + 1) {
+        double intervalError = fabs((double)(_pendingPulseUs - _lastSampleUs) / 1000.0 - SECONDS_PER_STEP * 1000.0);
+        _stats.intervalSamples++;
+        if (intervalError > _stats.worstIntervalErrorMs) _stats.worstIntervalErrorMs = intervalError;
+    }
+    _lastSampleIndex = _pendingPulseIndex;
+    _lastSampleUs = _pendingPulseUs;
+}
+
+double ClockSimulator::phaseErrorPercentileMs(double p) const {
+    if (_stats.phaseSamples == 0) return 0.0;
+    unsigned long wanted = (unsigned long)ceil(p * _stats.phaseSamples);
+    if (wanted == 0) wanted = 1;
+    unsigned long seen = 0;
+    for (size_t bin = 0; bin < SIMULATOR_PHASE_BINS; bin++) {
+        seen += _phaseHistogram[bin];
+        if (seen >= wanted) return (bin + 1) * SIMULATOR_PHASE_BIN_MS; // Upper edge of the bin
+    }
+    return _stats.worstPhaseErrorMs;
+}
+
+void ClockSimulator::_writeSample() {
+    RTCTime rtcNow;
+    RTC.getTime(rtcNow);
+    fprintf(_csv, "%.3f,%.3f,%lld,%.3f,%ld,%lu,%lu,%lu,%lu,%d\n",
+            elapsedSeconds(), trueTime(), (long long)rtcNow.getUnixTime(), handErrorSeconds(),
+            _motor.position(), _motor.steps(), _motor.reverseSteps(), _motor.directionChanges(),
+            _sampleBurst, _powered ? 1 : 0);
+    _sampleBurst = 0;
+}
+
+double ClockSimulator::elapsedSeconds() const {
+    return (double)hostMicros64() / 1e6;
+}
+
+double ClockSimulator::trueTime() const {
+    return (double)_startUtc + elapsedSeconds();
+}
+
+double ClockSimulator::trueLocalTime() const {
+    return trueTime() + _trueOffsetSeconds;
+}
+
+double ClockSimulator::handTime() const {
+    return (double)_startDial + (double)_motor.position() * SECONDS_PER_STEP;
+}
+
+double ClockSimulator::handErrorSeconds() const {
+    return handTime() - trueLocalTime();
+}
+
+void ClockSimulator::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    std::fill(_phaseHistogram.begin(), _phaseHistogram.end(), 0UL);
+    _phaseErrorSumMs = 0.0;
+    _phasePending = false;
+    _lastSampleIndex = 0;
+    _stepsBase = _motor.steps();
+    _reverseBase = _motor.reverseSteps();
+    _changesBase = _motor.directionChanges();
+    _missedBase = _motor.missedSteps();
+    _offGridBase = _motor.offGridSteps();
+    _savedBase = _savedBeforeBootMs + (_clock ? _clock->getCatchUpTimeSavedMs() : 0);
+}
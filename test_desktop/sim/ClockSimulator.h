@@ -0,0 +1,180 @@
+// Time-warp simulator for MechanicalClock (desktop only).
+//
+// Runs the real MechanicalClock::updateCurrentTime() loop on the virtual time
+// of the host stand-ins, against a VirtualStepper and the host RTC, so weeks of
+// running take seconds. Scripted RTC drift, NTP corrections and power outages
+// exercise the clock; the hand error against true local time is tracked on
+// every loop pass and can be written out as CSV.
+#ifndef CLOCK_SIMULATOR_H
+#define CLOCK_SIMULATOR_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "MechanicalClock.h"
+#include "LCDDisplay.h"
+#include "VirtualStepper.h"
+
+#define SIMULATOR_MAX_OUTAGES 16
+
+// Step phase error histogram: 0.1 ms bins up to 2 s, plus one bin for anything later
+#define SIMULATOR_PHASE_BIN_MS 0.1
+#define SIMULATOR_PHASE_BINS 20000
+
+// Measurements since the last resetStats()
+struct SimulatorStats {
+    double worstLagSeconds;        // Largest amount the hands were behind true time
+    double worstLeadSeconds;       // Largest amount the hands were ahead of true time
+    unsigned long largestBurst;    // Most steps in one burst
+    unsigned long steps;           // Steps that reached the motor
+    unsigned long reverseSteps;
+    unsigned long directionChanges;
+    unsigned long missedSteps;     // Pulses sent with the driver disabled
+    unsigned long offGridSteps;    // Coarse steps that started between coarse positions (lost position)
+    unsigned long catchUpTimeSavedMs; // Catch-up time saved by coarse steps (MechanicalClock's estimate)
+    unsigned long dstChanges;      // DST changes of true local time
+    double worstDstSettleSeconds;  // Longest time from a DST change until the hands showed the new local time
+    unsigned long boots;           // Power-ups after an outage
+    double lastBootSettleSeconds;  // Time from the last power-up until the hands showed true local time...
+    double worstBootSettleSeconds; // ...and the longest of any power-up (time to correct dial)
+    unsigned long phaseSamples;    // Time-keeping steps timed (isolated fine steps only)
+    double meanPhaseErrorMs;       // Mean of (pulse time - instant the step was due), positive = late
+    double worstPhaseErrorMs;      // Largest |pulse time - due instant|
+    unsigned long intervalSamples; // Gaps between consecutive timed steps...
+    double worstIntervalErrorMs;   // ...and the largest |gap - nominal step interval| (velocity ripple)
+    unsigned long loopPasses;      // updateCurrentTime() calls
+};
+
+class ClockSimulator {
+private:
+    struct Outage {
+        uint64_t startUs;
+        uint64_t lengthUs;
+        bool powerOffIsr; // The power-off interrupt runs before the supply dies
+    };
+
+    const time_t _startUtc;   // True time at the start
+    const int _timeZoneOffsetHours;
+    const bool _useDST;
+    const time_t _startDial;  // Local time on the dial at the start
+    LCDDisplay _lcd;
+    VirtualStepper _motor;
+    MechanicalClock* _clock;
+
+    uint32_t _loopPeriodMs;
+    bool _stepScheduling;
+    bool _sweepMode;
+    DriverPowerConfig _driverPower;
+    uint64_t _ntpIntervalUs;  // 0 = the RTC is never corrected
+    uint64_t _nextNtpUs;
+    bool _bootSync;           // NTP first sets the RTC a while after each power-up...
+    uint64_t _bootSyncUs;     // ...this long after it
+    bool _bootSyncPending;
+    uint64_t _bootSyncAtUs;
+    bool _rtcBackup;          // The RTC keeps time through outages
+    bool _recoverFromRtc;     // Hands start from an RTC that kept time (false = wait for NTP)
+    bool _handsRunning;       // The firmware's gate (StateManager): updates reach the clock
+
+    FILE* _csv;
+    uint64_t _sampleIntervalUs;
+    uint64_t _nextSampleUs;
+    unsigned long _sampleBurst; // Largest burst since the previous CSV row
+
+    Outage _outages[SIMULATOR_MAX_OUTAGES];
+    uint8_t _outageCount;
+    uint8_t _nextOutage;
+    bool _powered;
+    uint64_t _powerOnUs;
+
+    long _trueOffsetSeconds;   // UTC offset of true local time
+    time_t _trueOffsetChange;  // Next change of that offset (0 = none)
+    long _trueOffsetNext;
+    bool _dstSettling;         // Local time changed and the hands have not caught up yet
+    uint64_t _dstChangeUs;
+    bool _bootSettling;        // Powered up and the hands have not reached true local time yet
+    uint64_t _bootUs;
+
+    // Step phase: each isolated time-keeping pulse against the instant its step was due
+    uint64_t _timerStartUs;    // Virtual time the step timer started (its tick 0)
+    uint64_t _lastPulseUs;
+    bool _phasePending;        // A pulse waiting to see that no other pulse follows closely
+    uint64_t _pendingPulseUs;
+    double _pendingErrorMs;
+    unsigned long _pulseCount;
+    unsigned long _pendingPulseIndex;
+    unsigned long _lastSampleIndex; // Pulse count of the last timed step (0 = none)
+    uint64_t _lastSampleUs;
+    double _phaseErrorSumMs;
+    std::vector<unsigned long> _phaseHistogram; // |error| in SIMULATOR_PHASE_BIN_MS bins
+
+    static ClockSimulator* _observed; // Simulator whose clock reports its pulses
+    static void _onPulse(uint32_t tick, int8_t direction);
+    void _recordPulse(uint64_t pulseUs, int8_t direction);
+    void _commitPhaseSample();
+
+    SimulatorStats _stats;
+    unsigned long _stepsBase;
+    unsigned long _reverseBase;
+    unsigned long _changesBase;
+    unsigned long _missedBase;
+    unsigned long _offGridBase;
+    unsigned long _savedBeforeBootMs; // Catch-up time saved by clocks that have since lost power
+    unsigned long _savedBase;
+
+    void _boot();
+    void _powerOff(const Outage& outage);
+    void _updateTrueOffset();
+    void _track();
+    void _writeSample();
+    uint64_t _nextEventUs(uint64_t endUs) const;
+    static uint64_t _nextWholeSecondUs(uint64_t us);
+
+public:
+    // The dial shows local time in the given zone (default UTC)
+    explicit ClockSimulator(time_t startUtc, int timeZoneOffsetHours = 0, bool useDST = false);
+    ~ClockSimulator();
+
+    // RTC rate error in parts per million (positive = RTC runs fast)
+    void setRtcDriftPpm(long ppm);
+    // The RTC is set to true time every `seconds` while powered (0 = never)
+    void setNtpInterval(uint32_t seconds);
+    // Virtual time one loop() pass takes
+    void setLoopPeriod(uint32_t ms) { _loopPeriodMs = (ms > 0) ? ms : 1; }
+    // MechanicalClock::setStepScheduling() for this clock and every one booted after it
+    void setStepScheduling(bool enabled);
+    // MechanicalClock::setSweepMode(), likewise
+    void setSweepMode(bool enabled);
+    // MechanicalClock::setDriverPowerConfig(), likewise
+    void setDriverPowerConfig(const DriverPowerConfig& config);
+    // Power-ups after this: NTP sets the RTC `seconds` after each (WiFi join plus NTP exchange).
+    // Until then the hands only run if the RTC kept time, as StateManager runs them.
+    void setBootSync(uint32_t seconds);
+    // false: the RTC has no backup supply and restarts from its reset date at each power-up
+    void setRtcBackup(bool kept) { _rtcBackup = kept; }
+    // false: reference for the previous firmware, where the hands waited for the boot NTP sync
+    void setRecoverFromRtc(bool enabled) { _recoverFromRtc = enabled; }
+    // One CSV row every `sampleSeconds` (nullptr = no CSV)
+    void setCsvOutput(FILE* csv, uint32_t sampleSeconds);
+    // Power fails `atSeconds` after the start for `lengthSeconds`. Outages must be added in order.
+    bool scheduleOutage(uint32_t atSeconds, uint32_t lengthSeconds, bool powerOffIsr);
+
+    // Simulates `seconds` more of wall time
+    void run(uint32_t seconds);
+
+    double trueTime() const;           // True UTC with the fraction of a second
+    double trueLocalTime() const;      // True local time the dial should show
+    double handTime() const;           // Time the motor position shows
+    double handErrorSeconds() const;   // handTime() - trueLocalTime()
+    double elapsedSeconds() const;
+    bool isPowered() const { return _powered; }
+
+    // |phase error| (ms) that fraction `p` (0..1) of the timed steps were within
+    double phaseErrorPercentileMs(double p) const;
+
+    void resetStats();
+    const SimulatorStats& stats() const { return _stats; }
+    MechanicalClock& clock() { return *_clock; }
+    VirtualStepper& motor() { return _motor; }
+};
+
+#endif // CLOCK_SIMULATOR_H
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+// Firmware sources built against the Arduino stand-ins in host/
+#include "StateManager.h"
+#include "MechanicalClock.h"
+#include "Constants.h"
+#include "VirtualStepper.h"
+
+static const time_t TRUE_EPOCH = 1753577342;    // Real UTC at virtual time zero
+static const uint32_t LOOP_PERIOD_MS = 20;      // One pass of loop()
+static const double STEP_SECONDS = 1.125;       // 1/16 stepping through the 12:1 gear train
+static const unsigned long NTP_INTERVAL_MS = 3600000UL;
+
+// --- Simulated world ---
+
+static time_t trueUtc() {
+    return TRUE_EPOCH + (time_t)(hostMicros64() / 1000000ULL);
+}
+
+static VirtualStepper motor(STEP_PIN, DIR_PIN, ENABLE_PIN, MS1_PIN, MS2_PIN, MS3_PIN); // Position in 1/16 steps
+
+// Hand lag is checked from a timer as well, so blocking network calls are covered too
+static bool anchored = false;
+static time_t anchorTime = 0;
+static double worstLagSeconds = 0.0;  // Real time minus the time the hands show
+static double worstLeadSeconds = 0.0;
+
+static void checkHands() {
+    if (!anchored) return;
+    double lagSeconds = (double)(TRUE_EPOCH - anchorTime) + hostMicros64() / 1e6 - (double)motor.position() * STEP_SECONDS;
+    if (lagSeconds > worstLagSeconds) worstLagSeconds = lagSeconds;
+    if (-lagSeconds > worstLeadSeconds) worstLeadSeconds = -lagSeconds;
+}
+
+static void checkHandsTimer(uint32_t elapsedTicks) {
+    (void)elapsedTicks;
+    checkHands();
+}
+
+// Script for the access point: out of range between these two instants
+static uint64_t linkDownAtUs = 0;
+static uint64_t linkUpAtUs = 0;
+
+static void networkScriptTimer(uint32_t elapsedTicks) {
+    (void)elapsedTicks;
+    uint64_t now = hostMicros64();
+    WiFi.hostSetLinkUp(!(now >= linkDownAtUs && now < linkUpAtUs));
+}
+
+static void storeWiFiCredentials() {
+    WiFiCredentials credentials = {};
+    strncpy(credentials.ssid, "HostNetwork", sizeof(credentials.ssid) - 1);
+    strncpy(credentials.password, "password", sizeof(credentials.password) - 1);
+    credentials.isValid = true;
+    EEPROM.put(EEPROM_ADDR_WIFI_CRED_START, credentials);
+    int timeZone = -4;
+    bool useDst = true;
+    EEPROM.put(EEPROM_ADDR_TIME_ZONE_OFFSET, timeZone);
+    EEPROM.put(EEPROM_ADDR_USE_DST_FLAG, useDst);
+}
+
+class ReconnectCycleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        hostResetPins();
+        EEPROM.hostErase();
+        WiFi.hostReset();
+        storeWiFiCredentials();
+
+        RTCTime start(TRUE_EPOCH);
+        RTC.setTime(start);
+
+        anchored = false;
+        worstLagSeconds = 0.0;
+        worstLeadSeconds = 0.0;
+        linkDownAtUs = 0;
+        linkUpAtUs = 0;
+
+        // Realistic module behaviour: begin() blocks, association and NTP take a while
+        WiFi.hostSetJoinTiming(2000, 3000);
+        WiFi.hostSetNtpServer(trueUtc, 40);
+
+        motor.reset();
+        motor.attach();
+        hostAttachTimer(100000, checkHandsTimer);
+        hostAttachTimer(250000, networkScriptTimer);
+    }
+
+    // Boots like setup() and runs loop() until `untilMs` of virtual time
+    void run(NetworkManager& network, StateManager& states, LCDDisplay& lcd, MechanicalClock& clock,
+             uint32_t untilMs) {
+        if (millis() == 0) {
+            lcd.begin();
+            network.begin();
+            clock.setTimeZone(network.getTimeZoneOffset(), network.getUseDST());
+            clock.begin();
+        }
+        while (millis() < untilMs) {
+            states.update();
+            if (!anchored && states.areHandsRunning()) {
+                // The RTC holds valid time from the start: the first update anchors the hands
+                // to it without moving them, before WiFi and NTP are up
+                anchored = true;
+                anchorTime = getCurrentUTC();
+                ASSERT_EQ(motor.position(), 0);
+            }
+            checkHands();
+            delay(LOOP_PERIOD_MS);
+        }
+    }
+};
+
+// Hourly resync with the access point gone: the WiFi join waits 28 s for the
+// link and two NTP replies are lost. The hands must never fall behind by more than
+// a step and the time WiFi.begin() blocks.
+TEST_F(ReconnectCycleTest, HandsKeepTimeThroughReconnectAndResync) {
+    LCDDisplay lcd(0x27);
+    NetworkManager network(AP_SSID, IPAddress(129, 6, 15, 28), 2390, WIFI_CONNECT_TIMEOUT, 3, 5000, 3, 10000,
+                           NTP_INTERVAL_MS, -4, true);
+    MechanicalClock clock(STEP_PIN, DIR_PIN, RTC, lcd);
+    StateManager states(network, lcd, clock, RTC);
+
+    run(network, states, lcd, clock, 60000);
+    ASSERT_TRUE(anchored);
+    ASSERT_EQ(states.getCurrentState(), STATE_RUNNING);
+    unsigned long firstSync = network.getLastNtpSyncTime();
+
+    // Access point disappears well before the hourly sync and returns 28 s into the 30 s rejoin window
+    linkDownAtUs = 1800000000ULL;
+    linkUpAtUs = (firstSync + NTP_INTERVAL_MS + 28000ULL) * 1000ULL;
+    WiFi.hostDropNtpResponses(2);
+
+    run(network, states, lcd, clock, firstSync + NTP_INTERVAL_MS + 600000UL);
+
+    EXPECT_EQ(states.getCurrentState(), STATE_RUNNING);
+    EXPECT_GT(network.getLastNtpSyncTime(), firstSync + NTP_INTERVAL_MS + 28000UL); // Resynced after the outage
+
+    std::cout << "  Hand position: " << motor.position() << ", worst lag " << worstLagSeconds
+              << " s, worst lead " << worstLeadSeconds << " s" << std::endl;
+    // One step, the RTC's whole-second resolution and the time WiFi.begin() itself blocks the caller
+    EXPECT_LT(worstLagSeconds, STEP_SECONDS + 1.0 + 2.0 + 0.1);
+    EXPECT_LT(worstLeadSeconds, 0.1);
+    EXPECT_EQ(motor.reverseSteps(), 0u);
+    EXPECT_GE(motor.position(), (long)(NTP_INTERVAL_MS / 1000 / STEP_SECONDS));
+}
+
+// No network at power-up: the WiFi join times out after 30 s and NTP never answers. The RTC
+// kept time, so the hands run from it from the first pass of loop() rather than from the timeout.
+TEST_F(ReconnectCycleTest, HandsRunFromRtcWithoutNetwork) {
+    LCDDisplay lcd(0x27);
+    NetworkManager network(AP_SSID, IPAddress(129, 6, 15, 28), 2390, WIFI_CONNECT_TIMEOUT, 3, 5000, 3, 10000,
+                           NTP_INTERVAL_MS, -4, true);
+    MechanicalClock clock(STEP_PIN, DIR_PIN, RTC, lcd);
+    StateManager states(network, lcd, clock, RTC);
+    linkUpAtUs = UINT64_MAX; // Down from the start
+    WiFi.hostSetLinkUp(false);
+    WiFi.hostSetNtpServer(nullptr, 0);
+
+    run(network, states, lcd, clock, 1000);
+    ASSERT_TRUE(anchored);
+    EXPECT_EQ(anchorTime, TRUE_EPOCH); // First pass, long before the join gives up
+
+    run(network, states, lcd, clock, 600000);
+    std::cout << "  No network: hand position " << motor.position() << ", worst lag " << worstLagSeconds << " s"
+              << std::endl;
+    EXPECT_GE(motor.position(), (long)(598 / STEP_SECONDS));
+    EXPECT_LT(worstLagSeconds, STEP_SECONDS + 1.0 + 2.0 + 0.1);
+    EXPECT_LT(worstLeadSeconds, 0.1);
+}
+
+// Reference: the same cycle without the idle hook leaves the hands frozen inside
+// the blocking waits, which is what the always-on motion above avoids
+TEST_F(ReconnectCycleTest, BlockingWaitsWithoutIdleHookFreezeHands) {
+    LCDDisplay lcd(0x27);
+    NetworkManager network(AP_SSID, IPAddress(129, 6, 15, 28), 2390, WIFI_CONNECT_TIMEOUT, 3, 5000, 3, 10000,
+                           NTP_INTERVAL_MS, -4, true);
+    MechanicalClock clock(STEP_PIN, DIR_PIN, RTC, lcd);
+    StateManager states(network, lcd, clock, RTC);
+    network.setIdleCallback(nullptr, nullptr);
+
+    run(network, states, lcd, clock, 60000);
+    unsigned long firstSync = network.getLastNtpSyncTime();
+    linkDownAtUs = 1800000000ULL;
+    linkUpAtUs = (firstSync + NTP_INTERVAL_MS + 28000ULL) * 1000ULL;
+    WiFi.hostDropNtpResponses(2);
+
+    run(network, states, lcd, clock, firstSync + NTP_INTERVAL_MS + 600000UL);
+
+    std::cout << "  Without idle hook: worst lag " << worstLagSeconds << " s" << std::endl;
+    EXPECT_GT(worstLagSeconds, 20.0); // Frozen through the 28 s WiFi wait
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+
+// Pure C++ header - no Arduino mocks needed
+#include "../src/StepAccumulator.h"
+
+// Mirrors the constants in MechanicalClock.h
+static const uint32_t BASE_STEPS = 200;
+static const uint32_t GEAR_NUM = 12;
+static const uint32_t GEAR_DEN = 1;
+static const uint32_t CYCLE_SECONDS = 43200;
+
+static const time_t START_TIME = 1753577342; // Arbitrary valid Unix time
+static const long SIMULATED_DAYS = 92;        // About three months
+
+class StepAccumulatorTest : public ::testing::TestWithParam<uint32_t> {
+protected:
+    uint32_t stepsPerCycle() const { return BASE_STEPS * GetParam() * GEAR_NUM; }
+    uint32_t secondsPerCycle() const { return CYCLE_SECONDS * GEAR_DEN; }
+};
+
+// Steps for a whole number of cycles must match the dial exactly
+TEST_P(StepAccumulatorTest, ExactStepsPerCycle) {
+    StepAccumulator acc(stepsPerCycle(), secondsPerCycle());
+    acc.anchor(START_TIME);
+
+    long steps = acc.stepsDue(START_TIME + CYCLE_SECONDS);
+    EXPECT_EQ(steps, (long)stepsPerCycle());
+
+    acc.commit(steps);
+    EXPECT_EQ(acc.seconds(), START_TIME + (time_t)CYCLE_SECONDS);
+    EXPECT_EQ(acc.remainder(), 0u);
+}
+
+// Polling once per second for months: never more than one step late, never
+// ahead, no bursts, and the total step count lands exactly on the dial
+TEST_P(StepAccumulatorTest, NoDriftOverSimulatedMonths) {
+    StepAccumulator acc(stepsPerCycle(), secondsPerCycle());
+    acc.anchor(START_TIME);
+
+    // Largest number of steps that can legitimately fall in one second
+    const long maxStepsPerPoll = (stepsPerCycle() + secondsPerCycle() - 1) / secondsPerCycle();
+
+    long totalSteps = 0;
+    long largestBurst = 0;
+    const time_t endTime = START_TIME + SIMULATED_DAYS * 86400L;
+
+    for (time_t now = START_TIME + 1; now <= endTime; now++) {
+        long steps = acc.stepsDue(now);
+        ASSERT_GE(steps, 0);
+        acc.commit(steps);
+        totalSteps += steps;
+        if (steps > largestBurst) largestBurst = steps;
+
+        // Hands at or behind real time, by less than one step
+        int64_t lagScaled = (int64_t)(now - acc.seconds()) * stepsPerCycle() - acc.remainder();
+        ASSERT_GE(lagScaled, 0);
+        ASSERT_LT(lagScaled, (int64_t)secondsPerCycle());
+    }
+
+    int64_t expectedSteps = (int64_t)SIMULATED_DAYS * 86400L * stepsPerCycle() / secondsPerCycle();
+    EXPECT_EQ(totalSteps, expectedSteps);
+    EXPECT_LE(largestBurst, maxStepsPerPoll);
+
+    std::cout << "  Microstep x" << GetParam() << ": " << totalSteps << " steps in "
+              << SIMULATED_DAYS << " days, largest burst " << largestBurst << std::endl;
+}
+
+// Irregular loop timing (long blocking calls) only changes how many steps are
+// issued per poll, never where the hands end up
+TEST_P(StepAccumulatorTest, IrregularPollingKeepsExactPosition) {
+    StepAccumulator acc(stepsPerCycle(), secondsPerCycle());
+    acc.anchor(START_TIME);
+
+    std::mt19937 rng(GetParam());
+    std::uniform_int_distribution<int> gap(0, 65); // Up to a 65 s stall between polls
+
+    time_t now = START_TIME;
+    long totalSteps = 0;
+    const time_t endTime = START_TIME + 30L * 86400L;
+    while (now < endTime) {
+        now += gap(rng);
+        long steps = acc.stepsDue(now);
+        acc.commit(steps);
+        totalSteps += steps;
+    }
+
+    int64_t expectedSteps = (int64_t)(now - START_TIME) * stepsPerCycle() / secondsPerCycle();
+    EXPECT_EQ(totalSteps, expectedSteps);
+}
+
+// Negative corrections only happen once the hands are a full step ahead
+TEST_P(StepAccumulatorTest, BackwardCorrectionRoundsTowardZero) {
+    StepAccumulator acc(stepsPerCycle(), secondsPerCycle());
+    acc.anchor(START_TIME);
+    acc.commit(acc.stepsDue(START_TIME + 3600));
+
+    long back = acc.stepsDue(START_TIME + 1800);
+    EXPECT_EQ(back, -(long)((int64_t)1800 * stepsPerCycle() / secondsPerCycle()));
+    acc.commit(back);
+    EXPECT_EQ(acc.stepsDue(START_TIME + 1800), 0);
+}
+
+// Integer seconds-per-step (the previous model) drifts in 1/4..1/16 modes
+TEST_P(StepAccumulatorTest, LegacyIntegerModelDriftForComparison) {
+    long legacySecondsPerStep = 18 / (long)GetParam();
+    long legacyStepsPerDay = 86400L / legacySecondsPerStep;
+    long exactStepsPerDay = (long)((int64_t)86400L * stepsPerCycle() / secondsPerCycle());
+    std::cout << "  Microstep x" << GetParam() << ": legacy model " << legacyStepsPerDay
+              << " steps/day vs exact " << exactStepsPerDay << std::endl;
+    if (18 % GetParam() == 0) {
+        EXPECT_EQ(legacyStepsPerDay, exactStepsPerDay);
+    } else {
+        EXPECT_NE(legacyStepsPerDay, exactStepsPerDay);
+    }
+}
+
+// Ratio change (microstep switch) keeps the represented time
+TEST_P(StepAccumulatorTest, RatioChangeKeepsRepresentedTime) {
+    StepAccumulator acc(BASE_STEPS * GEAR_NUM, secondsPerCycle());
+    acc.anchor(START_TIME);
+    acc.commit(acc.stepsDue(START_TIME + 100));
+    time_t before = acc.seconds();
+
+    acc.setRatio(stepsPerCycle(), secondsPerCycle());
+    EXPECT_EQ(acc.seconds(), before);
+    EXPECT_GE(acc.stepsDue(START_TIME + 100), 0);
+}
+
+// More than 2^31 s between the hands and now (RTC reset, first sync): the gap is range-checked
+// before it is narrowed, so it takes the 64-bit path rather than wrapping
+TEST_P(StepAccumulatorTest, GapBeyond32BitsOfSeconds) {
+    const int64_t gap = (1LL << 31) + 86400;
+    int64_t expected = gap * stepsPerCycle() / secondsPerCycle();
+
+    StepAccumulator acc(stepsPerCycle(), secondsPerCycle());
+    acc.anchor(START_TIME);
+    EXPECT_EQ(acc.stepsDue((time_t)(START_TIME + gap)), (long)expected);
+    acc.anchor((time_t)(START_TIME + gap));
+    EXPECT_EQ(acc.stepsDue(START_TIME), -(long)expected);
+
+    FixedStepAccumulator<BASE_STEPS * 16 * GEAR_NUM, CYCLE_SECONDS * GEAR_DEN> fixed;
+    int64_t fixedExpected = gap * (BASE_STEPS * 16 * GEAR_NUM) / (CYCLE_SECONDS * GEAR_DEN);
+    fixed.anchor(START_TIME);
+    EXPECT_EQ(fixed.stepsDue((time_t)(START_TIME + gap)), (long)fixedExpected);
+    fixed.anchor((time_t)(START_TIME + gap));
+    EXPECT_EQ(fixed.stepsDue(START_TIME), -(long)fixedExpected);
+}
+
+INSTANTIATE_TEST_SUITE_P(MicrostepModes, StepAccumulatorTest,
+                         ::testing::Values(1u, 2u, 4u, 8u, 16u));
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
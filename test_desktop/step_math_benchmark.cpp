@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc()
+#endif
+
+// Pure C++ header - no Arduino mocks needed
+#include "../src/StepAccumulator.h"
+
+// Mirrors the constants in MechanicalClock.h
+static const uint32_t BASE_STEPS = 200;
+static const uint32_t GEAR_NUM = 12;
+static const uint32_t CYCLE_SECONDS = 43200;
+
+static const time_t START_TIME = 1753577342;
+static const long BENCH_CALLS = 20000000; // updateCurrentTime() calls per measurement
+
+// The hot path of MechanicalClock::updateCurrentTime() in steady running:
+// how many steps are due, and commit them when there are any
+template <typename Hands>
+static double nsPerCall(Hands& hands, const std::vector<time_t>& polls, long& stepSink) {
+    hands.anchor(START_TIME);
+    long steps = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (long i = 0; i < BENCH_CALLS; i++) {
+        long due = hands.stepsDue(polls[i & (polls.size() - 1)] + (time_t)(i >> 4));
+        if (due != 0) {
+            hands.commit(due);
+            steps += due;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    stepSink += steps;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / BENCH_CALLS;
+}
+
+// loop() polls many times per second, so most calls find nothing due
+static std::vector<time_t> makePolls() {
+    std::vector<time_t> polls(4096);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> jitter(0, 3);
+    for (size_t i = 0; i < polls.size(); i++) polls[i] = START_TIME + jitter(rng);
+    return polls;
+}
+
+template <uint32_t Microsteps>
+static void benchmarkMode(const char* label) {
+    std::vector<time_t> polls = makePolls();
+    long runtimeSteps = 0, fixedSteps = 0;
+
+    StepAccumulator runtime(BASE_STEPS * Microsteps * GEAR_NUM, CYCLE_SECONDS);
+    FixedStepAccumulator<BASE_STEPS * Microsteps * GEAR_NUM, CYCLE_SECONDS> fixed;
+
+    // Warm up, then keep the best of a few runs to reduce scheduler noise
+    double before = 1e9, after = 1e9;
+    for (int run = 0; run < 3; run++) {
+        before = std::min(before, nsPerCall(runtime, polls, runtimeSteps));
+        after = std::min(after, nsPerCall(fixed, polls, fixedSteps));
+    }
+
+    std::cout << "  " << label << ": runtime ratio " << before << " ns/call, compile-time ratio "
+              << after << " ns/call (" << before / after << "x)" << std::endl;
+
+    // Both models must have issued the same steps
+    EXPECT_EQ(runtimeSteps, fixedSteps);
+    EXPECT_EQ(runtime.seconds(), fixed.seconds());
+}
+
+TEST(StepMathBenchmark, FullStep) { benchmarkMode<1>("Full step"); }
+TEST(StepMathBenchmark, SixteenthStep) { benchmarkMode<16>("1/16 step"); }
+
+static const uint32_t TICKS_PER_SECOND = 20000; // Step timer ticks (StepPulseEngine.h)
+static const long LOOKAHEAD_SECONDS = 2;        // STEP_LOOKAHEAD_SECONDS
+
+// The hand position model before the 32-bit hot path: every operation in 64 bits. Kept as the
+// reference the narrow paths must match, and counts its 64-bit divisions: the host divides
+// 64 bits in hardware, the Cortex-M4 only 32 (the rest is a library call, __aeabi_ldivmod).
+class WideStepAccumulator {
+    uint32_t _stepsPerCycle, _secondsPerCycle;
+    time_t _seconds = 0;
+    uint32_t _remainder = 0;
+
+    static int64_t divide(int64_t value, int64_t divisor) {
+        divisions++;
+        return value / divisor;
+    }
+
+public:
+    static long divisions;
+
+    WideStepAccumulator(uint32_t stepsPerCycle, uint32_t secondsPerCycle)
+        : _stepsPerCycle(stepsPerCycle), _secondsPerCycle(secondsPerCycle) {}
+
+    void anchor(time_t time, uint32_t remainder = 0) {
+        _seconds = time;
+        _remainder = remainder % _stepsPerCycle;
+    }
+
+    long stepsDue(time_t now) const {
+        int64_t scaled = (int64_t)(now - _seconds) * _stepsPerCycle - _remainder;
+        if (scaled >= 0 && scaled < (int64_t)_secondsPerCycle) return 0;
+        if (scaled >= 0) return (long)divide(scaled, _secondsPerCycle);
+        return -(long)divide(-scaled, _secondsPerCycle);
+    }
+
+    void commit(long steps) {
+        int64_t fraction = (int64_t)_remainder + (int64_t)steps * (_secondsPerCycle % _stepsPerCycle);
+        int64_t carry = divide(fraction, _stepsPerCycle); // Quotient and remainder in one call
+        if (fraction - carry * _stepsPerCycle < 0) carry--;
+        _seconds += (time_t)((int64_t)steps * (_secondsPerCycle / _stepsPerCycle) + carry);
+        _remainder = (uint32_t)(fraction - carry * _stepsPerCycle);
+    }
+
+    uint32_t fractionIn(uint32_t unitsPerSecond) const {
+        return (uint32_t)divide((int64_t)_remainder * unitsPerSecond, _stepsPerCycle);
+    }
+
+    time_t seconds() const { return _seconds; }
+    uint32_t remainder() const { return _remainder; }
+};
+
+long WideStepAccumulator::divisions = 0;
+
+// Ticks from the current RTC second to the next step, as MechanicalClock::_nextStepTick()
+// works them out: 64-bit before...
+static int64_t nextStepTicks(const WideStepAccumulator& hands, time_t now) {
+    WideStepAccumulator next = hands;
+    next.commit(1);
+    return (int64_t)(next.seconds() - now) * TICKS_PER_SECOND + next.fractionIn(TICKS_PER_SECOND);
+}
+
+// ...and 32-bit now
+template <typename Hands>
+static int64_t nextStepTicks(const Hands& hands, time_t now) {
+    Hands next = hands;
+    next.commit(1);
+    long seconds = (long)(next.seconds() - now);
+    if (seconds > 86400L) seconds = 86400L;
+    if (seconds < -86400L) seconds = -86400L;
+    return (int32_t)seconds * (int32_t)TICKS_PER_SECOND + (int32_t)next.fractionIn(TICKS_PER_SECOND);
+}
+
+// Time stamp counter where there is one, else nanoseconds
+static uint64_t cycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Everything one MechanicalClock::updateCurrentTime() does with the hand position while
+// keeping time: is the waiting step still right, the hand error sample (hands less the steps
+// not issued yet) and the ticks to the next step; a step goes out when one is due
+template <typename Hands>
+static double cyclesPerUpdate(Hands& hands, const std::vector<time_t>& polls, int64_t& sink) {
+    hands.anchor(START_TIME);
+    int64_t total = 0;
+    uint64_t begin = cycleCount();
+    for (long i = 0; i < BENCH_CALLS; i++) {
+        time_t now = polls[i & (polls.size() - 1)] + (time_t)(i >> 4);
+        long due = hands.stepsDue(now);
+        total += hands.stepsDue(now + LOOKAHEAD_SECONDS);
+
+        Hands issued = hands;
+        issued.commit(-(long)(i & 1));
+        total += (long)(issued.seconds() - now) * 1000L + (long)issued.fractionIn(1000);
+        total += nextStepTicks(hands, now);
+
+        if (due != 0) hands.commit(due);
+    }
+    uint64_t end = cycleCount();
+    sink += total + hands.seconds();
+    return (double)(end - begin) / BENCH_CALLS;
+}
+
+// The runtime-ratio model (gear ratio from EEPROM) had a 64-bit division on every update
+TEST(StepMathBenchmark, UpdateHotPath) {
+    const uint32_t stepsPerCycle = BASE_STEPS * 16 * GEAR_NUM;
+    std::vector<time_t> polls = makePolls();
+    int64_t wideSink = 0, runtimeSink = 0, fixedSink = 0;
+
+    WideStepAccumulator wide(stepsPerCycle, CYCLE_SECONDS);
+    StepAccumulator runtime(stepsPerCycle, CYCLE_SECONDS);
+    FixedStepAccumulator<BASE_STEPS * 16 * GEAR_NUM, CYCLE_SECONDS> fixed;
+
+    double wideCycles = 1e12, runtimeCycles = 1e12, fixedCycles = 1e12;
+    WideStepAccumulator::divisions = 0;
+    for (int run = 0; run < 3; run++) {
+        wideCycles = std::min(wideCycles, cyclesPerUpdate(wide, polls, wideSink));
+        runtimeCycles = std::min(runtimeCycles, cyclesPerUpdate(runtime, polls, runtimeSink));
+        fixedCycles = std::min(fixedCycles, cyclesPerUpdate(fixed, polls, fixedSink));
+    }
+
+    std::cout << "  1/16 step update: 64-bit " << wideCycles << " cycles/call with "
+              << (double)WideStepAccumulator::divisions / (3.0 * BENCH_CALLS) << " 64-bit divisions; 32-bit "
+              << runtimeCycles << " cycles/call (runtime ratio), " << fixedCycles
+              << " cycles/call (compile-time ratio) with none" << std::endl;
+
+    // Same steps, same error samples, same due ticks
+    EXPECT_EQ(runtimeSink, wideSink);
+    EXPECT_EQ(fixedSink, wideSink);
+}
+
+// The compile-time model must step exactly like the runtime one, forwards and backwards
+template <uint32_t Microsteps>
+static void compareModels() {
+    const uint32_t stepsPerCycle = BASE_STEPS * Microsteps * GEAR_NUM;
+    StepAccumulator runtime(stepsPerCycle, CYCLE_SECONDS);
+    FixedStepAccumulator<BASE_STEPS * Microsteps * GEAR_NUM, CYCLE_SECONDS> fixed;
+    runtime.anchor(START_TIME);
+    fixed.anchor(START_TIME);
+
+    std::mt19937 rng(Microsteps);
+    std::uniform_int_distribution<int> move(-400, 900);
+    time_t now = START_TIME;
+    for (int i = 0; i < 200000; i++) {
+        now += move(rng);
+        long due = runtime.stepsDue(now);
+        ASSERT_EQ(due, fixed.stepsDue(now));
+        runtime.commit(due);
+        fixed.commit(due);
+
+        // Same represented time (remainders are in different units after reduction)
+        ASSERT_EQ(runtime.seconds(), fixed.seconds());
+        ASSERT_EQ((uint64_t)runtime.remainder() * fixed.stepsPerCycle(),
+                  (uint64_t)fixed.remainder() * stepsPerCycle);
+    }
+
+    // Far-away targets (first sync after an RTC reset) take the 64-bit path
+    time_t farAway = START_TIME - 20L * 365 * 86400;
+    EXPECT_EQ(runtime.stepsDue(farAway), fixed.stepsDue(farAway));
+}
+
+// The 32-bit paths against the 64-bit reference, either side of where they hand over to
+// 64 bits: an odd gear train (127 motor turns per 40 dial turns) keeps the narrow window small
+TEST(StepMathModelTest, NarrowPathsMatchWideModel) {
+    const uint32_t stepsPerCycle = BASE_STEPS * 16 * 127, secondsPerCycle = CYCLE_SECONDS * 40;
+    StepAccumulator narrow(stepsPerCycle, secondsPerCycle);
+    WideStepAccumulator wide(stepsPerCycle, secondsPerCycle);
+    narrow.anchor(START_TIME, 12345);
+    wide.anchor(START_TIME, 12345);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<long> seconds(-20000, 20000);
+    std::uniform_int_distribution<long> steps(-5000000, 5000000);
+    for (int i = 0; i < 200000; i++) {
+        time_t now = narrow.seconds() + seconds(rng);
+        ASSERT_EQ(narrow.stepsDue(now), wide.stepsDue(now));
+        long move = (i % 3 == 0) ? steps(rng) : steps(rng) / 1000;
+        narrow.commit(move);
+        wide.commit(move);
+        ASSERT_EQ(narrow.seconds(), wide.seconds());
+        ASSERT_EQ(narrow.remainder(), wide.remainder());
+        ASSERT_EQ(narrow.fractionIn(TICKS_PER_SECOND), wide.fractionIn(TICKS_PER_SECOND));
+        ASSERT_EQ(narrow.fractionIn(1000), wide.fractionIn(1000));
+    }
+}
+
+TEST(StepMathModelTest, FullStepMatchesRuntimeModel) { compareModels<1>(); }
+TEST(StepMathModelTest, HalfStepMatchesRuntimeModel) { compareModels<2>(); }
+TEST(StepMathModelTest, EighthStepMatchesRuntimeModel) { compareModels<8>(); }
+TEST(StepMathModelTest, SixteenthStepMatchesRuntimeModel) { compareModels<16>(); }
+
+TEST(StepMathModelTest, RatioReducedAtCompileTime) {
+    typedef FixedStepAccumulator<2400, 43200> FullStep;
+    typedef FixedStepAccumulator<38400, 43200> SixteenthStep;
+    static_assert(FullStep::STEPS_PER_CYCLE == 1 && FullStep::SECONDS_PER_CYCLE == 18, "18 s per step");
+    static_assert(SixteenthStep::STEPS_PER_CYCLE == 8 && SixteenthStep::SECONDS_PER_CYCLE == 9, "1.125 s per step");
+    SUCCEED();
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
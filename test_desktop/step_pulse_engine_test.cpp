@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+// Firmware source built against the Arduino stand-ins in host/
+#include "StepPulseEngine.h"
+
+static const uint8_t TEST_STEP_PIN = 8;
+static const uint8_t TEST_DIR_PIN = 7;
+
+static std::vector<uint32_t> pulseTicks;
+static std::vector<int8_t> pulseDirections;
+
+static void recordPulse(uint32_t tick, int8_t direction) {
+    pulseTicks.push_back(tick);
+    pulseDirections.push_back(direction);
+}
+
+struct JitterStats {
+    long minUs;
+    long maxUs;
+    double meanAbsErrorUs;
+};
+
+// Deviation of each pulse interval from the commanded interval
+static JitterStats measureJitter(const std::vector<uint64_t>& pulseTimesUs, long expectedIntervalUs) {
+    JitterStats stats = {0, 0, 0.0};
+    if (pulseTimesUs.size() < 2) return stats;
+    stats.minUs = 0x7FFFFFFF;
+    stats.maxUs = -0x7FFFFFFF;
+    double sumAbs = 0.0;
+    for (size_t i = 1; i < pulseTimesUs.size(); i++) {
+        long error = (long)(pulseTimesUs[i] - pulseTimesUs[i - 1]) - expectedIntervalUs;
+        stats.minUs = std::min(stats.minUs, error);
+        stats.maxUs = std::max(stats.maxUs, error);
+        sumAbs += (error < 0) ? -error : error;
+    }
+    stats.meanAbsErrorUs = sumAbs / (pulseTimesUs.size() - 1);
+    return stats;
+}
+
+class StepPulseEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostDetachTimers();
+        hostResetTime();
+        hostResetPins();
+        pulseTicks.clear();
+        pulseDirections.clear();
+    }
+};
+
+// The timer keeps pulsing at the commanded rate while loop() is stuck in
+// long blocking calls; a loop-polled generator cannot
+TEST_F(StepPulseEngineTest, PulseTimingIndependentOfLoopLatency) {
+    StepPulseEngine engine(TEST_STEP_PIN, TEST_DIR_PIN);
+    ASSERT_TRUE(engine.begin());
+    engine.setPulseObserver(recordPulse);
+
+    const long intervalUs = 20000;
+    const long steps = 500;
+    ASSERT_TRUE(engine.queueSteps(steps, intervalUs));
+
+    // Simulated loop(): mostly quick passes, sometimes an LCD write or a 2 s NTP wait
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> roll(0, 99);
+    std::vector<uint64_t> loopPolledPulses;
+    uint64_t nextLoopPolledPulse = hostMicros64();
+    long loopPolledEmitted = 0;
+
+    while (engine.isRunning()) {
+        int r = roll(rng);
+        uint32_t blockUs = (r < 80) ? 300 : (r < 97) ? 8000 : 2000000;
+        delayMicroseconds(blockUs);
+
+        // Reference: AccelStepper-style run() can emit at most one pulse per loop pass
+        if (loopPolledEmitted < steps && hostMicros64() >= nextLoopPolledPulse) {
+            loopPolledPulses.push_back(hostMicros64());
+            nextLoopPolledPulse = hostMicros64() + intervalUs;
+            loopPolledEmitted++;
+        }
+    }
+
+    ASSERT_EQ((long)pulseTicks.size(), steps);
+    EXPECT_EQ(engine.currentPosition(), steps);
+    EXPECT_EQ(engine.distanceToGo(), 0);
+
+    std::vector<uint64_t> timerPulses;
+    for (uint32_t tick : pulseTicks) timerPulses.push_back((uint64_t)tick * STEP_ENGINE_TICK_US);
+
+    JitterStats timerJitter = measureJitter(timerPulses, intervalUs);
+    JitterStats loopJitter = measureJitter(loopPolledPulses, intervalUs);
+
+    std::cout << "  Timer engine jitter: min " << timerJitter.minUs << " us, max " << timerJitter.maxUs
+              << " us, mean |err| " << timerJitter.meanAbsErrorUs << " us" << std::endl;
+    std::cout << "  Loop-polled jitter:  min " << loopJitter.minUs << " us, max " << loopJitter.maxUs
+              << " us, mean |err| " << loopJitter.meanAbsErrorUs << " us" << std::endl;
+
+    EXPECT_EQ(timerJitter.minUs, 0);
+    EXPECT_EQ(timerJitter.maxUs, 0);
+    EXPECT_GT(loopJitter.maxUs, 1000000); // The 2 s stalls show up directly in the reference
+}
+
+// Bulk tick delivery (used by the host timer) must match tick-by-tick ISR calls
+TEST_F(StepPulseEngineTest, BulkAdvanceMatchesPerTickIsr) {
+    StepPulseEngine perTick(TEST_STEP_PIN, TEST_DIR_PIN);
+    StepPulseEngine bulk(TEST_STEP_PIN, TEST_DIR_PIN);
+
+    const long moves[] = {7, -3, 12, 1, -1, 40};
+    const uint32_t intervals[] = {1000, 150, 5000, 100, 18000, 333};
+    for (int i = 0; i < 6; i++) {
+        ASSERT_TRUE(perTick.queueSteps(moves[i], intervals[i]));
+        ASSERT_TRUE(bulk.queueSteps(moves[i], intervals[i]));
+    }
+
+    std::vector<uint32_t> perTickPulses;
+    perTick.setPulseObserver(recordPulse);
+    for (uint32_t t = 0; t < 20000; t++) perTick.onTimerTick();
+    perTickPulses.swap(pulseTicks);
+    pulseDirections.clear();
+
+    bulk.setPulseObserver(recordPulse);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> chunk(1, 900);
+    uint32_t delivered = 0;
+    while (delivered < 20000) {
+        uint32_t n = std::min<uint32_t>(chunk(rng), 20000 - delivered);
+        bulk.advanceTicks(n);
+        delivered += n;
+    }
+
+    EXPECT_EQ(perTickPulses, pulseTicks);
+    EXPECT_EQ(perTick.currentPosition(), bulk.currentPosition());
+    EXPECT_EQ(bulk.tickCount(), 20000u);
+    EXPECT_EQ(bulk.currentPosition(), 56);
+}
+
+// Reversal waits one tick after switching DIR before the next STEP edge
+TEST_F(StepPulseEngineTest, DirectionChangeHasSetupTick) {
+    StepPulseEngine engine(TEST_STEP_PIN, TEST_DIR_PIN);
+    ASSERT_TRUE(engine.begin());
+    engine.setPulseObserver(recordPulse);
+
+    ASSERT_TRUE(engine.queueSteps(1, 100));
+    ASSERT_TRUE(engine.queueSteps(-1, 100));
+    hostAdvanceMicros(10000);
+
+    ASSERT_EQ(pulseTicks.size(), 2u);
+    EXPECT_EQ(pulseDirections[0], 1);
+    EXPECT_EQ(pulseDirections[1], -1);
+    EXPECT_EQ(pulseTicks[1] - pulseTicks[0], 100u / STEP_ENGINE_TICK_US + 1);
+    EXPECT_EQ(hostPinLevel(TEST_DIR_PIN), LOW);
+    EXPECT_EQ(hostPinLevel(TEST_STEP_PIN), LOW);
+    EXPECT_EQ(engine.currentPosition(), 0);
+}
+
+// A full queue rejects the command instead of dropping steps silently
+TEST_F(StepPulseEngineTest, FullQueueRejectsCommand) {
+    StepPulseEngine engine(TEST_STEP_PIN, TEST_DIR_PIN);
+    for (int i = 0; i < STEP_ENGINE_QUEUE_SIZE - 1; i++) {
+        ASSERT_TRUE(engine.queueSteps(1, 20000));
+    }
+    EXPECT_EQ(engine.freeSlots(), 0);
+    EXPECT_FALSE(engine.queueSteps(5, 20000));
+    EXPECT_EQ(engine.distanceToGo(), STEP_ENGINE_QUEUE_SIZE - 1);
+
+    engine.clear();
+    EXPECT_EQ(engine.distanceToGo(), 0);
+    EXPECT_FALSE(engine.isRunning());
+}
+
+// A timed command waits for its tick however the ticks arrive; one whose tick has passed goes at once
+TEST_F(StepPulseEngineTest, TimedCommandFiresOnItsTick) {
+    StepPulseEngine engine(TEST_STEP_PIN, TEST_DIR_PIN);
+    ASSERT_TRUE(engine.begin());
+    engine.setPulseObserver(recordPulse);
+
+    ASSERT_TRUE(engine.queueStepsAt(1, 12345, 20000));
+    hostAdvanceMicros(300000); // Ticks delivered in one bulk call, well short of the deadline
+    EXPECT_TRUE(engine.isWaiting());
+    EXPECT_TRUE(pulseTicks.empty());
+    hostAdvanceMicros(1000000);
+    ASSERT_EQ(pulseTicks.size(), 1u);
+    EXPECT_EQ(pulseTicks[0], 12345u);
+    EXPECT_FALSE(engine.isWaiting());
+
+    uint32_t late = engine.tickCount() - 10;
+    ASSERT_TRUE(engine.queueStepsAt(1, late, 20000));
+    hostAdvanceMicros(1000);
+    ASSERT_EQ(pulseTicks.size(), 2u);
+    EXPECT_EQ(pulseTicks[1], late + 11);
+
+    // A waiting step can be taken back before it fires
+    ASSERT_TRUE(engine.queueStepsAt(1, engine.tickCount() + 1000, 20000));
+    hostAdvanceMicros(10000);
+    engine.clear();
+    EXPECT_FALSE(engine.isWaiting());
+    hostAdvanceMicros(100000);
+    EXPECT_EQ(pulseTicks.size(), 2u);
+    EXPECT_EQ(engine.currentPosition(), 2);
+}
+
+// With the driver disabled pulses wait instead of going out into a dead driver; once it is
+// enabled they start after the warm-up and keep their spacing
+TEST_F(StepPulseEngineTest, DisabledOutputHoldsPulses) {
+    StepPulseEngine engine(TEST_STEP_PIN, TEST_DIR_PIN);
+    ASSERT_TRUE(engine.begin());
+    engine.setPulseObserver(recordPulse);
+    engine.setOutputEnabled(false);
+
+    uint32_t deadline = engine.tickCount() + 100;
+    ASSERT_TRUE(engine.queueStepsAt(3, deadline, 1000));
+    hostAdvanceMicros(50000); // Well past the deadline
+    EXPECT_TRUE(pulseTicks.empty());
+    EXPECT_TRUE(engine.isWaiting());
+
+    uint32_t enabledAt = engine.tickCount();
+    engine.setOutputEnabled(true, 40);
+    hostAdvanceMicros(100000);
+    ASSERT_EQ(pulseTicks.size(), 3u);
+    EXPECT_EQ(pulseTicks[0], enabledAt + 40);
+    EXPECT_EQ(pulseTicks[1], pulseTicks[0] + 20);
+    EXPECT_EQ(pulseTicks[2], pulseTicks[1] + 20);
+    EXPECT_EQ(engine.currentPosition(), 3);
+
+    // Enabled long ago: no warm-up left, even once the tick counter has moved on a long way
+    ASSERT_TRUE(engine.queueSteps(1, 1000));
+    hostAdvanceMicros(1000);
+    ASSERT_EQ(pulseTicks.size(), 4u);
+    EXPECT_LE(pulseTicks[3], engine.tickCount());
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+// Firmware source built against the Arduino stand-ins in host/
+#include "TimeUtils.h"
+
+static const time_t DST_START_2025 = 1741503600; // Sun 9 Mar 2025, 2:00 EST (07:00 UTC)
+static const time_t DST_END_2025 = 1762063200;   // Sun 2 Nov 2025, 2:00 EDT (06:00 UTC)
+static const int EST = -5;
+
+// The changes are where the rest of TimeUtils puts them
+TEST(TimeUtilsTest, UsTransitions) {
+    long offset = 0;
+    EXPECT_EQ(nextUtcOffsetChange(DST_START_2025 - 1, EST, true, offset), DST_START_2025);
+    EXPECT_EQ(offset, -4 * 3600L);
+    EXPECT_EQ(nextUtcOffsetChange(DST_END_2025 - 1, EST, true, offset), DST_END_2025);
+    EXPECT_EQ(offset, -5 * 3600L);
+}
+
+// UTC -> local -> UTC is exact on every minute around both changes, apart from the second
+// pass through the hour repeated in November, which reads back as the first
+TEST(TimeUtilsTest, LocalToUtcRoundTripsAcrossBothTransitions) {
+    const time_t changes[] = {DST_START_2025, DST_END_2025};
+    for (time_t change : changes) {
+        for (time_t utc = change - 3 * 3600; utc <= change + 3 * 3600; utc += 60) {
+            RTCTime local = convertUTCToLocal(utc, EST, true);
+            time_t back = convertLocalToUTC(local, EST, true);
+            if (change == DST_END_2025 && utc >= DST_END_2025 && utc < DST_END_2025 + 3600) {
+                EXPECT_EQ(back, utc - 3600) << "repeated hour, UTC " << utc;
+            } else {
+                EXPECT_EQ(back, utc) << "UTC " << utc;
+            }
+        }
+    }
+}
+
+// Local wall times either side of the changes, and the ones the changes skip or repeat
+TEST(TimeUtilsTest, LocalToUtcAtTheChanges) {
+    RTCTime beforeStart(9, Month::MARCH, 2025, 1, 59, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_INACTIVE);
+    EXPECT_EQ(convertLocalToUTC(beforeStart, EST, true), DST_START_2025 - 60);
+    RTCTime afterStart(9, Month::MARCH, 2025, 3, 0, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_ACTIVE);
+    EXPECT_EQ(convertLocalToUTC(afterStart, EST, true), DST_START_2025);
+    RTCTime skipped(9, Month::MARCH, 2025, 2, 30, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_INACTIVE);
+    EXPECT_EQ(convertLocalToUTC(skipped, EST, true), DST_START_2025 + 1800); // Read as standard time
+
+    RTCTime repeated(2, Month::NOVEMBER, 2025, 1, 30, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_ACTIVE);
+    EXPECT_EQ(convertLocalToUTC(repeated, EST, true), DST_END_2025 - 1800); // The daylight pass
+    RTCTime afterEnd(2, Month::NOVEMBER, 2025, 2, 0, 0, DayOfWeek::SUNDAY, SaveLight::SAVING_TIME_INACTIVE);
+    EXPECT_EQ(convertLocalToUTC(afterEnd, EST, true), DST_END_2025 + 3600);
+
+    // Summer and winter, and with DST off
+    RTCTime summer(1, Month::JULY, 2025, 12, 0, 0, DayOfWeek::TUESDAY, SaveLight::SAVING_TIME_ACTIVE);
+    EXPECT_EQ(convertLocalToUTC(summer, EST, true), convertLocalToUTC(summer, EST, false) - 3600);
+    RTCTime winter(1, Month::JANUARY, 2025, 12, 0, 0, DayOfWeek::WEDNESDAY, SaveLight::SAVING_TIME_INACTIVE);
+    EXPECT_EQ(convertLocalToUTC(winter, EST, true), convertLocalToUTC(winter, EST, false));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}